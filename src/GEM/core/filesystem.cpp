@@ -58,6 +58,9 @@ namespace file {
             case Mode::READ_APPEND:
                 modeStr = binary ? "a+b" : "a+";
                 break;
+            case Mode::UPDATE:
+                modeStr = binary ? "r+b" : "r+";
+                break;
             default:
                 log_error("Invalid file mode: %i", mode);
                 break;
@@ -82,9 +85,9 @@ namespace file {
         return ftell((FILE*)f->handle);
     }
 
-    GAPI bool set_offset(const File* f, i32 offset, Offset offsetMethod) {
+    GAPI bool set_offset(const File* f, i64 offset, Offset offsetMethod) {
         if (!f->handle) return false;
-        i32 status = fseek((FILE*)f->handle, offset, (i32)offsetMethod);
+        i32 status = _fseeki64((FILE*)f->handle, offset, (i32)offsetMethod);
         return status == 0; // 0 upon success, nonzero value otherwise
     }
 
@@ -176,6 +179,57 @@ namespace file {
         return false;
     }
 
+    // -------------------------------------------
+    // Mapping
+    // -------------------------------------------
+
+    GAPI bool map(const char* path, Mapping* outMapping) {
+        memory::zero(outMapping, sizeof(Mapping));
+        outMapping->path = path;
+
+        HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            log_error("Failed to open file for mapping: '%s'", path);
+            return false;
+        }
+
+        LARGE_INTEGER size = {};
+        GetFileSizeEx(fileHandle, &size);
+        outMapping->fileHandle = fileHandle;
+        outMapping->size = (u64)size.QuadPart;
+
+        // NOTE: Windows refuses to map empty files, they're treated as a valid mapping without any data
+        if (outMapping->size == 0) return true;
+
+        outMapping->mapHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (outMapping->mapHandle) {
+            outMapping->data = (const u8*)MapViewOfFile(outMapping->mapHandle, FILE_MAP_READ, 0, 0, 0);
+        }
+
+        if (!outMapping->data) {
+            log_error("Failed to map file: '%s'", path);
+            file::unmap(outMapping);
+            return false;
+        }
+
+        return true;
+    }
+
+    GAPI bool unmap(Mapping* m) {
+        if (!m->fileHandle) return false;
+
+        if (m->data) UnmapViewOfFile(m->data);
+        if (m->mapHandle) CloseHandle(m->mapHandle);
+        CloseHandle(m->fileHandle);
+
+        m->fileHandle = NULL;
+        m->mapHandle = NULL;
+        m->data = NULL;
+        m->size = 0;
+
+        return true;
+    }
+
     // -------------------------------------------
     // Utility
     // -------------------------------------------
@@ -225,6 +279,15 @@ namespace file {
         return true;
     }
 
+    GAPI bool replace(const char* fromPath, const char* toPath) {
+        if (!MoveFileExA(fromPath, toPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            log_error("Failed to replace file: '%s' with '%s'", toPath, fromPath);
+            return false;
+        }
+
+        return true;
+    }
+
     GAPI bool copy(const char* srcPath, const char* destPath) {
         // Check if source exists
         struct stat statSrc;
@@ -13,10 +13,21 @@ namespace file {
         bool isBinary;
     };
 
+    // Read-only view of an entire file
+    struct Mapping {
+        const char* path;
+        void* fileHandle;
+        void* mapHandle;
+
+        const u8* data;
+        u64 size;
+    };
+
     enum class Mode {
         READ        = 1 << 0,
         WRITE       = 1 << 1,
         APPEND      = 1 << 2,
+        UPDATE      = 1 << 3, // Read & write an existing file without truncating it
         READ_WRITE  = READ | WRITE,
         READ_APPEND = READ | APPEND,
     };
@@ -43,7 +54,7 @@ namespace file {
     GAPI bool close(File* f);
 
     GAPI i32  get_offset(const File* f);
-    GAPI bool set_offset(const File* f, i32 offset, Offset offsetMethod);
+    GAPI bool set_offset(const File* f, i64 offset, Offset offsetMethod);
     GAPI bool set_offset_start(const File* f);
     GAPI bool set_offset_end(const File* f);
 
@@ -55,10 +66,15 @@ namespace file {
     GAPI bool write_line(const File* f, const char* text);
     GAPI bool write(const File* f, const void* buffer, i32 bufferSize, i32* outBytesWritten = NULL);
 
+    // Mapping
+    GAPI bool map(const char* path, Mapping* outMapping);
+    GAPI bool unmap(Mapping* m);
+
     // Utility
     GAPI bool remove(const char* path);
     GAPI bool rename(const char* fromPath, const char* toPath);
     GAPI bool move(const char* fromPath, const char* toPath);
+    GAPI bool replace(const char* fromPath, const char* toPath); // Atomic, readers see either the old or the new file
 
     GAPI bool copy(const char* srcPath, const char* destPath);
 }
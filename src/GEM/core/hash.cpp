@@ -0,0 +1,112 @@
+#include "pch.hpp"
+
+#include "GEM/core/hash.hpp"
+
+namespace hash {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Reference: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    static const u64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static const u64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static const u64 PRIME64_3 = 0x165667B19E3779F9ULL;
+    static const u64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static const u64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    static inline u64 rotl64(u64 value, u32 amount) {
+        return (value << amount) | (value >> (64 - amount));
+    }
+
+    // NOTE: memcpy keeps unaligned reads well-defined, compilers turn it into a single load
+    static inline u64 read64(const u8* ptr) {
+        u64 value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    static inline u32 read32(const u8* ptr) {
+        u32 value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    static inline u64 xxh64_round(u64 acc, u64 input) {
+        acc += input * PRIME64_2;
+        acc = rotl64(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    static inline u64 xxh64_merge_round(u64 acc, u64 value) {
+        acc ^= xxh64_round(0, value);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    GAPI u64 xxh64(const void* data, u64 size, u64 seed) {
+        const u8* ptr = (const u8*)data;
+        const u8* end = ptr + size;
+        u64 h64;
+
+        // Consume 32-byte stripes across four independent lanes
+        if (size >= 32) {
+            const u8* limit = end - 32;
+            u64 v1 = seed + PRIME64_1 + PRIME64_2;
+            u64 v2 = seed + PRIME64_2;
+            u64 v3 = seed;
+            u64 v4 = seed - PRIME64_1;
+
+            do {
+                v1 = xxh64_round(v1, read64(ptr));      ptr += 8;
+                v2 = xxh64_round(v2, read64(ptr));      ptr += 8;
+                v3 = xxh64_round(v3, read64(ptr));      ptr += 8;
+                v4 = xxh64_round(v4, read64(ptr));      ptr += 8;
+            } while (ptr <= limit);
+
+            h64 = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+            h64 = xxh64_merge_round(h64, v1);
+            h64 = xxh64_merge_round(h64, v2);
+            h64 = xxh64_merge_round(h64, v3);
+            h64 = xxh64_merge_round(h64, v4);
+        } else {
+            h64 = seed + PRIME64_5;
+        }
+
+        h64 += size;
+
+        // Consume the remaining tail
+        while (ptr + 8 <= end) {
+            h64 ^= xxh64_round(0, read64(ptr));
+            h64 = rotl64(h64, 27) * PRIME64_1 + PRIME64_4;
+            ptr += 8;
+        }
+
+        if (ptr + 4 <= end) {
+            h64 ^= (u64)read32(ptr) * PRIME64_1;
+            h64 = rotl64(h64, 23) * PRIME64_2 + PRIME64_3;
+            ptr += 4;
+        }
+
+        while (ptr < end) {
+            h64 ^= (*ptr) * PRIME64_5;
+            h64 = rotl64(h64, 11) * PRIME64_1;
+            ptr++;
+        }
+
+        // Final avalanche
+        h64 ^= h64 >> 33;
+        h64 *= PRIME64_2;
+        h64 ^= h64 >> 29;
+        h64 *= PRIME64_3;
+        h64 ^= h64 >> 32;
+
+        return h64;
+    }
+
+    GAPI u64 string(const char* str, u64 seed) {
+        return xxh64(str, strlen(str), seed);
+    }
+}
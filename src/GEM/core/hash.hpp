@@ -0,0 +1,13 @@
+#pragma once
+
+#include "pch.hpp"
+
+namespace hash {
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    // Non-cryptographic 64-bit hash (XXH64), suitable for change detection & lookup tables
+    GAPI u64 xxh64(const void* data, u64 size, u64 seed = 0);
+    GAPI u64 string(const char* str, u64 seed = 0);
+}
@@ -24,4 +24,12 @@ namespace memory {
     GAPI void* set(void* block, u64 size, i32 value) {
         return memset(block, value, size);
     }
+
+    GAPI void* reserve(u64 size) {
+        return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+    }
+
+    GAPI bool commit(void* block, u64 size) {
+        return VirtualAlloc(block, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+    }
 }
@@ -8,4 +8,8 @@ namespace memory {
     GAPI void* zero(void* block, u64 size);
     GAPI void* copy(void* dest, const void* src, u64 size);
     GAPI void* set(void* block, u64 size, i32 value);
+
+    // Address space only, pages have to be committed before they're touched. Released with 'free'.
+    GAPI void* reserve(u64 size);
+    GAPI bool  commit(void* block, u64 size);
 }
@@ -0,0 +1,291 @@
+#include "pch.hpp"
+
+#include "GEM/core/thread.hpp"
+
+#include "GEM/logger.hpp"
+#include "GEM/core/memory.hpp"
+
+namespace thread {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    struct ThreadStart {
+        ThreadFunc func;
+        void* data;
+    };
+
+    struct DispatchChunk {
+        RangeFunc func;
+        void* data;
+        u32 begin;
+        u32 end;
+    };
+
+    static DWORD WINAPI thread_entry(LPVOID param) {
+        ThreadStart start = *(ThreadStart*)param;
+        memory::free(param);
+
+        return (DWORD)start.func(start.data);
+    }
+
+    // NOTE: Expects the pool lock to be held
+    static bool pool_try_pop(Pool* pool, Job* outJob) {
+        if (pool->jobCount == 0) return false;
+
+        *outJob = pool->jobs[pool->jobHead];
+        pool->jobHead = (pool->jobHead + 1) % pool->jobCapacity;
+        pool->jobCount--;
+
+        return true;
+    }
+
+    static void pool_run_job(Pool* pool, const Job* job) {
+        job->func(job->data);
+        if (!job->counter || atomic_decrement(&job->counter->pending) != 0) return;
+
+        // Waiters check the counter under the lock, so taking it here means the wake can't land
+        // between a waiter's check and its sleep
+        AcquireSRWLockExclusive(&pool->lock);
+        ReleaseSRWLockExclusive(&pool->lock);
+        WakeAllConditionVariable(&pool->jobDone);
+    }
+
+    static u32 pool_worker_entry(void* data) {
+        Pool* pool = (Pool*)data;
+
+        for (;;) {
+            AcquireSRWLockExclusive(&pool->lock);
+            while (pool->jobCount == 0 && pool->isRunning) {
+                SleepConditionVariableSRW(&pool->hasWork, &pool->lock, INFINITE, 0);
+            }
+
+            Job job = {};
+            bool hasJob = pool_try_pop(pool, &job);
+            ReleaseSRWLockExclusive(&pool->lock);
+
+            if (hasJob) {
+                pool_run_job(pool, &job);
+            } else if (!pool->isRunning) {
+                break;
+            }
+        }
+
+        return 0;
+    }
+
+    static void dispatch_chunk_entry(void* data) {
+        DispatchChunk* chunk = (DispatchChunk*)data;
+        for (u32 i = chunk->begin; i < chunk->end; i++) {
+            chunk->func(chunk->data, i);
+        }
+    }
+
+    // -------------------------------------------
+    // Thread
+    // -------------------------------------------
+
+    GAPI Thread create(ThreadFunc func, void* data) {
+        Thread output = {};
+
+        ThreadStart* start = (ThreadStart*)memory::alloc(sizeof(ThreadStart));
+        start->func = func;
+        start->data = data;
+
+        DWORD id = 0;
+        output.handle = CreateThread(NULL, 0, thread_entry, start, 0, &id);
+        output.id = (u32)id;
+
+        if (!output.handle) {
+            log_error("Failed to create thread!");
+            memory::free(start);
+        }
+
+        return output;
+    }
+
+    GAPI bool join(Thread* t) {
+        if (!t->handle) return false;
+
+        WaitForSingleObject(t->handle, INFINITE);
+        CloseHandle(t->handle);
+        t->handle = NULL;
+
+        return true;
+    }
+
+    GAPI u32 get_core_count() {
+        SYSTEM_INFO info = {};
+        GetSystemInfo(&info);
+        return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+    }
+
+    GAPI void yield() {
+        SwitchToThread();
+    }
+
+    // -------------------------------------------
+    // Mutex
+    // -------------------------------------------
+
+    GAPI void mutex_init(Mutex* m) {
+        InitializeSRWLock(&m->lock);
+    }
+
+    GAPI void mutex_lock(Mutex* m) {
+        AcquireSRWLockExclusive(&m->lock);
+    }
+
+    GAPI void mutex_unlock(Mutex* m) {
+        ReleaseSRWLockExclusive(&m->lock);
+    }
+
+    // -------------------------------------------
+    // Atomic
+    // -------------------------------------------
+
+    GAPI i64 atomic_increment(volatile i64* value) {
+        return InterlockedIncrement64((volatile LONG64*)value);
+    }
+
+    GAPI i64 atomic_decrement(volatile i64* value) {
+        return InterlockedDecrement64((volatile LONG64*)value);
+    }
+
+    GAPI i64 atomic_add(volatile i64* value, i64 amount) {
+        return InterlockedExchangeAdd64((volatile LONG64*)value, amount) + amount;
+    }
+
+    GAPI i64 atomic_exchange(volatile i64* value, i64 replacement) {
+        return InterlockedExchange64((volatile LONG64*)value, replacement);
+    }
+
+    GAPI i64 atomic_compare_exchange(volatile i64* value, i64 expected, i64 replacement) {
+        return InterlockedCompareExchange64((volatile LONG64*)value, replacement, expected);
+    }
+
+    // -------------------------------------------
+    // Pool
+    // -------------------------------------------
+
+    GAPI bool pool_create(Pool* pool, u32 workerCount) {
+        memory::zero(pool, sizeof(Pool));
+
+        InitializeSRWLock(&pool->lock);
+        InitializeConditionVariable(&pool->hasWork);
+        InitializeConditionVariable(&pool->jobDone);
+        pool->isRunning = true;
+
+        pool->jobCapacity = 64;
+        pool->jobs = (Job*)memory::alloc(sizeof(Job) * pool->jobCapacity);
+
+        if (workerCount > 0) {
+            pool->workers = (Thread*)memory::alloc(sizeof(Thread) * workerCount);
+
+            for (u32 i = 0; i < workerCount; i++) {
+                pool->workers[i] = thread::create(pool_worker_entry, pool);
+                if (!pool->workers[i].handle) {
+                    pool_destroy(pool);
+                    return false;
+                }
+
+                pool->workerCount++;
+            }
+        }
+
+        return true;
+    }
+
+    GAPI void pool_destroy(Pool* pool) {
+        AcquireSRWLockExclusive(&pool->lock);
+        pool->isRunning = false;
+        ReleaseSRWLockExclusive(&pool->lock);
+        WakeAllConditionVariable(&pool->hasWork);
+
+        for (u32 i = 0; i < pool->workerCount; i++) {
+            thread::join(&pool->workers[i]);
+        }
+
+        if (pool->workers) memory::free(pool->workers);
+        if (pool->jobs) memory::free(pool->jobs);
+
+        pool->workers = NULL;
+        pool->workerCount = 0;
+        pool->jobs = NULL;
+    }
+
+    GAPI void pool_submit(Pool* pool, JobFunc func, void* data, Counter* counter) {
+        if (counter) atomic_increment(&counter->pending);
+
+        AcquireSRWLockExclusive(&pool->lock);
+
+        // Grow the queue, unwrapping the ring buffer into the new block
+        if (pool->jobCount == pool->jobCapacity) {
+            u32 newCapacity = pool->jobCapacity * 2;
+            Job* newJobs = (Job*)memory::alloc(sizeof(Job) * newCapacity);
+
+            for (u32 i = 0; i < pool->jobCount; i++) {
+                newJobs[i] = pool->jobs[(pool->jobHead + i) % pool->jobCapacity];
+            }
+
+            memory::free(pool->jobs);
+            pool->jobs = newJobs;
+            pool->jobCapacity = newCapacity;
+            pool->jobHead = 0;
+        }
+
+        u32 tail = (pool->jobHead + pool->jobCount) % pool->jobCapacity;
+        pool->jobs[tail] = { func, data, counter };
+        pool->jobCount++;
+
+        ReleaseSRWLockExclusive(&pool->lock);
+        WakeConditionVariable(&pool->hasWork);
+        WakeAllConditionVariable(&pool->jobDone);
+    }
+
+    GAPI void pool_wait(Pool* pool, Counter* counter) {
+        // Help out with queued jobs while the counter drains, and sleep once there are none left to take
+        for (;;) {
+            Job job = {};
+            bool hasJob = false;
+
+            AcquireSRWLockExclusive(&pool->lock);
+            while (counter->pending > 0) {
+                hasJob = pool_try_pop(pool, &job);
+                if (hasJob) break;
+
+                SleepConditionVariableSRW(&pool->jobDone, &pool->lock, INFINITE, 0);
+            }
+            ReleaseSRWLockExclusive(&pool->lock);
+
+            if (!hasJob) break;
+            pool_run_job(pool, &job);
+        }
+    }
+
+    GAPI void pool_dispatch(Pool* pool, u32 count, RangeFunc func, void* data) {
+        if (count == 0) return;
+
+        // Split the range into a few chunks per thread, so uneven work still balances out
+        u32 chunkCount = (pool->workerCount + 1) * 4;
+        if (chunkCount > count) chunkCount = count;
+        u32 chunkSize = (count + chunkCount - 1) / chunkCount;
+
+        DispatchChunk* chunks = (DispatchChunk*)memory::alloc(sizeof(DispatchChunk) * chunkCount);
+        Counter counter = {};
+
+        for (u32 i = 0; i < chunkCount; i++) {
+            DispatchChunk* chunk = &chunks[i];
+            chunk->func = func;
+            chunk->data = data;
+            chunk->begin = i * chunkSize;
+            chunk->end = (chunk->begin + chunkSize < count) ? chunk->begin + chunkSize : count;
+            if (chunk->begin >= chunk->end) continue;
+
+            pool_submit(pool, dispatch_chunk_entry, chunk, &counter);
+        }
+
+        pool_wait(pool, &counter);
+        memory::free(chunks);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "pch.hpp"
+
+namespace thread {
+    // -------------------------------------------
+    // Data Types
+    // -------------------------------------------
+
+    typedef u32 (*ThreadFunc)(void* data);
+    typedef void (*JobFunc)(void* data);
+    typedef void (*RangeFunc)(void* data, u32 index);
+
+    struct Thread {
+        void* handle;
+        u32 id;
+    };
+
+    struct Mutex {
+        SRWLOCK lock;
+    };
+
+    // Number of jobs still in flight for a particular batch of work
+    struct Counter {
+        volatile i64 pending;
+    };
+
+    struct Job {
+        JobFunc func;
+        void* data;
+        Counter* counter;
+    };
+
+    struct Pool {
+        Thread* workers;
+        u32 workerCount;
+
+        // Ring buffer of queued jobs, grows when full
+        Job* jobs;
+        u32 jobCapacity;
+        u32 jobHead;
+        u32 jobCount;
+
+        SRWLOCK lock;
+        CONDITION_VARIABLE hasWork;
+        CONDITION_VARIABLE jobDone; // Signalled when a counter drains or a job is queued
+        volatile bool isRunning;
+    };
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    // -- Thread
+    GAPI Thread create(ThreadFunc func, void* data);
+    GAPI bool   join(Thread* t);
+    GAPI u32    get_core_count();
+    GAPI void   yield();
+
+    // -- Mutex
+    GAPI void mutex_init(Mutex* m);
+    GAPI void mutex_lock(Mutex* m);
+    GAPI void mutex_unlock(Mutex* m);
+
+    // -- Atomic
+    GAPI i64 atomic_increment(volatile i64* value);
+    GAPI i64 atomic_decrement(volatile i64* value);
+    GAPI i64 atomic_add(volatile i64* value, i64 amount);
+    GAPI i64 atomic_exchange(volatile i64* value, i64 replacement);                 // Returns the previous value
+    GAPI i64 atomic_compare_exchange(volatile i64* value, i64 expected, i64 replacement); // Returns the previous value, only swapped if it was 'expected'
+
+    // -- Pool
+    // NOTE: A pool with zero workers is valid, every job is then run by the thread calling 'pool_wait'.
+    GAPI bool pool_create(Pool* pool, u32 workerCount);
+    GAPI void pool_destroy(Pool* pool);
+
+    GAPI void pool_submit(Pool* pool, JobFunc func, void* data, Counter* counter);
+    GAPI void pool_wait(Pool* pool, Counter* counter); // runs queued jobs while waiting, safe to call from inside a job
+    GAPI void pool_dispatch(Pool* pool, u32 count, RangeFunc func, void* data);
+}
@@ -0,0 +1,31 @@
+#include "pch.hpp"
+
+#include "GEM/core/timer.hpp"
+
+namespace timer {
+    GAPI u64 get_ticks() {
+        LARGE_INTEGER tick;
+        QueryPerformanceCounter(&tick);
+        return (u64)tick.QuadPart;
+    }
+
+    GAPI u64 get_frequency() {
+        // NOTE: The frequency is fixed at system boot, so it only has to be queried once
+        static u64 frequency = 0;
+        if (frequency == 0) {
+            LARGE_INTEGER value;
+            QueryPerformanceFrequency(&value);
+            frequency = (u64)value.QuadPart;
+        }
+
+        return frequency;
+    }
+
+    GAPI f64 ticks_to_seconds(u64 ticks) {
+        return (f64)ticks / (f64)get_frequency();
+    }
+
+    GAPI f64 ticks_to_ms(u64 ticks) {
+        return ticks_to_seconds(ticks) * 1000.0;
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "pch.hpp"
+
+namespace timer {
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    // High resolution tick counter, independent of any window or platform state
+    GAPI u64 get_ticks();
+    GAPI u64 get_frequency();
+
+    GAPI f64 ticks_to_seconds(u64 ticks);
+    GAPI f64 ticks_to_ms(u64 ticks);
+}
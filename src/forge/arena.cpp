@@ -0,0 +1,61 @@
+#include "pch.hpp"
+
+#include "forge/arena.hpp"
+
+#include "GEM/core/memory.hpp"
+
+namespace arena {
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool init(Arena* arena, u64 reserveSize) {
+        *arena = {};
+
+        arena->data = (u8*)memory::reserve(reserveSize);
+        if (!arena->data) return false;
+
+        arena->reserved = reserveSize;
+        return true;
+    }
+
+    void release(Arena* arena) {
+        if (arena->data) memory::free(arena->data);
+        *arena = {};
+    }
+
+    void clear(Arena* arena) {
+        arena->used = 0;
+    }
+
+    void* push(Arena* arena, u64 size, u64 alignment) {
+        if (!arena->data) return NULL;
+
+        u64 offset = (arena->used + alignment - 1) & ~(alignment - 1);
+        u64 required = offset + size;
+        if (required > arena->reserved) return NULL;
+
+        if (required > arena->committed) {
+            u64 committed = (required + COMMIT_SIZE - 1) / COMMIT_SIZE * COMMIT_SIZE;
+            if (committed > arena->reserved) committed = arena->reserved;
+
+            if (!memory::commit(arena->data + arena->committed, committed - arena->committed)) return NULL;
+            arena->committed = committed;
+        }
+
+        arena->used = required;
+
+        void* block = arena->data + offset;
+        memory::zero(block, size);
+        return block;
+    }
+
+    const char* push_string(Arena* arena, const char* str, u64 length) {
+        char* copy = (char*)push(arena, length + 1, 1);
+        if (!copy) return NULL;
+
+        memory::copy(copy, str, length);
+        copy[length] = '\0';
+        return copy;
+    }
+}
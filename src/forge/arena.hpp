@@ -0,0 +1,31 @@
+#pragma once
+
+#include "pch.hpp"
+
+// -------------------------------------------
+// Arena Allocation
+// -------------------------------------------
+// Bump allocator inside a reserved address range. Pages are committed as the arena grows, so anything pushed
+// stays where it is and consecutive pushes of the same type form one contiguous array.
+
+namespace arena {
+    const u64 DEFAULT_RESERVE_SIZE = 256 * 1024 * 1024;
+    const u64 COMMIT_SIZE = 64 * 1024;
+
+    struct Arena {
+        u8* data;
+        u64 used;
+        u64 committed;
+        u64 reserved;
+    };
+
+    bool init(Arena* arena, u64 reserveSize = DEFAULT_RESERVE_SIZE);
+    void release(Arena* arena);
+    void clear(Arena* arena); // Committed pages are kept for the next use
+
+    // Returns zeroed memory, NULL once the reserved range is used up
+    void* push(Arena* arena, u64 size, u64 alignment = 8);
+
+    // Copies 'length' characters & a terminator
+    const char* push_string(Arena* arena, const char* str, u64 length);
+}
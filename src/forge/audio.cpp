@@ -0,0 +1,424 @@
+#include "pch.hpp"
+
+#include "forge/audio.hpp"
+
+#include "GEM/core/memory.hpp"
+#include "GEM/math/mathf.hpp"
+
+#include <emmintrin.h>
+
+namespace audio {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Reference: Microsoft WAVE format (incl. WAVE_FORMAT_EXTENSIBLE), IMA ADPCM (Microsoft block layout)
+    static const u16 WAVE_FORMAT_PCM = 0x0001;
+    static const u16 WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+    static const u16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    // NOTE: The fractional source position is rounded to one of PHASE_COUNT precomputed filters,
+    //       which keeps arbitrary rate pairs (e.g. 44100 -> 48000) cheap. The rounding error stays around -75 dB.
+    static const u32 PHASE_COUNT = 1024;
+    static const u32 BASE_TAP_COUNT = 32;  // When upsampling, downsampling widens the filter by the rate ratio
+    static const u32 MAX_TAP_COUNT = 256;
+    static const f64 CUTOFF = 0.95;        // Relative to the lower of the two Nyquist frequencies
+    static const f64 KAISER_BETA = 8.0;    // ~80 dB stopband
+
+    static const u64 CHUNK_FRAME_COUNT = 16384;
+
+    static const i32 ADPCM_STEP_TABLE[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+        337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+    };
+
+    static const i32 ADPCM_INDEX_TABLE[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8,
+        -1, -1, -1, -1, 2, 4, 6, 8,
+    };
+
+    struct ResampleJob {
+        const f32* padded; // Every plane has 'tapCount' zeros on both sides
+        u64 paddedCount;
+
+        f32* output;
+        u64 outFrameCount;
+        u32 chunkCount;
+
+        u64 srcRate;
+        u64 destRate;
+
+        const f32* bank; // PHASE_COUNT filters of 'tapCount' weights
+        u32 tapCount;
+    };
+
+    struct AdpcmChannel {
+        i32 predictor;
+        i32 stepIndex;
+    };
+
+    static inline i32 clamp_i32(i32 value, i32 min, i32 max) {
+        return (value < min) ? min : (value > max) ? max : value;
+    }
+
+    static inline f32 clamp_f32(f32 value, f32 min, f32 max) {
+        return (value < min) ? min : (value > max) ? max : value;
+    }
+
+    static inline i16 to_s16(f32 value) {
+        return (i16)clamp_i32((i32)floorf(value * 32767.0f + 0.5f), -32768, 32767);
+    }
+
+    static f64 bessel_i0(f64 x) {
+        f64 sum = 1.0;
+        f64 term = 1.0;
+        f64 halfX = x * 0.5;
+
+        for (u32 k = 1; k < 32; k++) {
+            term *= halfX / k;
+            sum += term * term;
+            if (term * term < sum * 1e-12) break;
+        }
+
+        return sum;
+    }
+
+    static f32 read_sample(const Wave* wave, const u8* ptr) {
+        if (wave->isFloat) {
+            if (wave->bitsPerSample == 64) {
+                f64 value;
+                memcpy(&value, ptr, sizeof(f64));
+                return (f32)value;
+            }
+
+            f32 value;
+            memcpy(&value, ptr, sizeof(f32));
+            return value;
+        }
+
+        switch (wave->bitsPerSample) {
+            case 8:
+                return ((i32)ptr[0] - 128) / 128.0f;
+            case 16:
+                {
+                    i16 value;
+                    memcpy(&value, ptr, sizeof(i16));
+                    return value / 32768.0f;
+                }
+            case 24:
+                {
+                    i32 value = (i32)((u32)ptr[0] << 8 | (u32)ptr[1] << 16 | (u32)ptr[2] << 24) >> 8;
+                    return value / 8388608.0f;
+                }
+            default:
+                {
+                    i32 value;
+                    memcpy(&value, ptr, sizeof(i32));
+                    return (f32)(value / 2147483648.0);
+                }
+        }
+    }
+
+    // Filter for a source position 'phase / PHASE_COUNT' past the sample at tap 'tapCount / 2 - 1'
+    static void init_filter_bank(f32* bank, u32 tapCount, f64 cutoff) {
+        f64 halfWidth = tapCount / 2.0;
+
+        for (u32 phase = 0; phase < PHASE_COUNT; phase++) {
+            f32* weights = bank + (u64)phase * tapCount;
+            f64 frac = (f64)phase / PHASE_COUNT;
+            f64 total = 0.0;
+
+            for (u32 t = 0; t < tapCount; t++) {
+                f64 x = (f64)t - (tapCount / 2 - 1) - frac;
+                f64 sincX = cutoff * x;
+                f64 sinc = (sincX == 0.0) ? 1.0 : sin(mathf::PI * sincX) / (mathf::PI * sincX);
+
+                f64 ratio = x / halfWidth;
+                f64 window = (fabs(ratio) < 1.0) ? bessel_i0(KAISER_BETA * sqrt(1.0 - ratio * ratio)) / bessel_i0(KAISER_BETA) : 0.0;
+
+                weights[t] = (f32)(sinc * window);
+                total += weights[t];
+            }
+
+            // Unity gain for every phase, otherwise the rounding of the phase turns into a ripple
+            for (u32 t = 0; t < tapCount; t++) {
+                weights[t] = (f32)(weights[t] / total);
+            }
+        }
+    }
+
+    static void resample_chunk(void* data, u32 index) {
+        ResampleJob* job = (ResampleJob*)data;
+
+        u32 channel = index / job->chunkCount;
+        u64 firstFrame = (u64)(index % job->chunkCount) * CHUNK_FRAME_COUNT;
+        u64 lastFrame = firstFrame + CHUNK_FRAME_COUNT;
+        if (lastFrame > job->outFrameCount) lastFrame = job->outFrameCount;
+
+        const f32* plane = job->padded + (u64)channel * job->paddedCount;
+        f32* output = job->output + (u64)channel * job->outFrameCount;
+
+        for (u64 i = firstFrame; i < lastFrame; i++) {
+            // Exact integer position, long sounds don't drift like an accumulated fraction would
+            u64 position = i * job->srcRate;
+            u64 base = position / job->destRate;
+            u64 phase = ((position % job->destRate) * PHASE_COUNT + job->destRate / 2) / job->destRate;
+            if (phase == PHASE_COUNT) {
+                base++;
+                phase = 0;
+            }
+
+            const f32* src = plane + base + job->tapCount / 2 + 1;
+            const f32* weights = job->bank + phase * job->tapCount;
+
+            __m128 sum = _mm_setzero_ps();
+            for (u32 t = 0; t < job->tapCount; t += 4) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + t), _mm_loadu_ps(weights + t)));
+            }
+
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+            output[i] = _mm_cvtss_f32(sum);
+        }
+    }
+
+    static u8 adpcm_encode_sample(AdpcmChannel* channel, i32 sample) {
+        i32 step = ADPCM_STEP_TABLE[channel->stepIndex];
+        i32 diff = sample - channel->predictor;
+
+        u8 nibble = 0;
+        if (diff < 0) {
+            nibble = 8;
+            diff = -diff;
+        }
+
+        // Mirrors the decoder exactly, so the predictors never drift apart
+        i32 delta = step >> 3;
+        if (diff >= step) { nibble |= 4; diff -= step; delta += step; }
+        step >>= 1;
+        if (diff >= step) { nibble |= 2; diff -= step; delta += step; }
+        step >>= 1;
+        if (diff >= step) { nibble |= 1; delta += step; }
+
+        channel->predictor = clamp_i32(channel->predictor + ((nibble & 8) ? -delta : delta), -32768, 32767);
+        channel->stepIndex = clamp_i32(channel->stepIndex + ADPCM_INDEX_TABLE[nibble], 0, 88);
+        return nibble;
+    }
+
+    static u8* encode_adpcm(const f32* planes, u32 channelCount, u64 frameCount, u64* outSize) {
+        const u32 groupCount = (AUDIO_ADPCM_BLOCK_SIZE - 4) / 4;
+        u64 blockCount = (frameCount + AUDIO_ADPCM_BLOCK_FRAMES - 1) / AUDIO_ADPCM_BLOCK_FRAMES;
+        u64 blockSize = (u64)AUDIO_ADPCM_BLOCK_SIZE * channelCount;
+
+        *outSize = blockCount * blockSize;
+        u8* output = (u8*)memory::alloc(*outSize > 0 ? *outSize : 1);
+
+        AdpcmChannel* channels = (AdpcmChannel*)memory::alloc(sizeof(AdpcmChannel) * channelCount);
+
+        for (u64 block = 0; block < blockCount; block++) {
+            u8* dest = output + block * blockSize;
+            u64 firstFrame = block * AUDIO_ADPCM_BLOCK_FRAMES;
+
+            // The tail of the last block is padded with silence
+            for (u32 c = 0; c < channelCount; c++) {
+                i16 sample = to_s16(planes[(u64)c * frameCount + firstFrame]);
+                channels[c].predictor = sample;
+
+                memcpy(dest, &sample, sizeof(i16));
+                dest[2] = (u8)channels[c].stepIndex;
+                dest[3] = 0;
+                dest += 4;
+            }
+
+            for (u32 group = 0; group < groupCount; group++) {
+                for (u32 c = 0; c < channelCount; c++) {
+                    const f32* plane = planes + (u64)c * frameCount;
+
+                    for (u32 k = 0; k < 8; k += 2) {
+                        u64 frame = firstFrame + 1 + (u64)group * 8 + k;
+                        i32 low = (frame < frameCount) ? to_s16(plane[frame]) : 0;
+                        i32 high = (frame + 1 < frameCount) ? to_s16(plane[frame + 1]) : 0;
+
+                        u8 nibbleLow = adpcm_encode_sample(&channels[c], low);
+                        u8 nibbleHigh = adpcm_encode_sample(&channels[c], high);
+                        *dest++ = (u8)(nibbleLow | (nibbleHigh << 4));
+                    }
+                }
+            }
+        }
+
+        memory::free(channels);
+        return output;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool parse_wav(const u8* data, u64 size, Wave* outWave) {
+        if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) return false;
+
+        Wave wave = {};
+        u16 formatTag = 0;
+        bool hasFormat = false;
+
+        // Walk the RIFF chunks, only the format & sample data are used
+        u64 offset = 12;
+        while (offset + 8 <= size) {
+            const u8* chunk = data + offset;
+            u32 chunkSize = 0;
+            memcpy(&chunkSize, chunk + 4, sizeof(u32));
+
+            if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && offset + 8 + chunkSize <= size) {
+                memcpy(&formatTag, chunk + 8, sizeof(u16));
+                memcpy(&wave.channelCount, chunk + 10, sizeof(u16));
+                memcpy(&wave.sampleRate, chunk + 12, sizeof(u32));
+                memcpy(&wave.frameSize, chunk + 20, sizeof(u16));
+                memcpy(&wave.bitsPerSample, chunk + 22, sizeof(u16));
+
+                // The actual format is the first two bytes of the sub format GUID
+                if (formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 40) {
+                    memcpy(&formatTag, chunk + 8 + 24, sizeof(u16));
+                }
+
+                hasFormat = true;
+            } else if (memcmp(chunk, "data", 4) == 0 && hasFormat) {
+                u64 dataSize = (offset + 8 + chunkSize <= size) ? chunkSize : size - (offset + 8);
+
+                wave.samples = chunk + 8;
+                wave.frameCount = (wave.frameSize > 0) ? dataSize / wave.frameSize : 0;
+                break;
+            }
+
+            // NOTE: Chunks are padded to an even size
+            offset += 8 + (u64)chunkSize + (chunkSize & 1);
+        }
+
+        if (!wave.samples || wave.channelCount == 0 || wave.sampleRate == 0) return false;
+
+        if (formatTag == WAVE_FORMAT_PCM) {
+            if (wave.bitsPerSample != 8 && wave.bitsPerSample != 16 && wave.bitsPerSample != 24 && wave.bitsPerSample != 32) return false;
+        } else if (formatTag == WAVE_FORMAT_IEEE_FLOAT) {
+            if (wave.bitsPerSample != 32 && wave.bitsPerSample != 64) return false;
+            wave.isFloat = true;
+        } else {
+            return false;
+        }
+
+        if (wave.frameSize < wave.channelCount * (wave.bitsPerSample / 8)) return false;
+
+        *outWave = wave;
+        return true;
+    }
+
+    f32* to_planes(const Wave* wave) {
+        f32* planes = (f32*)memory::alloc(sizeof(f32) * (wave->frameCount > 0 ? wave->frameCount : 1) * wave->channelCount);
+        u32 sampleSize = wave->bitsPerSample / 8;
+
+        for (u64 i = 0; i < wave->frameCount; i++) {
+            const u8* frame = wave->samples + i * wave->frameSize;
+
+            for (u32 c = 0; c < wave->channelCount; c++) {
+                planes[(u64)c * wave->frameCount + i] = read_sample(wave, frame + c * sampleSize);
+            }
+        }
+
+        return planes;
+    }
+
+    f32* resample(const f32* planes, u32 channelCount, u64 frameCount, u32 srcRate, u32 destRate, thread::Pool* pool, u64* outFrameCount) {
+        if (srcRate == destRate || frameCount == 0) {
+            f32* output = (f32*)memory::alloc(sizeof(f32) * (frameCount > 0 ? frameCount : 1) * channelCount);
+            memory::copy(output, planes, sizeof(f32) * frameCount * channelCount);
+
+            *outFrameCount = frameCount;
+            return output;
+        }
+
+        // Downsampling moves the cutoff below the new Nyquist, the filter gets wider to keep the same transition band
+        f64 ratio = (destRate < srcRate) ? (f64)destRate / srcRate : 1.0;
+        u32 tapCount = (u32)ceil(BASE_TAP_COUNT / ratio);
+        tapCount = (tapCount + 3) & ~3u;
+        if (tapCount > MAX_TAP_COUNT) tapCount = MAX_TAP_COUNT;
+
+        ResampleJob job = {};
+        job.srcRate = srcRate;
+        job.destRate = destRate;
+        job.tapCount = tapCount;
+        job.outFrameCount = (frameCount * destRate + srcRate - 1) / srcRate;
+        job.chunkCount = (u32)((job.outFrameCount + CHUNK_FRAME_COUNT - 1) / CHUNK_FRAME_COUNT);
+
+        f32* bank = (f32*)memory::alloc(sizeof(f32) * PHASE_COUNT * tapCount);
+        init_filter_bank(bank, tapCount, CUTOFF * ratio);
+        job.bank = bank;
+
+        // Zero padding on both sides keeps the inner loop free of bounds checks
+        job.paddedCount = frameCount + (u64)tapCount * 2;
+        f32* padded = (f32*)memory::alloc(sizeof(f32) * job.paddedCount * channelCount);
+        for (u32 c = 0; c < channelCount; c++) {
+            memory::copy(padded + (u64)c * job.paddedCount + tapCount, planes + (u64)c * frameCount, sizeof(f32) * frameCount);
+        }
+        job.padded = padded;
+
+        job.output = (f32*)memory::alloc(sizeof(f32) * job.outFrameCount * channelCount);
+        thread::pool_dispatch(pool, job.chunkCount * channelCount, resample_chunk, &job);
+
+        memory::free(padded);
+        memory::free(bank);
+
+        *outFrameCount = job.outFrameCount;
+        return job.output;
+    }
+
+    u8* encode(const f32* planes, u32 channelCount, u64 frameCount, AudioFormat format, u64* outSize) {
+        switch (format) {
+            case AudioFormat::S16:
+                {
+                    *outSize = sizeof(i16) * frameCount * channelCount;
+                    i16* output = (i16*)memory::alloc(*outSize > 0 ? *outSize : 1);
+
+                    for (u64 i = 0; i < frameCount; i++) {
+                        for (u32 c = 0; c < channelCount; c++) {
+                            output[i * channelCount + c] = to_s16(planes[(u64)c * frameCount + i]);
+                        }
+                    }
+
+                    return (u8*)output;
+                }
+            case AudioFormat::F32:
+                {
+                    *outSize = sizeof(f32) * frameCount * channelCount;
+                    f32* output = (f32*)memory::alloc(*outSize > 0 ? *outSize : 1);
+
+                    for (u64 i = 0; i < frameCount; i++) {
+                        for (u32 c = 0; c < channelCount; c++) {
+                            output[i * channelCount + c] = clamp_f32(planes[(u64)c * frameCount + i], -1.0f, 1.0f);
+                        }
+                    }
+
+                    return (u8*)output;
+                }
+            case AudioFormat::IMA_ADPCM:
+                return encode_adpcm(planes, channelCount, frameCount, outSize);
+            default:
+                return NULL;
+        }
+    }
+
+    bool parse_format(const char* name, AudioFormat* outFormat) {
+        if (strcmp(name, "s16") == 0) {
+            *outFormat = AudioFormat::S16;
+        } else if (strcmp(name, "f32") == 0) {
+            *outFormat = AudioFormat::F32;
+        } else if (strcmp(name, "adpcm") == 0) {
+            *outFormat = AudioFormat::IMA_ADPCM;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+}
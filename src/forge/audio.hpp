@@ -0,0 +1,40 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "forge/component/audio.hpp"
+
+#include "GEM/core/thread.hpp"
+
+// -------------------------------------------
+// Audio Processing
+// -------------------------------------------
+// Takes wave files apart into one float plane per channel, resamples them with a windowed-sinc polyphase filter
+// and packs the result into the interleaved formats the engine plays directly, see 'forge/component/audio.hpp'.
+
+namespace audio {
+    // View into a mapped wave file, nothing is copied
+    struct Wave {
+        const u8* samples;
+        u64 frameCount;
+        u32 sampleRate;
+        u16 channelCount;
+        u16 bitsPerSample;
+        u16 frameSize;
+        bool isFloat;
+    };
+
+    // Integer PCM (8, 16, 24 & 32-bit) and IEEE float (32 & 64-bit), including WAVE_FORMAT_EXTENSIBLE
+    bool parse_wav(const u8* data, u64 size, Wave* outWave);
+
+    // Returns every channel as its own plane of 'frameCount' floats in [-1, 1], which must be released with 'memory::free'
+    f32* to_planes(const Wave* wave);
+
+    // Returns the resampled planes, which must be released with 'memory::free'
+    f32* resample(const f32* planes, u32 channelCount, u64 frameCount, u32 srcRate, u32 destRate, thread::Pool* pool, u64* outFrameCount);
+
+    // Returns the interleaved data in a single block, which must be released with 'memory::free'
+    u8*  encode(const f32* planes, u32 channelCount, u64 frameCount, AudioFormat format, u64* outSize);
+
+    bool parse_format(const char* name, AudioFormat* outFormat);
+}
@@ -0,0 +1,717 @@
+#include "pch.hpp"
+
+#include "forge/bcn.hpp"
+
+#include "GEM/core/filesystem.hpp"
+#include "GEM/core/memory.hpp"
+
+#include <emmintrin.h>
+
+namespace bcn {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Reference: Direct3D 11 block compression formats (BC1, BC3 & BC7 mode 6), DDS file layout
+    // NOTE: The endpoint fit keeps each pixel in one SSE vector (RGBA in four float lanes), while the index search
+    // transposes the block so every vector holds one channel of four pixels. Palette errors stay exact in floats.
+    static const u32 BLOCK_PIXEL_COUNT = 16;
+
+    struct EncodeJob {
+        const u8* pixels;
+        i32 width;
+        i32 height;
+        u32 blocksX;
+        Format format;
+        u8* output;
+    };
+
+    // A block is kept as floats for the endpoint fitting, 'count' may be less than 16 when pixels are skipped
+    struct BlockColors {
+        __m128 values[BLOCK_PIXEL_COUNT];
+        u32 count;
+    };
+
+    // The same block split into groups of four pixels, one vector per channel & one pixel per lane
+    struct BlockLanes {
+        __m128 channels[BLOCK_PIXEL_COUNT / 4][4];
+    };
+
+    static inline i32 clamp_i32(i32 value, i32 min, i32 max) {
+        return (value < min) ? min : (value > max) ? max : value;
+    }
+
+    static inline __m128 clamp_texel(__m128 value) {
+        return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    }
+
+    static inline __m128 broadcast(__m128 value, u32 lane) {
+        switch (lane) {
+            case 0:  return _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 0, 0, 0));
+            case 1:  return _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1));
+            case 2:  return _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2));
+            default: return _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+
+    static inline f32 dot(__m128 a, __m128 b) {
+        __m128 product = _mm_mul_ps(a, b);
+        __m128 swapped = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 sums = _mm_add_ps(product, swapped);
+        return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehl_ps(swapped, sums)));
+    }
+
+    static inline __m128 load_texel(const u8* ptr) {
+        i32 packed;
+        memcpy(&packed, ptr, sizeof(i32));
+
+        __m128i zero = _mm_setzero_si128();
+        __m128i value = _mm_cvtsi32_si128(packed);
+        value = _mm_unpacklo_epi8(value, zero);
+        value = _mm_unpacklo_epi16(value, zero);
+        return _mm_cvtepi32_ps(value);
+    }
+
+    static void load_block(const EncodeJob* job, u32 blockX, u32 blockY, u8* outBlock) {
+        for (u32 y = 0; y < 4; y++) {
+            i32 srcY = clamp_i32((i32)(blockY * 4 + y), 0, job->height - 1);
+
+            for (u32 x = 0; x < 4; x++) {
+                i32 srcX = clamp_i32((i32)(blockX * 4 + x), 0, job->width - 1);
+                memcpy(outBlock + (y * 4 + x) * 4, job->pixels + ((u64)srcY * job->width + srcX) * 4, 4);
+            }
+        }
+    }
+
+    static void load_lanes(const u8* block, BlockLanes* outLanes) {
+        __m128i zero = _mm_setzero_si128();
+
+        for (u32 g = 0; g < BLOCK_PIXEL_COUNT / 4; g++) {
+            __m128i packed = _mm_loadu_si128((const __m128i*)(block + g * 16));
+            __m128i low = _mm_unpacklo_epi8(packed, zero);
+            __m128i high = _mm_unpackhi_epi8(packed, zero);
+
+            __m128 p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+            __m128 p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+            __m128 p2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+            __m128 p3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+            outLanes->channels[g][0] = p0;
+            outLanes->channels[g][1] = p1;
+            outLanes->channels[g][2] = p2;
+            outLanes->channels[g][3] = p3;
+        }
+    }
+
+    // Closest palette entry for four pixels at once, ties keep the lower index like a plain scan would
+    static void find_closest(const __m128* channels, u32 channelCount, const f32 (*palette)[4], u32 paletteCount, u32* outIndices, u32* outErrors) {
+        __m128 bestError = _mm_set1_ps(FLT_MAX);
+        __m128i bestIdx = _mm_setzero_si128();
+
+        for (u32 p = 0; p < paletteCount; p++) {
+            __m128 error = _mm_setzero_ps();
+            for (u32 c = 0; c < channelCount; c++) {
+                __m128 delta = _mm_sub_ps(channels[c], _mm_set1_ps(palette[p][c]));
+                error = _mm_add_ps(error, _mm_mul_ps(delta, delta));
+            }
+
+            __m128i isCloser = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+            bestError = _mm_min_ps(error, bestError);
+            bestIdx = _mm_or_si128(_mm_and_si128(isCloser, _mm_set1_epi32((i32)p)), _mm_andnot_si128(isCloser, bestIdx));
+        }
+
+        _mm_storeu_si128((__m128i*)outIndices, bestIdx);
+        _mm_storeu_si128((__m128i*)outErrors, _mm_cvtps_epi32(bestError));
+    }
+
+    // Principal axis through power iteration on the covariance matrix, unused channels are zero in every value
+    static void find_principal_axis(const BlockColors* colors, u32 channelCount, __m128* outMean, __m128* outAxis) {
+        __m128 sum = _mm_setzero_ps();
+        for (u32 i = 0; i < colors->count; i++) sum = _mm_add_ps(sum, colors->values[i]);
+        __m128 mean = _mm_div_ps(sum, _mm_set1_ps((f32)colors->count));
+
+        // One covariance row per channel, the matrix is symmetric so rows & columns are interchangeable
+        __m128 covariance[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+        for (u32 i = 0; i < colors->count; i++) {
+            __m128 delta = _mm_sub_ps(colors->values[i], mean);
+            for (u32 c = 0; c < 4; c++) covariance[c] = _mm_add_ps(covariance[c], _mm_mul_ps(delta, broadcast(delta, c)));
+        }
+
+        __m128 axis = _mm_set_ps((channelCount > 3) ? 1.0f : 0.0f, 1.0f, 1.0f, 1.0f);
+        for (u32 iteration = 0; iteration < 8; iteration++) {
+            __m128 next = _mm_setzero_ps();
+            for (u32 c = 0; c < 4; c++) next = _mm_add_ps(next, _mm_mul_ps(covariance[c], broadcast(axis, c)));
+
+            f32 length = dot(next, next);
+            if (length < 1e-12f) break;
+
+            axis = _mm_div_ps(next, _mm_set1_ps(sqrtf(length)));
+        }
+
+        *outMean = mean;
+        *outAxis = axis;
+    }
+
+    static void find_endpoints(const BlockColors* colors, u32 channelCount, f32* outA, f32* outB) {
+        __m128 mean, axis;
+        find_principal_axis(colors, channelCount, &mean, &axis);
+
+        f32 minT = FLT_MAX, maxT = -FLT_MAX;
+        for (u32 i = 0; i < colors->count; i++) {
+            f32 t = dot(_mm_sub_ps(colors->values[i], mean), axis);
+            if (t < minT) minT = t;
+            if (t > maxT) maxT = t;
+        }
+
+        _mm_storeu_ps(outA, clamp_texel(_mm_add_ps(mean, _mm_mul_ps(axis, _mm_set1_ps(maxT)))));
+        _mm_storeu_ps(outB, clamp_texel(_mm_add_ps(mean, _mm_mul_ps(axis, _mm_set1_ps(minT)))));
+    }
+
+    // Least squares endpoints for a fixed index assignment, 'weights' is the share of endpoint A for each pixel
+    static bool refit_endpoints(const BlockColors* colors, const f32* weights, f32* outA, f32* outB) {
+        f32 aa = 0.0f, bb = 0.0f, ab = 0.0f;
+        __m128 ax = _mm_setzero_ps();
+        __m128 bx = _mm_setzero_ps();
+
+        for (u32 i = 0; i < colors->count; i++) {
+            f32 wa = weights[i];
+            f32 wb = 1.0f - wa;
+
+            aa += wa * wa;
+            bb += wb * wb;
+            ab += wa * wb;
+
+            ax = _mm_add_ps(ax, _mm_mul_ps(_mm_set1_ps(wa), colors->values[i]));
+            bx = _mm_add_ps(bx, _mm_mul_ps(_mm_set1_ps(wb), colors->values[i]));
+        }
+
+        f32 determinant = aa * bb - ab * ab;
+        if (fabsf(determinant) < 1e-6f) return false;
+
+        __m128 scale = _mm_set1_ps(determinant);
+        __m128 endA = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(bb), ax), _mm_mul_ps(_mm_set1_ps(ab), bx));
+        __m128 endB = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(aa), bx), _mm_mul_ps(_mm_set1_ps(ab), ax));
+
+        _mm_storeu_ps(outA, clamp_texel(_mm_div_ps(endA, scale)));
+        _mm_storeu_ps(outB, clamp_texel(_mm_div_ps(endB, scale)));
+        return true;
+    }
+
+    // -- BC1
+    struct ColorBlock {
+        u16 color0;
+        u16 color1;
+        u32 indices;
+        u32 error;
+        f32 weights[BLOCK_PIXEL_COUNT]; // Endpoint share per fitted pixel, used for the refit
+    };
+
+    static inline u16 pack_565(const f32* color) {
+        u32 r = (u32)clamp_i32((i32)(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+        u32 g = (u32)clamp_i32((i32)(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+        u32 b = (u32)clamp_i32((i32)(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+        return (u16)((r << 11) | (g << 5) | b);
+    }
+
+    static inline void unpack_565(u16 value, i32* outColor) {
+        i32 r = (value >> 11) & 31;
+        i32 g = (value >> 5) & 63;
+        i32 b = value & 31;
+
+        outColor[0] = (r << 3) | (r >> 2);
+        outColor[1] = (g << 2) | (g >> 4);
+        outColor[2] = (b << 3) | (b >> 2);
+    }
+
+    static void bc1_build(const BlockLanes* lanes, const bool* isOpaque, const f32* endA, const f32* endB, bool isThreeColor, ColorBlock* out) {
+        u16 color0 = pack_565(endA);
+        u16 color1 = pack_565(endB);
+
+        // Four-colour mode needs color0 > color1, three-colour mode the opposite
+        if ((!isThreeColor && color0 < color1) || (isThreeColor && color0 > color1)) {
+            u16 swap = color0;
+            color0 = color1;
+            color1 = swap;
+        }
+
+        i32 endpoints[2][3];
+        unpack_565(color0, endpoints[0]);
+        unpack_565(color1, endpoints[1]);
+
+        u32 paletteCount = 4;
+        f32 palette[4][4] = {};
+        f32 paletteWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+        for (u32 c = 0; c < 3; c++) {
+            palette[0][c] = (f32)endpoints[0][c];
+            palette[1][c] = (f32)endpoints[1][c];
+        }
+
+        if (isThreeColor || color0 == color1) {
+            paletteCount = 3;
+            paletteWeights[2] = 0.5f;
+            for (u32 c = 0; c < 3; c++) palette[2][c] = (f32)((endpoints[0][c] + endpoints[1][c]) / 2);
+        } else {
+            for (u32 c = 0; c < 3; c++) {
+                palette[2][c] = (f32)((2 * endpoints[0][c] + endpoints[1][c]) / 3);
+                palette[3][c] = (f32)((endpoints[0][c] + 2 * endpoints[1][c]) / 3);
+            }
+        }
+
+        // NOTE: Equal endpoints in four-colour mode decode as three-colour mode, index 3 would turn transparent
+        if (!isThreeColor && color0 == color1) paletteCount = 1;
+
+        out->color0 = color0;
+        out->color1 = color1;
+        out->indices = 0;
+        out->error = 0;
+
+        u32 fitIdx = 0;
+        for (u32 g = 0; g < BLOCK_PIXEL_COUNT / 4; g++) {
+            u32 closest[4], errors[4];
+            find_closest(lanes->channels[g], 3, palette, paletteCount, closest, errors);
+
+            for (u32 lane = 0; lane < 4; lane++) {
+                u32 i = g * 4 + lane;
+                u32 bestIdx = 3;
+
+                if (isOpaque[i]) {
+                    bestIdx = closest[lane];
+                    out->error += errors[lane];
+                    out->weights[fitIdx++] = paletteWeights[bestIdx];
+                }
+
+                out->indices |= bestIdx << (i * 2);
+            }
+        }
+    }
+
+    static void encode_bc1_color(const u8* block, const BlockLanes* lanes, u8* out, bool allowTransparent) {
+        BlockColors colors = {};
+        bool isOpaque[BLOCK_PIXEL_COUNT];
+        bool hasTransparent = false;
+
+        // BC1 has no alpha endpoint, the alpha lane stays zero so it drops out of the fit
+        __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+        for (u32 i = 0; i < BLOCK_PIXEL_COUNT; i++) {
+            const u8* pixel = block + i * 4;
+            isOpaque[i] = !allowTransparent || pixel[3] >= 128;
+
+            if (isOpaque[i]) {
+                colors.values[colors.count++] = _mm_and_ps(load_texel(pixel), colorMask);
+            } else {
+                hasTransparent = true;
+            }
+        }
+
+        ColorBlock best = {};
+        if (colors.count == 0) {
+            // Fully transparent, three-colour mode with every index on transparent black
+            best.indices = 0xFFFFFFFF;
+        } else {
+            f32 endA[4], endB[4];
+            find_endpoints(&colors, 3, endA, endB);
+            bc1_build(lanes, isOpaque, endA, endB, hasTransparent, &best);
+
+            // One least squares pass on the chosen indices
+            ColorBlock refined = {};
+            if (best.error > 0 && refit_endpoints(&colors, best.weights, endA, endB)) {
+                bc1_build(lanes, isOpaque, endA, endB, hasTransparent, &refined);
+                if (refined.error < best.error) best = refined;
+            }
+        }
+
+        out[0] = (u8)(best.color0);
+        out[1] = (u8)(best.color0 >> 8);
+        out[2] = (u8)(best.color1);
+        out[3] = (u8)(best.color1 >> 8);
+        memcpy(out + 4, &best.indices, sizeof(u32));
+    }
+
+    // -- BC3
+    static void encode_bc3_alpha(const BlockLanes* lanes, u8* out) {
+        __m128 minLanes = lanes->channels[0][3];
+        __m128 maxLanes = lanes->channels[0][3];
+        for (u32 g = 1; g < BLOCK_PIXEL_COUNT / 4; g++) {
+            minLanes = _mm_min_ps(minLanes, lanes->channels[g][3]);
+            maxLanes = _mm_max_ps(maxLanes, lanes->channels[g][3]);
+        }
+
+        minLanes = _mm_min_ps(minLanes, _mm_movehl_ps(minLanes, minLanes));
+        minLanes = _mm_min_ss(minLanes, _mm_shuffle_ps(minLanes, minLanes, _MM_SHUFFLE(1, 1, 1, 1)));
+        maxLanes = _mm_max_ps(maxLanes, _mm_movehl_ps(maxLanes, maxLanes));
+        maxLanes = _mm_max_ss(maxLanes, _mm_shuffle_ps(maxLanes, maxLanes, _MM_SHUFFLE(1, 1, 1, 1)));
+
+        u8 minAlpha = (u8)_mm_cvtss_si32(minLanes);
+        u8 maxAlpha = (u8)_mm_cvtss_si32(maxLanes);
+
+        out[0] = maxAlpha;
+        out[1] = minAlpha;
+
+        // Eight-value mode, alpha0 > alpha1
+        f32 palette[8][4] = { { (f32)maxAlpha }, { (f32)minAlpha } };
+        for (u32 i = 2; i < 8; i++) palette[i][0] = (f32)(((8 - i) * maxAlpha + (i - 1) * minAlpha) / 7);
+
+        u64 indices = 0;
+        if (maxAlpha != minAlpha) {
+            for (u32 g = 0; g < BLOCK_PIXEL_COUNT / 4; g++) {
+                u32 closest[4], errors[4];
+                find_closest(&lanes->channels[g][3], 1, palette, 8, closest, errors);
+
+                for (u32 lane = 0; lane < 4; lane++) indices |= (u64)closest[lane] << ((g * 4 + lane) * 3);
+            }
+        }
+
+        for (u32 i = 0; i < 6; i++) out[2 + i] = (u8)(indices >> (i * 8));
+    }
+
+    // -- BC7
+    static const u32 BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    struct Bits128 {
+        u64 low;
+        u64 high;
+        u32 position;
+    };
+
+    static inline void bits_put(Bits128* bits, u32 value, u32 count) {
+        u32 position = bits->position;
+        if (position < 64) {
+            bits->low |= (u64)value << position;
+            if (position + count > 64) bits->high |= (u64)value >> (64 - position);
+        } else {
+            bits->high |= (u64)value << (position - 64);
+        }
+
+        bits->position += count;
+    }
+
+    // Mode 6 endpoints are 7 bits per channel plus one shared p-bit, pick the p-bit that lands closer
+    static void bc7_quantize_endpoint(const f32* endpoint, u8* outValues, u32* outPBit) {
+        f32 bestError = FLT_MAX;
+
+        for (u32 pBit = 0; pBit < 2; pBit++) {
+            u8 values[4];
+            f32 error = 0.0f;
+
+            for (u32 c = 0; c < 4; c++) {
+                i32 quantized = clamp_i32((i32)((endpoint[c] - pBit) / 2.0f + 0.5f), 0, 127);
+                values[c] = (u8)quantized;
+
+                f32 delta = (f32)((quantized << 1) | pBit) - endpoint[c];
+                error += delta * delta;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                *outPBit = pBit;
+                memcpy(outValues, values, sizeof(values));
+            }
+        }
+    }
+
+    struct Bc7Block {
+        u8 endpoints[2][4]; // 7-bit values
+        u32 pBits[2];
+        u8 indices[BLOCK_PIXEL_COUNT];
+        u32 error;
+        f32 weights[BLOCK_PIXEL_COUNT];
+    };
+
+    static void bc7_build(const BlockLanes* lanes, const f32* endA, const f32* endB, Bc7Block* out) {
+        bc7_quantize_endpoint(endA, out->endpoints[0], &out->pBits[0]);
+        bc7_quantize_endpoint(endB, out->endpoints[1], &out->pBits[1]);
+
+        i32 color0[4], color1[4];
+        for (u32 c = 0; c < 4; c++) {
+            color0[c] = (out->endpoints[0][c] << 1) | out->pBits[0];
+            color1[c] = (out->endpoints[1][c] << 1) | out->pBits[1];
+        }
+
+        f32 palette[16][4];
+        for (u32 p = 0; p < 16; p++) {
+            for (u32 c = 0; c < 4; c++) {
+                palette[p][c] = (f32)(((64 - BC7_WEIGHTS[p]) * color0[c] + BC7_WEIGHTS[p] * color1[c] + 32) >> 6);
+            }
+        }
+
+        // Every palette entry is tried, four pixels per pass are cheaper than projecting each one onto the endpoint line
+        out->error = 0;
+        for (u32 g = 0; g < BLOCK_PIXEL_COUNT / 4; g++) {
+            u32 closest[4], errors[4];
+            find_closest(lanes->channels[g], 4, palette, 16, closest, errors);
+
+            for (u32 lane = 0; lane < 4; lane++) {
+                u32 i = g * 4 + lane;
+                out->indices[i] = (u8)closest[lane];
+                out->weights[i] = 1.0f - BC7_WEIGHTS[closest[lane]] / 64.0f;
+                out->error += errors[lane];
+            }
+        }
+    }
+
+    static void encode_bc7(const u8* block, const BlockLanes* lanes, u8* out) {
+        BlockColors colors = {};
+        colors.count = BLOCK_PIXEL_COUNT;
+        for (u32 i = 0; i < BLOCK_PIXEL_COUNT; i++) colors.values[i] = load_texel(block + i * 4);
+
+        f32 endA[4], endB[4];
+        find_endpoints(&colors, 4, endA, endB);
+
+        Bc7Block best = {};
+        bc7_build(lanes, endA, endB, &best);
+
+        Bc7Block refined = {};
+        if (best.error > 0 && refit_endpoints(&colors, best.weights, endA, endB)) {
+            bc7_build(lanes, endA, endB, &refined);
+            if (refined.error < best.error) best = refined;
+        }
+
+        // The anchor index is stored without its top bit, flip the endpoints if it would need one
+        if (best.indices[0] & 8) {
+            for (u32 c = 0; c < 4; c++) {
+                u8 swap = best.endpoints[0][c];
+                best.endpoints[0][c] = best.endpoints[1][c];
+                best.endpoints[1][c] = swap;
+            }
+
+            u32 swapBit = best.pBits[0];
+            best.pBits[0] = best.pBits[1];
+            best.pBits[1] = swapBit;
+
+            for (u32 i = 0; i < BLOCK_PIXEL_COUNT; i++) best.indices[i] = 15 - best.indices[i];
+        }
+
+        Bits128 bits = {};
+        bits_put(&bits, 1 << 6, 7); // Mode 6
+
+        for (u32 c = 0; c < 4; c++) {
+            bits_put(&bits, best.endpoints[0][c], 7);
+            bits_put(&bits, best.endpoints[1][c], 7);
+        }
+
+        bits_put(&bits, best.pBits[0], 1);
+        bits_put(&bits, best.pBits[1], 1);
+
+        bits_put(&bits, best.indices[0], 3);
+        for (u32 i = 1; i < BLOCK_PIXEL_COUNT; i++) bits_put(&bits, best.indices[i], 4);
+
+        memcpy(out, &bits.low, sizeof(u64));
+        memcpy(out + 8, &bits.high, sizeof(u64));
+    }
+
+    static void encode_block_row(void* data, u32 blockY) {
+        EncodeJob* job = (EncodeJob*)data;
+        u32 blockSize = get_block_size(job->format);
+        u8* out = job->output + (u64)blockY * job->blocksX * blockSize;
+
+        u8 block[BLOCK_PIXEL_COUNT * 4];
+        BlockLanes lanes;
+        for (u32 blockX = 0; blockX < job->blocksX; blockX++) {
+            load_block(job, blockX, blockY, block);
+            load_lanes(block, &lanes);
+
+            switch (job->format) {
+                using enum Format;
+                case BC1:
+                    encode_bc1_color(block, &lanes, out, true);
+                    break;
+                case BC3:
+                    encode_bc3_alpha(&lanes, out);
+                    encode_bc1_color(block, &lanes, out + 8, false);
+                    break;
+                case BC7:
+                    encode_bc7(block, &lanes, out);
+                    break;
+                default:
+                    break;
+            }
+
+            out += blockSize;
+        }
+    }
+
+    // -- DDS
+    #define DDS_MAGIC 0x20534444 // "DDS "
+
+    #define DDSD_CAPS        0x1
+    #define DDSD_HEIGHT      0x2
+    #define DDSD_WIDTH       0x4
+    #define DDSD_PIXELFORMAT 0x1000
+    #define DDSD_MIPMAPCOUNT 0x20000
+    #define DDSD_LINEARSIZE  0x80000
+    #define DDPF_FOURCC      0x4
+    #define DDSCAPS_COMPLEX  0x8
+    #define DDSCAPS_TEXTURE  0x1000
+    #define DDSCAPS_MIPMAP   0x400000
+
+    #define DXGI_FORMAT_BC1_UNORM 71
+    #define DXGI_FORMAT_BC3_UNORM 77
+    #define DXGI_FORMAT_BC7_UNORM 98
+    #define DDS_DIMENSION_TEXTURE2D 3
+
+    struct DdsPixelFormat {
+        u32 size;
+        u32 flags;
+        u32 fourCC;
+        u32 rgbBitCount;
+        u32 masks[4];
+    };
+
+    struct DdsHeader {
+        u32 size;
+        u32 flags;
+        u32 height;
+        u32 width;
+        u32 pitchOrLinearSize;
+        u32 depth;
+        u32 mipMapCount;
+        u32 reserved[11];
+        DdsPixelFormat pixelFormat;
+        u32 caps[4];
+        u32 reserved2;
+    };
+
+    struct DdsHeaderDx10 {
+        u32 dxgiFormat;
+        u32 resourceDimension;
+        u32 miscFlag;
+        u32 arraySize;
+        u32 miscFlags2;
+    };
+
+    static inline u32 make_four_cc(const char* code) {
+        return (u32)code[0] | ((u32)code[1] << 8) | ((u32)code[2] << 16) | ((u32)code[3] << 24);
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    u32 get_block_size(Format format) {
+        switch (format) {
+            using enum Format;
+            case BC1: return 8;
+            case BC3: return 16;
+            case BC7: return 16;
+            default:  return 0;
+        }
+    }
+
+    u8* encode(const u8* pixels, i32 width, i32 height, Format format, thread::Pool* pool, u64* outSize) {
+        *outSize = 0;
+        if (width <= 0 || height <= 0 || get_block_size(format) == 0) return NULL;
+
+        EncodeJob job = {};
+        job.pixels = pixels;
+        job.width = width;
+        job.height = height;
+        job.blocksX = ((u32)width + 3) / 4;
+        job.format = format;
+
+        u32 blocksY = ((u32)height + 3) / 4;
+        u64 size = (u64)job.blocksX * blocksY * get_block_size(format);
+        job.output = (u8*)memory::alloc(size);
+
+        thread::pool_dispatch(pool, blocksY, encode_block_row, &job);
+
+        *outSize = size;
+        return job.output;
+    }
+
+    bool write_dds(const char* path, const Surface* levels, u32 levelCount, u32 layerCount, Format format, thread::Pool* pool) {
+        if (levelCount == 0 || layerCount == 0 || get_block_size(format) == 0) return false;
+
+        DdsHeader header = {};
+        header.size = sizeof(DdsHeader);
+        header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE;
+        header.height = (u32)levels[0].height;
+        header.width = (u32)levels[0].width;
+        header.pitchOrLinearSize = (((u32)levels[0].width + 3) / 4) * (((u32)levels[0].height + 3) / 4) * get_block_size(format);
+        header.pixelFormat.size = sizeof(DdsPixelFormat);
+        header.pixelFormat.flags = DDPF_FOURCC;
+        header.caps[0] = DDSCAPS_TEXTURE;
+
+        if (levelCount > 1) {
+            header.flags |= DDSD_MIPMAPCOUNT;
+            header.mipMapCount = levelCount;
+            header.caps[0] |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+        }
+
+        // Texture arrays can only be described by the DX10 header, single layers keep the legacy FourCC where there is one
+        DdsHeaderDx10 headerDx10 = {};
+        headerDx10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+        headerDx10.arraySize = layerCount;
+        bool hasDx10Header = layerCount > 1;
+
+        switch (format) {
+            using enum Format;
+            case BC1:
+                {
+                    header.pixelFormat.fourCC = make_four_cc("DXT1");
+                    headerDx10.dxgiFormat = DXGI_FORMAT_BC1_UNORM;
+                }
+                break;
+            case BC3:
+                {
+                    header.pixelFormat.fourCC = make_four_cc("DXT5");
+                    headerDx10.dxgiFormat = DXGI_FORMAT_BC3_UNORM;
+                }
+                break;
+            case BC7:
+                {
+                    headerDx10.dxgiFormat = DXGI_FORMAT_BC7_UNORM;
+                    hasDx10Header = true;
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (hasDx10Header) header.pixelFormat.fourCC = make_four_cc("DX10");
+
+        u32 magic = DDS_MAGIC;
+        file::File f = file::open(path, file::Mode::WRITE, true);
+        if (!f.handle) return false;
+
+        bool success = file::write(&f, &magic, sizeof(magic));
+        success &= file::write(&f, &header, sizeof(header));
+        if (hasDx10Header) success &= file::write(&f, &headerDx10, sizeof(headerDx10));
+
+        for (u32 i = 0; i < levelCount * layerCount && success; i++) {
+            u64 size = 0;
+            u8* blocks = encode(levels[i].pixels, levels[i].width, levels[i].height, format, pool, &size);
+            if (!blocks) {
+                success = false;
+                break;
+            }
+
+            success &= file::write(&f, blocks, (i32)size);
+            memory::free(blocks);
+        }
+
+        file::close(&f);
+
+        // A partial file would pass as a valid texture with garbage levels
+        if (!success) file::remove(path);
+        return success;
+    }
+
+    bool parse_format(const char* name, Format* outFormat) {
+        if (strcmp(name, "none") == 0) {
+            *outFormat = Format::NONE;
+        } else if (strcmp(name, "bc1") == 0) {
+            *outFormat = Format::BC1;
+        } else if (strcmp(name, "bc3") == 0) {
+            *outFormat = Format::BC3;
+        } else if (strcmp(name, "bc7") == 0) {
+            *outFormat = Format::BC7;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "GEM/core/thread.hpp"
+
+// -------------------------------------------
+// Block Compression
+// -------------------------------------------
+// Encodes tightly packed RGBA8 pixels into 4x4 BCn blocks, block rows are spread across the pool.
+// Images that aren't a multiple of 4 get their edge pixels repeated into the last blocks.
+
+namespace bcn {
+    enum class Format : u32 {
+        NONE = 0,
+        BC1,      // RGB + 1-bit alpha, 8 bytes per block
+        BC3,      // RGB + interpolated alpha, 16 bytes per block
+        BC7,      // RGBA, mode 6 only, 16 bytes per block
+        COUNT,
+    };
+
+    struct Surface {
+        const u8* pixels;
+        i32 width;
+        i32 height;
+    };
+
+    u32 get_block_size(Format format);
+
+    // Returns the block data in a single block, which must be released with 'memory::free'
+    u8*  encode(const u8* pixels, i32 width, i32 height, Format format, thread::Pool* pool, u64* outSize);
+
+    // Writes a DDS file (legacy FourCC for BC1 & BC3, DX10 header for BC7 & texture arrays).
+    // 'levels' holds every mip level of the first layer, then every mip level of the next one & so on.
+    bool write_dds(const char* path, const Surface* levels, u32 levelCount, u32 layerCount, Format format, thread::Pool* pool);
+
+    bool parse_format(const char* name, Format* outFormat);
+}
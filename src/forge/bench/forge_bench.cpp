@@ -0,0 +1,1198 @@
+// -------------------------------------------
+// Includes
+// -------------------------------------------
+
+#include "pch.hpp"
+
+#include "forge/blit.hpp"
+#include "forge/pack.hpp"
+#include "forge/png.hpp"
+#include "forge/scan.hpp"
+#include "forge/text.hpp"
+
+#define GEM_FORCE_LOGGING
+#include "GEM/logger.hpp"
+#include "GEM/core/filesystem.hpp"
+#include "GEM/core/hash.hpp"
+#include "GEM/core/memory.hpp"
+#include "GEM/core/thread.hpp"
+#include "GEM/core/timer.hpp"
+
+#include <psapi.h>
+
+// -------------------------------------------
+// Constants
+// -------------------------------------------
+
+#define BENCH_REPEAT_COUNT 8
+#define BENCH_PNG_REPEAT_COUNT 2
+
+#define BENCH_MAX_PATH 256
+#define BENCH_MAX_CORPUS_COUNT 8
+#define BENCH_CORPUS_PATH "bench_corpus"
+#define BENCH_DEFAULT_OUTPUT_PATH "forge_bench.json"
+#define BENCH_MEMORY_SAMPLE_MS 1
+
+#define BENCH_SPRITE_PADDING 2
+#define BENCH_GRID_SIZE 16
+#define BENCH_ATLAS_MIN_SIZE 64
+#define BENCH_ATLAS_MAX_SIZE 16384
+
+#define LOG_PREFIX_WARN ANSI_YELLOW "WARN" ANSI_RESET ": "
+
+// -------------------------------------------
+// Data Types
+// -------------------------------------------
+
+struct BenchImage {
+    u8* data;
+    i32 width;
+    i32 height;
+};
+
+// -- Corpus
+enum class CorpusKind : u32 {
+    SPRITE = 0, // Random sizes with a transparent border, best fit packed
+    TILEMAP,    // 64x64 dual-grid sheets, 16 tiles each
+    PARTICLE,   // Single 16x16 grid cells
+    COUNT,
+};
+
+enum class Stage : u32 {
+    SCAN = 0,
+    MANIFEST,
+    DECODE,
+    PACK,
+    BLIT,
+    ENCODE,
+    CODEGEN,
+    COUNT,
+};
+
+struct StageResult {
+    f64 ms;
+    u64 itemCount;
+    u64 byteCount;
+    u64 peakMemory; // Sampled working set, see 'bench_sample_memory'
+};
+
+struct CorpusFile {
+    char path[BENCH_MAX_PATH];
+    u64 fileSize;
+    u64 hash;
+    BenchImage image;
+};
+
+struct KindRun {
+    CorpusKind kind;
+    char directory[BENCH_MAX_PATH];
+    char headerPath[BENCH_MAX_PATH];
+    u32 expectedCount;
+
+    CorpusFile* files;
+    u32 fileCount;
+
+    stbrp_rect* rects;      // Sprites
+    u32* cellOffsets;       // Grid kinds, first cell of every image
+    pack::Heuristic heuristic; // Sprites, the one the search picked
+    Vec2i atlasSize;
+    u8* atlas;
+    u64 encodedSize;
+
+    StageResult stages[as_index(Stage::COUNT)];
+};
+
+struct CorpusRun {
+    u32 imageCount;
+    char directory[BENCH_MAX_PATH];
+    KindRun kinds[as_index(CorpusKind::COUNT)];
+    bool isComplete;
+};
+
+struct GenerateJob {
+    const KindRun* run;
+    volatile i64 failedCount;
+};
+
+struct MemorySampler {
+    thread::Thread thread;
+    volatile i64 peak; // Written by both the sampler & 'bench_stage_begin', only through 'thread::atomic_*'
+    volatile bool isRunning;
+};
+
+typedef bool (*StageFunc)(KindRun* run);
+
+// -- Kernels
+struct BenchResult {
+    f64 referenceMs;
+    f64 kernelMs;
+    bool isIdentical;
+};
+
+struct BenchPngResult {
+    f64 referenceMs;
+    u64 referenceSize;
+
+    f64 levelMs[as_index(png::Level::COUNT)];
+    u64 levelSize[as_index(png::Level::COUNT)];
+    bool isIdentical[as_index(png::Level::COUNT)];
+};
+
+// -------------------------------------------
+// Shared
+// -------------------------------------------
+
+// Same remap forge uses for dual-grid tilemaps
+const u32 gDualGridLUT[16] = { 12, 15, 8, 9, 0, 11, 14, 7, 13, 4, 1, 10, 3, 2, 5, 6 };
+
+u64 gRandomState = 0x9E3779B97F4A7C15ULL;
+
+thread::Pool gPool = {};
+
+MemorySampler gSampler = {};
+
+const char* gCorpusKindNames[as_index(CorpusKind::COUNT)] = { "sprite", "tilemap", "particle" };
+const u32 gCorpusKindShares[as_index(CorpusKind::COUNT)] = { 70, 10, 20 }; // Percent of every corpus
+
+const char* gStageNames[as_index(Stage::COUNT)] = { "scan", "manifest", "decode", "pack", "blit", "encode", "codegen" };
+
+// -------------------------------------------
+// Functions
+// -------------------------------------------
+
+// -- Utility
+u64 bench_random_next(u64* state) {
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+u64 bench_random() {
+    return bench_random_next(&gRandomState);
+}
+
+BenchImage bench_create_image(i32 width, i32 height) {
+    BenchImage output = {};
+    output.width = width;
+    output.height = height;
+    output.data = (u8*)memory::alloc((u64)width * height * 4);
+
+    u64* words = (u64*)output.data;
+    for (u64 i = 0; i < (u64)width * height / 2; i++) {
+        words[i] = bench_random();
+    }
+
+    return output;
+}
+
+// Sprite-sheet like content: empty cells, flat fills, gradients & noisy cells with cut-out alpha
+BenchImage bench_create_atlas_image(i32 width, i32 height) {
+    const i32 cellSize = 32;
+
+    BenchImage output = {};
+    output.width = width;
+    output.height = height;
+    output.data = (u8*)memory::alloc((u64)width * height * 4);
+
+    for (i32 cellY = 0; cellY < height; cellY += cellSize) {
+        for (i32 cellX = 0; cellX < width; cellX += cellSize) {
+            u64 seed = bench_random();
+            u32 kind = seed % 4;
+            u8 r = (u8)(seed >> 8), g = (u8)(seed >> 16), b = (u8)(seed >> 24);
+
+            for (i32 y = cellY; y < cellY + cellSize && y < height; y++) {
+                for (i32 x = cellX; x < cellX + cellSize && x < width; x++) {
+                    u8* pixel = output.data + ((u64)y * width + x) * 4;
+
+                    switch (kind) {
+                        case 1: pixel[0] = r; pixel[1] = g; pixel[2] = b; pixel[3] = 255; break;
+                        case 2: pixel[0] = r + (x - cellX) * 4; pixel[1] = g + (y - cellY) * 4; pixel[2] = b; pixel[3] = 255; break;
+                        case 3: pixel[0] = (u8)bench_random(); pixel[1] = g; pixel[2] = b; pixel[3] = ((x + y) & 1) ? 255 : 0; break;
+                        default: break;
+                    }
+                }
+            }
+        }
+    }
+
+    return output;
+}
+
+// -- Reference
+// NOTE: These are the per-pixel loops forge used before the blit kernels, kept here as the baseline.
+void bench_reference_rect(u8* atlas, i32 atlasWidth, const BenchImage* img, i32 posX, i32 posY) {
+    for (i32 y = 0; y < img->height; y++) {
+        for (i32 x = 0; x < img->width; x++) {
+            i32 genPixel = ((posY + y) * atlasWidth) + (posX + x);
+            genPixel *= 4;
+
+            i32 assetPixel = (y * img->width) + x;
+            assetPixel *= 4;
+
+            atlas[genPixel + 0] = img->data[assetPixel + 0];
+            atlas[genPixel + 1] = img->data[assetPixel + 1];
+            atlas[genPixel + 2] = img->data[assetPixel + 2];
+            atlas[genPixel + 3] = img->data[assetPixel + 3];
+        }
+    }
+}
+
+void bench_reference_grid(u8* atlas, i32 atlasWidth, const BenchImage* img, u32 gridSize, u32 firstCell) {
+    u32 columnCount = atlasWidth / gridSize;
+    u32 subColumnCount = img->width / gridSize;
+
+    for (u32 subIdx = 0; subIdx < 16; subIdx++) {
+        u32 col = (firstCell + subIdx) % columnCount;
+        u32 row = (firstCell + subIdx) / columnCount;
+
+        u32 convertedSubIdx = gDualGridLUT[subIdx];
+        u32 subCol = convertedSubIdx / subColumnCount;
+        u32 subRow = convertedSubIdx % subColumnCount;
+
+        for (u32 y = 0; y < gridSize; y++) {
+            for (u32 x = 0; x < gridSize; x++) {
+                u32 genPixel = (y * atlasWidth) + (row * gridSize * atlasWidth) + (col * gridSize) + x;
+                genPixel *= 4;
+
+                u32 assetPixel = (y * img->width) + (subRow * gridSize) + (subCol * gridSize * img->width) + x;
+                assetPixel *= 4;
+
+                atlas[genPixel + 0] = img->data[assetPixel + 0];
+                atlas[genPixel + 1] = img->data[assetPixel + 1];
+                atlas[genPixel + 2] = img->data[assetPixel + 2];
+                atlas[genPixel + 3] = img->data[assetPixel + 3];
+            }
+        }
+    }
+}
+
+// -- Kernel
+void bench_kernel_grid(u8* atlas, i32 atlasWidth, const BenchImage* img, u32 gridSize, u32 firstCell) {
+    u32 columnCount = atlasWidth / gridSize;
+    u32 subColumnCount = img->width / gridSize;
+
+    for (u32 subIdx = 0; subIdx < 16; subIdx++) {
+        u32 col = (firstCell + subIdx) % columnCount;
+        u32 row = (firstCell + subIdx) / columnCount;
+
+        u32 convertedSubIdx = gDualGridLUT[subIdx];
+        u32 subCol = convertedSubIdx / subColumnCount;
+        u32 subRow = convertedSubIdx % subColumnCount;
+
+        u8* dest = atlas + (((u64)row * gridSize * atlasWidth) + (col * gridSize)) * 4;
+        const u8* src = img->data + (((u64)subCol * gridSize * img->width) + (subRow * gridSize)) * 4;
+        blit::rect(dest, atlasWidth, src, img->width, gridSize, gridSize);
+    }
+}
+
+// -- Benchmarks
+// Dual-grid tilemaps: 64x64 images split into 16px tiles
+BenchResult bench_grid_tiles(u32 imageCount) {
+    const u32 gridSize = 16;
+    const i32 atlasWidth = 16 * gridSize;
+    const i32 atlasHeight = (i32)((imageCount * 16 + 15) / 16) * gridSize;
+    u64 atlasBytes = (u64)atlasWidth * atlasHeight * 4;
+
+    BenchImage* images = (BenchImage*)memory::alloc(sizeof(BenchImage) * imageCount);
+    for (u32 i = 0; i < imageCount; i++) images[i] = bench_create_image(64, 64);
+
+    u8* referenceAtlas = (u8*)memory::alloc(atlasBytes);
+    u8* kernelAtlas = (u8*)memory::alloc(atlasBytes);
+
+    BenchResult result = {};
+
+    u64 start = timer::get_ticks();
+    for (u32 r = 0; r < BENCH_REPEAT_COUNT; r++) {
+        for (u32 i = 0; i < imageCount; i++) bench_reference_grid(referenceAtlas, atlasWidth, &images[i], gridSize, i * 16);
+    }
+    result.referenceMs = timer::ticks_to_ms(timer::get_ticks() - start) / BENCH_REPEAT_COUNT;
+
+    start = timer::get_ticks();
+    for (u32 r = 0; r < BENCH_REPEAT_COUNT; r++) {
+        for (u32 i = 0; i < imageCount; i++) bench_kernel_grid(kernelAtlas, atlasWidth, &images[i], gridSize, i * 16);
+    }
+    result.kernelMs = timer::ticks_to_ms(timer::get_ticks() - start) / BENCH_REPEAT_COUNT;
+
+    result.isIdentical = memcmp(referenceAtlas, kernelAtlas, atlasBytes) == 0;
+
+    for (u32 i = 0; i < imageCount; i++) memory::free(images[i].data);
+    memory::free(images);
+    memory::free(referenceAtlas);
+    memory::free(kernelAtlas);
+
+    return result;
+}
+
+// Large sprites: 512x512 images placed side by side
+BenchResult bench_best_fit_sprites(u32 imageCount) {
+    const i32 size = 512;
+    const i32 columnCount = 8;
+    const i32 atlasWidth = columnCount * size;
+    const i32 atlasHeight = (i32)((imageCount + columnCount - 1) / columnCount) * size;
+    u64 atlasBytes = (u64)atlasWidth * atlasHeight * 4;
+
+    BenchImage* images = (BenchImage*)memory::alloc(sizeof(BenchImage) * imageCount);
+    for (u32 i = 0; i < imageCount; i++) images[i] = bench_create_image(size, size);
+
+    u8* referenceAtlas = (u8*)memory::alloc(atlasBytes);
+    u8* kernelAtlas = (u8*)memory::alloc(atlasBytes);
+
+    BenchResult result = {};
+
+    u64 start = timer::get_ticks();
+    for (u32 r = 0; r < BENCH_REPEAT_COUNT; r++) {
+        for (u32 i = 0; i < imageCount; i++) {
+            bench_reference_rect(referenceAtlas, atlasWidth, &images[i], (i % columnCount) * size, (i / columnCount) * size);
+        }
+    }
+    result.referenceMs = timer::ticks_to_ms(timer::get_ticks() - start) / BENCH_REPEAT_COUNT;
+
+    start = timer::get_ticks();
+    for (u32 r = 0; r < BENCH_REPEAT_COUNT; r++) {
+        for (u32 i = 0; i < imageCount; i++) {
+            u8* dest = kernelAtlas + (((u64)(i / columnCount) * size * atlasWidth) + (i % columnCount) * size) * 4;
+            blit::rect(dest, atlasWidth, images[i].data, size, size, size);
+        }
+    }
+    result.kernelMs = timer::ticks_to_ms(timer::get_ticks() - start) / BENCH_REPEAT_COUNT;
+
+    result.isIdentical = memcmp(referenceAtlas, kernelAtlas, atlasBytes) == 0;
+
+    for (u32 i = 0; i < imageCount; i++) memory::free(images[i].data);
+    memory::free(images);
+    memory::free(referenceAtlas);
+    memory::free(kernelAtlas);
+
+    return result;
+}
+
+// Atlas output: stb's single-threaded writer against the striped encoder at every level
+void bench_png_count_bytes(void* context, void* data, i32 size) {
+    *(u64*)context += (u64)size;
+}
+
+BenchPngResult bench_png_encode(const BenchImage* img) {
+    BenchPngResult result = {};
+    u64 pixelBytes = (u64)img->width * img->height * 4;
+
+    u64 start = timer::get_ticks();
+    for (u32 r = 0; r < BENCH_PNG_REPEAT_COUNT; r++) {
+        result.referenceSize = 0;
+        stbi_write_png_to_func(bench_png_count_bytes, &result.referenceSize, img->width, img->height, 4, img->data, img->width * 4);
+    }
+    result.referenceMs = timer::ticks_to_ms(timer::get_ticks() - start) / BENCH_PNG_REPEAT_COUNT;
+
+    for (u32 level = 0; level < as_index(png::Level::COUNT); level++) {
+        u8* encoded = NULL;
+        u64 encodedSize = 0;
+
+        start = timer::get_ticks();
+        for (u32 r = 0; r < BENCH_PNG_REPEAT_COUNT; r++) {
+            if (encoded) memory::free(encoded);
+            encoded = png::encode(img->data, img->width, img->height, (png::Level)level, &gPool, &encodedSize);
+        }
+        result.levelMs[level] = timer::ticks_to_ms(timer::get_ticks() - start) / BENCH_PNG_REPEAT_COUNT;
+        result.levelSize[level] = encodedSize;
+
+        // Round trip through stb to make sure the stream is valid
+        i32 width = 0, height = 0, channels = 0;
+        unsigned char* decoded = stbi_load_from_memory(encoded, (i32)encodedSize, &width, &height, &channels, 4);
+        result.isIdentical[level] = decoded && width == img->width && height == img->height && memcmp(decoded, img->data, pixelBytes) == 0;
+
+        if (decoded) stbi_image_free(decoded);
+        memory::free(encoded);
+    }
+
+    return result;
+}
+
+void bench_print_png_result(const char* name, const BenchPngResult* result) {
+    static const char* levelNames[as_index(png::Level::COUNT)] = { "fast", "default", "small" };
+
+    log_format("- %-24s stb:     %9.3f ms | %10llu bytes", name, result->referenceMs, (unsigned long long)result->referenceSize);
+    for (u32 level = 0; level < as_index(png::Level::COUNT); level++) {
+        f64 speedup = result->levelMs[level] > 0.0 ? result->referenceMs / result->levelMs[level] : 0.0;
+        f64 sizeRatio = result->referenceSize > 0 ? (f64)result->levelSize[level] / result->referenceSize : 0.0;
+
+        log_format("  %-24s %-8s %9.3f ms | %10llu bytes | speedup: %6.2fx | size: %5.1f%% | %s", "", levelNames[level],
+                   result->levelMs[level], (unsigned long long)result->levelSize[level], speedup, sizeRatio * 100.0,
+                   result->isIdentical[level] ? ANSI_GREEN "identical" ANSI_RESET : ANSI_RED "MISMATCH" ANSI_RESET);
+    }
+}
+
+void bench_print_result(const char* name, BenchResult result) {
+    f64 speedup = result.kernelMs > 0.0 ? result.referenceMs / result.kernelMs : 0.0;
+
+    log_format("- %-24s reference: %9.3f ms | kernel: %9.3f ms | speedup: %6.2fx | %s", name,
+               result.referenceMs, result.kernelMs, speedup, result.isIdentical ? ANSI_GREEN "identical" ANSI_RESET : ANSI_RED "MISMATCH" ANSI_RESET);
+}
+
+// -- Corpus Generation
+// Sprite with a 1-3px transparent border around a noisy fill
+BenchImage bench_create_sprite(u64* state) {
+    BenchImage output = {};
+    output.width = 8 + (i32)(bench_random_next(state) % 41);
+    output.height = 8 + (i32)(bench_random_next(state) % 41);
+    output.data = (u8*)memory::alloc((u64)output.width * output.height * 4);
+
+    i32 border = 1 + (i32)(bench_random_next(state) % 3);
+    u64 colour = bench_random_next(state);
+
+    for (i32 y = border; y < output.height - border; y++) {
+        for (i32 x = border; x < output.width - border; x++) {
+            u8* pixel = output.data + ((u64)y * output.width + x) * 4;
+            u64 noise = bench_random_next(state);
+
+            pixel[0] = (u8)(colour >> 8) + (u8)(noise & 31);
+            pixel[1] = (u8)(colour >> 16) + (u8)((noise >> 8) & 31);
+            pixel[2] = (u8)(colour >> 24) + (u8)((noise >> 16) & 31);
+            pixel[3] = 255;
+        }
+    }
+
+    return output;
+}
+
+// 4x4 tiles of 16px, each split diagonally between two terrain colours
+BenchImage bench_create_tilemap(u64* state) {
+    BenchImage output = {};
+    output.width = BENCH_GRID_SIZE * 4;
+    output.height = BENCH_GRID_SIZE * 4;
+    output.data = (u8*)memory::alloc((u64)output.width * output.height * 4);
+
+    u64 ground = bench_random_next(state);
+    u64 edge = bench_random_next(state);
+
+    for (i32 y = 0; y < output.height; y++) {
+        for (i32 x = 0; x < output.width; x++) {
+            u8* pixel = output.data + ((u64)y * output.width + x) * 4;
+            i32 tileX = x % BENCH_GRID_SIZE;
+            i32 tileY = y % BENCH_GRID_SIZE;
+            u64 colour = (tileX + tileY < BENCH_GRID_SIZE) ? ground : edge;
+
+            pixel[0] = (u8)(colour >> 8) + (u8)((x ^ y) & 7);
+            pixel[1] = (u8)(colour >> 16);
+            pixel[2] = (u8)(colour >> 24);
+            pixel[3] = 255;
+        }
+    }
+
+    return output;
+}
+
+// Soft radial blob fading out to transparent
+BenchImage bench_create_particle(u64* state) {
+    BenchImage output = {};
+    output.width = BENCH_GRID_SIZE;
+    output.height = BENCH_GRID_SIZE;
+    output.data = (u8*)memory::alloc((u64)output.width * output.height * 4);
+
+    u64 colour = bench_random_next(state);
+    f32 center = (BENCH_GRID_SIZE - 1) * 0.5f;
+
+    for (i32 y = 0; y < output.height; y++) {
+        for (i32 x = 0; x < output.width; x++) {
+            u8* pixel = output.data + ((u64)y * output.width + x) * 4;
+            f32 distance = sqrtf((x - center) * (x - center) + (y - center) * (y - center)) / center;
+            f32 alpha = 1.0f - distance;
+
+            pixel[0] = (u8)(colour >> 8);
+            pixel[1] = (u8)(colour >> 16);
+            pixel[2] = (u8)(colour >> 24);
+            pixel[3] = alpha > 0.0f ? (u8)(alpha * 255.0f) : 0;
+        }
+    }
+
+    return output;
+}
+
+void bench_get_corpus_file_path(const KindRun* run, u32 index, char* outPath) {
+    snprintf(outPath, BENCH_MAX_PATH, "%s/%s_%06u.png", run->directory, gCorpusKindNames[as_index(run->kind)], index);
+}
+
+bool bench_create_directory(const char* path) {
+    return CreateDirectoryA(path, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+// Every file gets its own seed, so the corpus comes out the same no matter how the pool splits the work
+void bench_generate_file(void* data, u32 index) {
+    GenerateJob* job = (GenerateJob*)data;
+    const KindRun* run = job->run;
+
+    u64 state = ((u64)index + 1) * 0x9E3779B97F4A7C15ULL ^ ((u64)as_index(run->kind) + 1) * 0xD1B54A32D192ED03ULL;
+    if (state == 0) state = 1;
+
+    BenchImage img = {};
+    switch (run->kind) {
+        using enum CorpusKind;
+        case SPRITE:   img = bench_create_sprite(&state); break;
+        case TILEMAP:  img = bench_create_tilemap(&state); break;
+        case PARTICLE: img = bench_create_particle(&state); break;
+        default: break;
+    }
+
+    char path[BENCH_MAX_PATH];
+    bench_get_corpus_file_path(run, index, path);
+
+    if (!img.data || !png::write(path, img.data, img.width, img.height, png::Level::FAST, &gPool)) {
+        thread::atomic_increment(&job->failedCount);
+    }
+
+    if (img.data) memory::free(img.data);
+}
+
+u32 bench_count_corpus_files(const char* directory) {
+    DIR* handle = opendir(directory);
+    if (!handle) return 0;
+
+    u32 fileCount = 0;
+    struct dirent* content = NULL;
+    while ((content = readdir(handle)) != NULL) {
+        if (file::has_extension(content->d_name, ".png")) fileCount++;
+    }
+
+    closedir(handle);
+    return fileCount;
+}
+
+// NOTE: Corpora left behind by '--keep' are reused when their file counts still match.
+bool bench_create_corpus(CorpusRun* corpus, u32 imageCount) {
+    corpus->imageCount = imageCount;
+    snprintf(corpus->directory, BENCH_MAX_PATH, BENCH_CORPUS_PATH "/%u", imageCount);
+
+    if (!bench_create_directory(BENCH_CORPUS_PATH) || !bench_create_directory(corpus->directory)) {
+        log_format(LOG_PREFIX_WARN "CORPUS > Failed to create " ANSI_GREEN "'%s'" ANSI_RESET, corpus->directory);
+        return false;
+    }
+
+    // Every kind gets its share, rounded down, with at least one image. Sprites take the rest.
+    u32 spriteCount = imageCount;
+    for (u32 i = 1; i < as_index(CorpusKind::COUNT); i++) {
+        u32 count = imageCount * gCorpusKindShares[i] / 100;
+        corpus->kinds[i].expectedCount = count > 0 ? count : 1;
+        spriteCount = spriteCount > corpus->kinds[i].expectedCount ? spriteCount - corpus->kinds[i].expectedCount : 1;
+    }
+    corpus->kinds[as_index(CorpusKind::SPRITE)].expectedCount = spriteCount;
+
+    u64 start = timer::get_ticks();
+    u32 generatedCount = 0;
+
+    for (u32 i = 0; i < as_index(CorpusKind::COUNT); i++) {
+        KindRun* run = &corpus->kinds[i];
+        run->kind = (CorpusKind)i;
+        snprintf(run->directory, BENCH_MAX_PATH, "%s/%s", corpus->directory, gCorpusKindNames[i]);
+        snprintf(run->headerPath, BENCH_MAX_PATH, "%s/%s.hpp", corpus->directory, gCorpusKindNames[i]);
+
+        if (!bench_create_directory(run->directory)) {
+            log_format(LOG_PREFIX_WARN "CORPUS > Failed to create " ANSI_GREEN "'%s'" ANSI_RESET, run->directory);
+            return false;
+        }
+
+        if (bench_count_corpus_files(run->directory) == run->expectedCount) continue;
+
+        GenerateJob job = {};
+        job.run = run;
+        thread::pool_dispatch(&gPool, run->expectedCount, bench_generate_file, &job);
+
+        if (job.failedCount > 0) {
+            log_format(LOG_PREFIX_WARN "CORPUS > Failed to write %lld %s images", (long long)job.failedCount, gCorpusKindNames[i]);
+            return false;
+        }
+
+        generatedCount += run->expectedCount;
+    }
+
+    log_format(ANSI_CYAN "[CORPUS] " ANSI_RESET "%u images | %u sprites, %u tilemaps, %u particles | generated %u in %.3f ms", imageCount,
+               corpus->kinds[as_index(CorpusKind::SPRITE)].expectedCount, corpus->kinds[as_index(CorpusKind::TILEMAP)].expectedCount,
+               corpus->kinds[as_index(CorpusKind::PARTICLE)].expectedCount, generatedCount, timer::ticks_to_ms(timer::get_ticks() - start));
+
+    return true;
+}
+
+void bench_remove_corpus(const CorpusRun* corpus) {
+    for (u32 i = 0; i < as_index(CorpusKind::COUNT); i++) {
+        const KindRun* run = &corpus->kinds[i];
+
+        char path[BENCH_MAX_PATH];
+        for (u32 j = 0; j < run->expectedCount; j++) {
+            bench_get_corpus_file_path(run, j, path);
+            file::remove(path);
+        }
+
+        if (file::exists(run->headerPath)) file::remove(run->headerPath);
+        RemoveDirectoryA(run->directory);
+    }
+
+    RemoveDirectoryA(corpus->directory);
+}
+
+// -- Memory
+u64 bench_get_working_set() {
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+    return (u64)counters.WorkingSetSize;
+}
+
+// NOTE: Polling can miss allocations that live shorter than the sample interval, the stage end is always sampled as well.
+u32 bench_sample_memory(void* data) {
+    MemorySampler* sampler = (MemorySampler*)data;
+
+    while (sampler->isRunning) {
+        // The peak is read before sampling. Only 'bench_stage_begin' can change it meanwhile, so a failed swap
+        // means a stage began in between & the sample is dropped, it belongs to the previous stage.
+        i64 observed = sampler->peak;
+        i64 current = (i64)bench_get_working_set();
+        if (current > observed) thread::atomic_compare_exchange(&sampler->peak, observed, current);
+
+        Sleep(BENCH_MEMORY_SAMPLE_MS);
+    }
+
+    return 0;
+}
+
+u64 bench_stage_begin() {
+    thread::atomic_exchange(&gSampler.peak, (i64)bench_get_working_set());
+    return timer::get_ticks();
+}
+
+void bench_stage_end(StageResult* result, u64 start) {
+    result->ms = timer::ticks_to_ms(timer::get_ticks() - start);
+
+    u64 current = bench_get_working_set();
+    u64 peak = (u64)gSampler.peak;
+    result->peakMemory = current > peak ? current : peak;
+}
+
+// -- Stages
+// Same scanner as forge, so the stage reflects what a real bundle scan costs
+bool bench_stage_scan(KindRun* run) {
+    scan::Listing listing = {};
+    if (!scan::directory(run->directory, ".png", &gPool, &listing)) return false;
+
+    run->files = (CorpusFile*)memory::alloc(sizeof(CorpusFile) * run->expectedCount);
+    run->fileCount = 0;
+
+    for (u32 i = 0; i < listing.count; i++) {
+        if (run->fileCount == run->expectedCount) {
+            log_format(LOG_PREFIX_WARN "SCAN > More files than expected in " ANSI_GREEN "'%s'" ANSI_RESET, run->directory);
+            break;
+        }
+
+        snprintf(run->files[run->fileCount].path, BENCH_MAX_PATH, "%s/%s", run->directory, listing.entries[i].path);
+        run->fileCount++;
+    }
+
+    scan::release(&listing);
+
+    run->stages[as_index(Stage::SCAN)].itemCount = run->fileCount;
+    return run->fileCount > 0;
+}
+
+void bench_manifest_file(void* data, u32 index) {
+    CorpusFile* corpusFile = &((KindRun*)data)->files[index];
+
+    file::Mapping mapping = {};
+    if (!file::map(corpusFile->path, &mapping)) return;
+
+    corpusFile->fileSize = mapping.size;
+    corpusFile->hash = hash::xxh64(mapping.data, mapping.size);
+    file::unmap(&mapping);
+}
+
+bool bench_stage_manifest(KindRun* run) {
+    thread::pool_dispatch(&gPool, run->fileCount, bench_manifest_file, run);
+
+    StageResult* result = &run->stages[as_index(Stage::MANIFEST)];
+    result->itemCount = run->fileCount;
+    for (u32 i = 0; i < run->fileCount; i++) {
+        if (run->files[i].fileSize == 0) return false;
+        result->byteCount += run->files[i].fileSize;
+    }
+
+    return true;
+}
+
+void bench_decode_file(void* data, u32 index) {
+    CorpusFile* corpusFile = &((KindRun*)data)->files[index];
+
+    i32 channels = 0;
+    corpusFile->image.data = stbi_load(corpusFile->path, &corpusFile->image.width, &corpusFile->image.height, &channels, 4);
+}
+
+bool bench_stage_decode(KindRun* run) {
+    thread::pool_dispatch(&gPool, run->fileCount, bench_decode_file, run);
+
+    StageResult* result = &run->stages[as_index(Stage::DECODE)];
+    result->itemCount = run->fileCount;
+    for (u32 i = 0; i < run->fileCount; i++) {
+        const BenchImage* img = &run->files[i].image;
+        if (!img->data) return false;
+        result->byteCount += (u64)img->width * img->height * 4;
+    }
+
+    return true;
+}
+
+// Sprites go through the same search forge runs, past pack::SEARCH_RECT_LIMIT that search only tries skyline as in forge.
+// Grid kinds fill a near square grid.
+bool bench_stage_pack(KindRun* run) {
+    StageResult* result = &run->stages[as_index(Stage::PACK)];
+    result->itemCount = run->fileCount;
+
+    if (run->kind != CorpusKind::SPRITE) {
+        run->cellOffsets = (u32*)memory::alloc(sizeof(u32) * run->fileCount);
+
+        u32 cellCount = 0;
+        for (u32 i = 0; i < run->fileCount; i++) {
+            const BenchImage* img = &run->files[i].image;
+            run->cellOffsets[i] = cellCount;
+            cellCount += (img->width / BENCH_GRID_SIZE) * (img->height / BENCH_GRID_SIZE);
+        }
+
+        u32 columnCount = (u32)ceil(sqrt((f64)cellCount));
+        u32 rowCount = (cellCount + columnCount - 1) / columnCount;
+        run->atlasSize = Vec2i(columnCount * BENCH_GRID_SIZE, rowCount * BENCH_GRID_SIZE);
+        return true;
+    }
+
+    run->rects = (stbrp_rect*)memory::alloc(sizeof(stbrp_rect) * run->fileCount);
+
+    for (u32 i = 0; i < run->fileCount; i++) {
+        const BenchImage* img = &run->files[i].image;
+        run->rects[i].id = i;
+        run->rects[i].w = (img->width + BENCH_SPRITE_PADDING * 2 + 3) & ~3;
+        run->rects[i].h = (img->height + BENCH_SPRITE_PADDING * 2 + 3) & ~3;
+    }
+
+    pack::Result packResult = {};
+    Vec2i minSize = { BENCH_ATLAS_MIN_SIZE, BENCH_ATLAS_MIN_SIZE };
+    Vec2i maxSize = { BENCH_ATLAS_MAX_SIZE, BENCH_ATLAS_MAX_SIZE };
+
+    if (!pack::find_best(run->rects, run->fileCount, minSize, maxSize, true, &gPool, &packResult)) return false;
+
+    run->atlasSize = packResult.size;
+    run->heuristic = packResult.heuristic;
+    return true;
+}
+
+void bench_blit_file(void* data, u32 index) {
+    KindRun* run = (KindRun*)data;
+    const BenchImage* img = &run->files[index].image;
+    i32 atlasWidth = run->atlasSize.w;
+
+    switch (run->kind) {
+        using enum CorpusKind;
+        case SPRITE:
+            {
+                const stbrp_rect* rect = &run->rects[index];
+                if (!rect->was_packed) return;
+
+                // The packer hands rotated rects back with their sides swapped
+                i32 paddedWidth = (img->width + BENCH_SPRITE_PADDING * 2 + 3) & ~3;
+                u8* dest = run->atlas + (((u64)rect->y + BENCH_SPRITE_PADDING) * atlasWidth + rect->x + BENCH_SPRITE_PADDING) * 4;
+
+                if (rect->w != paddedWidth) {
+                    blit::rect_rotated(dest, atlasWidth, img->data, img->width, img->width, img->height);
+                } else {
+                    blit::rect(dest, atlasWidth, img->data, img->width, img->width, img->height);
+                }
+            }
+            break;
+        case TILEMAP:
+            {
+                bench_kernel_grid(run->atlas, atlasWidth, img, BENCH_GRID_SIZE, run->cellOffsets[index]);
+            }
+            break;
+        case PARTICLE:
+            {
+                u32 columnCount = atlasWidth / BENCH_GRID_SIZE;
+                u32 col = run->cellOffsets[index] % columnCount;
+                u32 row = run->cellOffsets[index] / columnCount;
+
+                u8* dest = run->atlas + (((u64)row * BENCH_GRID_SIZE * atlasWidth) + (col * BENCH_GRID_SIZE)) * 4;
+                blit::rect(dest, atlasWidth, img->data, img->width, BENCH_GRID_SIZE, BENCH_GRID_SIZE);
+            }
+            break;
+        default: break;
+    }
+}
+
+bool bench_stage_blit(KindRun* run) {
+    run->atlas = (u8*)memory::alloc((u64)run->atlasSize.w * run->atlasSize.h * 4);
+    if (!run->atlas) return false;
+
+    thread::pool_dispatch(&gPool, run->fileCount, bench_blit_file, run);
+
+    StageResult* result = &run->stages[as_index(Stage::BLIT)];
+    result->itemCount = run->fileCount;
+    for (u32 i = 0; i < run->fileCount; i++) {
+        result->byteCount += (u64)run->files[i].image.width * run->files[i].image.height * 4;
+    }
+
+    return true;
+}
+
+bool bench_stage_encode(KindRun* run) {
+    u8* encoded = png::encode(run->atlas, run->atlasSize.w, run->atlasSize.h, png::Level::DEFAULT, &gPool, &run->encodedSize);
+    if (!encoded) return false;
+
+    memory::free(encoded);
+
+    StageResult* result = &run->stages[as_index(Stage::ENCODE)];
+    result->itemCount = 1;
+    result->byteCount = (u64)run->atlasSize.w * run->atlasSize.h * 4;
+    return true;
+}
+
+// Same shape as the atlas part of the generated asset header: a name enum and one rect per image
+bool bench_stage_codegen(KindRun* run) {
+    text::Builder builder = {};
+    if (!text::init(&builder)) return false;
+
+    const char* kindName = gCorpusKindNames[as_index(run->kind)];
+
+    text::line(&builder, "// Generated by forge_bench");
+    text::linef(&builder, "enum class Bench_%s : u32 {", kindName);
+    for (u32 i = 0; i < run->fileCount; i++) {
+        const char* fileName = strrchr(run->files[i].path, '/') + 1;
+        u32 nameLength = (u32)(strlen(fileName) - strlen(".png"));
+
+        char name[BENCH_MAX_PATH];
+        for (u32 j = 0; j < nameLength; j++) {
+            char c = fileName[j];
+            name[j] = (c >= 'a' && c <= 'z') ? (char)(c - 32) : c;
+        }
+        name[nameLength] = '\0';
+
+        text::linef(&builder, "    %s,", name);
+    }
+    text::line(&builder, "    COUNT,");
+    text::line(&builder, "};");
+    text::line(&builder);
+
+    text::linef(&builder, "const AtlasRect gBench_%s_rects[] = {", kindName);
+    for (u32 i = 0; i < run->fileCount; i++) {
+        const BenchImage* img = &run->files[i].image;
+        i32 x = 0, y = 0, width = img->width, height = img->height;
+
+        if (run->kind == CorpusKind::SPRITE) {
+            const stbrp_rect* rect = &run->rects[i];
+            i32 paddedWidth = (img->width + BENCH_SPRITE_PADDING * 2 + 3) & ~3;
+
+            x = rect->x + BENCH_SPRITE_PADDING;
+            y = rect->y + BENCH_SPRITE_PADDING;
+            if (rect->w != paddedWidth) {
+                width = img->height;
+                height = img->width;
+            }
+        } else {
+            u32 columnCount = run->atlasSize.w / BENCH_GRID_SIZE;
+            x = (run->cellOffsets[i] % columnCount) * BENCH_GRID_SIZE;
+            y = (run->cellOffsets[i] / columnCount) * BENCH_GRID_SIZE;
+        }
+
+        text::linef(&builder, "    { %i, %i, %i, %i },", x, y, width, height);
+    }
+    text::line(&builder, "};");
+
+    bool success = text::write_if_changed(&builder, run->headerPath);
+
+    StageResult* result = &run->stages[as_index(Stage::CODEGEN)];
+    result->itemCount = run->fileCount;
+    result->byteCount = builder.length;
+
+    text::release(&builder);
+    return success;
+}
+
+const StageFunc gStageFuncs[as_index(Stage::COUNT)] = {
+    bench_stage_scan,
+    bench_stage_manifest,
+    bench_stage_decode,
+    bench_stage_pack,
+    bench_stage_blit,
+    bench_stage_encode,
+    bench_stage_codegen,
+};
+
+void bench_release_kind(KindRun* run) {
+    for (u32 i = 0; i < run->fileCount; i++) {
+        if (run->files[i].image.data) stbi_image_free(run->files[i].image.data);
+    }
+
+    if (run->files) memory::free(run->files);
+    if (run->rects) memory::free(run->rects);
+    if (run->cellOffsets) memory::free(run->cellOffsets);
+    if (run->atlas) memory::free(run->atlas);
+
+    run->files = NULL;
+    run->fileCount = 0;
+    run->rects = NULL;
+    run->cellOffsets = NULL;
+    run->atlas = NULL;
+}
+
+// Runs every stage in order over the kind, the intermediate data of each stage feeds the next just like in forge
+bool bench_run_kind(KindRun* run) {
+    bool success = true;
+
+    for (u32 stage = 0; stage < as_index(Stage::COUNT); stage++) {
+        u64 start = bench_stage_begin();
+        bool isDone = gStageFuncs[stage](run);
+        bench_stage_end(&run->stages[stage], start);
+
+        if (!isDone) {
+            log_format(LOG_PREFIX_WARN "BENCH > Stage %s failed for %s images in " ANSI_GREEN "'%s'" ANSI_RESET,
+                       gStageNames[stage], gCorpusKindNames[as_index(run->kind)], run->directory);
+            success = false;
+            break;
+        }
+    }
+
+    bench_release_kind(run);
+    return success;
+}
+
+// -- Report
+f64 bench_get_per_second(u64 count, f64 ms) {
+    return ms > 0.0 ? (f64)count / (ms / 1000.0) : 0.0;
+}
+
+void bench_print_kind(const KindRun* run) {
+    const char* packMode = (run->kind != CorpusKind::SPRITE) ? "grid" : pack::get_heuristic_name(run->heuristic);
+    log_format("- %s (%u images) | %ix%i atlas, %s packed, %llu bytes encoded", gCorpusKindNames[as_index(run->kind)], run->expectedCount,
+               run->atlasSize.w, run->atlasSize.h, packMode, (unsigned long long)run->encodedSize);
+
+    for (u32 stage = 0; stage < as_index(Stage::COUNT); stage++) {
+        const StageResult* result = &run->stages[stage];
+        log_format("  %-10s %10.3f ms | %12.1f items/s | %9.1f MB/s | peak: %8.1f MB", gStageNames[stage], result->ms,
+                   bench_get_per_second(result->itemCount, result->ms), bench_get_per_second(result->byteCount, result->ms) / (1024.0 * 1024.0),
+                   result->peakMemory / (1024.0 * 1024.0));
+    }
+}
+
+void bench_append_stage_json(text::Builder* builder, const char* indent, const char* name, const StageResult* result, bool isLast) {
+    text::linef(builder, "%s\"%s\": { \"ms\": %.3f, \"items\": %llu, \"bytes\": %llu, \"itemsPerSec\": %.1f, \"mbPerSec\": %.3f, \"peakBytes\": %llu }%s",
+                indent, name, result->ms, (unsigned long long)result->itemCount, (unsigned long long)result->byteCount,
+                bench_get_per_second(result->itemCount, result->ms), bench_get_per_second(result->byteCount, result->ms) / (1024.0 * 1024.0),
+                (unsigned long long)result->peakMemory, isLast ? "" : ",");
+}
+
+// Stage bytes: manifest hashes file bytes, decode produces pixels, blit copies pixels, encode reads the atlas pixels
+// & codegen writes header text. Scan & pack only report items.
+bool bench_write_json(const char* path, const CorpusRun* corpora, u32 corpusCount) {
+    text::Builder builder = {};
+    if (!text::init(&builder)) return false;
+
+    text::line(&builder, "{");
+    text::linef(&builder, "    \"threads\": %u,", gPool.workerCount + 1);
+    text::linef(&builder, "    \"searchRectLimit\": %u,", pack::SEARCH_RECT_LIMIT);
+    text::line(&builder, "    \"corpora\": [");
+
+    for (u32 c = 0; c < corpusCount; c++) {
+        const CorpusRun* corpus = &corpora[c];
+
+        // Totals sum up the kinds, peak memory is the highest seen
+        StageResult totals[as_index(Stage::COUNT)] = {};
+        for (u32 k = 0; k < as_index(CorpusKind::COUNT); k++) {
+            for (u32 stage = 0; stage < as_index(Stage::COUNT); stage++) {
+                const StageResult* result = &corpus->kinds[k].stages[stage];
+                totals[stage].ms += result->ms;
+                totals[stage].itemCount += result->itemCount;
+                totals[stage].byteCount += result->byteCount;
+                if (result->peakMemory > totals[stage].peakMemory) totals[stage].peakMemory = result->peakMemory;
+            }
+        }
+
+        text::line(&builder, "        {");
+        text::linef(&builder, "            \"images\": %u,", corpus->imageCount);
+        text::linef(&builder, "            \"complete\": %s,", corpus->isComplete ? "true" : "false");
+        text::line(&builder, "            \"kinds\": [");
+
+        for (u32 k = 0; k < as_index(CorpusKind::COUNT); k++) {
+            const KindRun* run = &corpus->kinds[k];
+            const char* packMode = (run->kind != CorpusKind::SPRITE) ? "grid" : pack::get_heuristic_name(run->heuristic);
+
+            text::line(&builder, "                {");
+            text::linef(&builder, "                    \"kind\": \"%s\",", gCorpusKindNames[k]);
+            text::linef(&builder, "                    \"images\": %u,", run->expectedCount);
+            text::linef(&builder, "                    \"atlasWidth\": %i,", run->atlasSize.w);
+            text::linef(&builder, "                    \"atlasHeight\": %i,", run->atlasSize.h);
+            text::linef(&builder, "                    \"pack\": \"%s\",", packMode);
+            text::linef(&builder, "                    \"encodedBytes\": %llu,", (unsigned long long)run->encodedSize);
+            text::line(&builder, "                    \"stages\": {");
+            for (u32 stage = 0; stage < as_index(Stage::COUNT); stage++) {
+                bench_append_stage_json(&builder, "                        ", gStageNames[stage], &run->stages[stage], stage + 1 == as_index(Stage::COUNT));
+            }
+            text::line(&builder, "                    }");
+            text::linef(&builder, "                }%s", k + 1 == as_index(CorpusKind::COUNT) ? "" : ",");
+        }
+
+        text::line(&builder, "            ],");
+        text::line(&builder, "            \"totals\": {");
+        for (u32 stage = 0; stage < as_index(Stage::COUNT); stage++) {
+            bench_append_stage_json(&builder, "                ", gStageNames[stage], &totals[stage], stage + 1 == as_index(Stage::COUNT));
+        }
+        text::line(&builder, "            }");
+        text::linef(&builder, "        }%s", c + 1 == corpusCount ? "" : ",");
+    }
+
+    text::line(&builder, "    ]");
+    text::line(&builder, "}");
+
+    bool success = text::write_if_changed(&builder, path);
+    text::release(&builder);
+    return success;
+}
+
+// -- Suites
+// Usage: forge_bench --kernels [atlas.png ...] | Without any atlases a synthetic 4096x4096 one is used for the png stage
+i32 bench_run_kernels(i32 pathCount, char** paths) {
+    bool isIdentical = true;
+
+    log_format(ANSI_CYAN "[BLIT] " ANSI_RESET "Averaged over %u runs", BENCH_REPEAT_COUNT);
+
+    BenchResult gridResult = bench_grid_tiles(4096);
+    bench_print_result("16px tiles (4096 x 16)", gridResult);
+
+    BenchResult spriteResult = bench_best_fit_sprites(64);
+    bench_print_result("512px sprites (64)", spriteResult);
+
+    if (!gridResult.isIdentical || !spriteResult.isIdentical) {
+        log_format(LOG_PREFIX_WARN "BLIT > Kernel output doesn't match the reference loops!");
+        isIdentical = false;
+    }
+
+    log_format(ANSI_CYAN "[PNG] " ANSI_RESET "Averaged over %u runs, %u threads", BENCH_PNG_REPEAT_COUNT, gPool.workerCount + 1);
+
+    BenchPngResult pngResult = {};
+    if (pathCount > 0) {
+        for (i32 i = 0; i < pathCount; i++) {
+            BenchImage atlas = {};
+            i32 channels = 0;
+            atlas.data = stbi_load(paths[i], &atlas.width, &atlas.height, &channels, 4);
+            if (!atlas.data) {
+                log_format(LOG_PREFIX_WARN "PNG > Failed to load " ANSI_GREEN "'%s'" ANSI_RESET, paths[i]);
+                continue;
+            }
+
+            pngResult = bench_png_encode(&atlas);
+            bench_print_png_result(paths[i], &pngResult);
+            stbi_image_free(atlas.data);
+
+            for (u32 level = 0; level < as_index(png::Level::COUNT); level++) isIdentical &= pngResult.isIdentical[level];
+        }
+    } else {
+        BenchImage atlas = bench_create_atlas_image(4096, 4096);
+        pngResult = bench_png_encode(&atlas);
+        bench_print_png_result("synthetic (4096x4096)", &pngResult);
+        memory::free(atlas.data);
+
+        for (u32 level = 0; level < as_index(png::Level::COUNT); level++) isIdentical &= pngResult.isIdentical[level];
+    }
+
+    if (!isIdentical) {
+        log_format(LOG_PREFIX_WARN "BENCH > Output doesn't round trip!");
+    }
+
+    return isIdentical ? 0 : 1;
+}
+
+// Usage: forge_bench [--sizes 100,1000,10000,100000] [--out forge_bench.json] [--keep]
+i32 bench_run_corpora(i32 argCount, char** args) {
+    u32 sizes[BENCH_MAX_CORPUS_COUNT] = { 100, 1000, 10000, 100000 };
+    u32 sizeCount = 4;
+    const char* outputPath = BENCH_DEFAULT_OUTPUT_PATH;
+    bool keepCorpora = false;
+
+    for (i32 i = 0; i < argCount; i++) {
+        if (strcmp(args[i], "--sizes") == 0 && i + 1 < argCount) {
+            sizeCount = 0;
+
+            const char* cursor = args[++i];
+            while (*cursor && sizeCount < BENCH_MAX_CORPUS_COUNT) {
+                char* end = NULL;
+                u32 size = (u32)strtoul(cursor, &end, 10);
+                if (end == cursor) break;
+                if (size > 0) sizes[sizeCount++] = size;
+
+                cursor = (*end == ',') ? end + 1 : end;
+            }
+        } else if (strcmp(args[i], "--out") == 0 && i + 1 < argCount) {
+            outputPath = args[++i];
+        } else if (strcmp(args[i], "--keep") == 0) {
+            keepCorpora = true;
+        } else {
+            log_format(LOG_PREFIX_WARN "BENCH > Unknown argument " ANSI_GREEN "'%s'" ANSI_RESET, args[i]);
+            return 1;
+        }
+    }
+
+    if (sizeCount == 0) {
+        log_format(LOG_PREFIX_WARN "BENCH > No corpus sizes given!");
+        return 1;
+    }
+
+    CorpusRun* corpora = (CorpusRun*)memory::alloc(sizeof(CorpusRun) * sizeCount);
+    bool success = true;
+
+    gSampler.isRunning = true;
+    gSampler.thread = thread::create(bench_sample_memory, &gSampler);
+
+    for (u32 i = 0; i < sizeCount; i++) {
+        CorpusRun* corpus = &corpora[i];
+        if (!bench_create_corpus(corpus, sizes[i])) {
+            success = false;
+            break;
+        }
+
+        corpus->isComplete = true;
+        for (u32 k = 0; k < as_index(CorpusKind::COUNT); k++) {
+            corpus->isComplete &= bench_run_kind(&corpus->kinds[k]);
+            bench_print_kind(&corpus->kinds[k]);
+        }
+        success &= corpus->isComplete;
+
+        if (!keepCorpora) bench_remove_corpus(corpus);
+    }
+
+    gSampler.isRunning = false;
+    thread::join(&gSampler.thread);
+
+    if (!keepCorpora) RemoveDirectoryA(BENCH_CORPUS_PATH);
+
+    if (bench_write_json(outputPath, corpora, sizeCount)) {
+        log_format("- Results written to " ANSI_GREEN "'%s'" ANSI_RESET, outputPath);
+    } else {
+        log_format(LOG_PREFIX_WARN "BENCH > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, outputPath);
+        success = false;
+    }
+
+    memory::free(corpora);
+    return success ? 0 : 1;
+}
+
+// -------------------------------------------
+// Forge Benchmark Entry
+// -------------------------------------------
+
+// Usage: forge_bench [--sizes ...] [--out ...] [--keep] | forge_bench --kernels [atlas.png ...]
+i32 main(int argc, char* argv[]) {
+    if (!thread::pool_create(&gPool, thread::get_core_count() - 1)) {
+        log_format(LOG_PREFIX_WARN "BENCH > Failed to create thread pool!");
+        return 1;
+    }
+
+    i32 exitCode = 0;
+    if (argc > 1 && strcmp(argv[1], "--kernels") == 0) {
+        exitCode = bench_run_kernels(argc - 2, argv + 2);
+    } else {
+        exitCode = bench_run_corpora(argc - 1, argv + 1);
+    }
+
+    thread::pool_destroy(&gPool);
+    return exitCode;
+}
@@ -0,0 +1,210 @@
+#include "pch.hpp"
+
+#include "forge/blit.hpp"
+
+#include "GEM/core/memory.hpp"
+
+#include <emmintrin.h>
+
+namespace blit {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // NOTE: SSE2 is part of the x64 baseline, so no runtime dispatch is needed.
+    //       Longer rows go through memcpy instead, the CRT already picks the widest vector path available.
+    static inline void copy_row_16px(u8* dest, const u8* src) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src +  0));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+
+        _mm_storeu_si128((__m128i*)(dest +  0), a);
+        _mm_storeu_si128((__m128i*)(dest + 16), b);
+        _mm_storeu_si128((__m128i*)(dest + 32), c);
+        _mm_storeu_si128((__m128i*)(dest + 48), d);
+    }
+
+    static inline void copy_row_8px(u8* dest, const u8* src) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src +  0));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+
+        _mm_storeu_si128((__m128i*)(dest +  0), a);
+        _mm_storeu_si128((__m128i*)(dest + 16), b);
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    void rect(u8* dest, i32 destStride, const u8* src, i32 srcStride, i32 width, i32 height) {
+        if (width <= 0 || height <= 0) return;
+
+        u64 rowBytes = (u64)width * BYTES_PER_PIXEL;
+        u64 destPitch = (u64)destStride * BYTES_PER_PIXEL;
+        u64 srcPitch = (u64)srcStride * BYTES_PER_PIXEL;
+
+        // Both sides are contiguous, copy everything at once
+        if (destStride == width && srcStride == width) {
+            memcpy(dest, src, rowBytes * height);
+            return;
+        }
+
+        switch (width) {
+            case 16:
+                for (i32 y = 0; y < height; y++) {
+                    copy_row_16px(dest, src);
+                    dest += destPitch;
+                    src += srcPitch;
+                }
+                break;
+            case 8:
+                for (i32 y = 0; y < height; y++) {
+                    copy_row_8px(dest, src);
+                    dest += destPitch;
+                    src += srcPitch;
+                }
+                break;
+            default:
+                for (i32 y = 0; y < height; y++) {
+                    memcpy(dest, src, rowBytes);
+                    dest += destPitch;
+                    src += srcPitch;
+                }
+                break;
+        }
+    }
+
+    void rect_rotated(u8* dest, i32 destStride, const u8* src, i32 srcStride, i32 width, i32 height) {
+        if (width <= 0 || height <= 0) return;
+
+        // Source columns become destination rows, walking small tiles keeps both sides in cache
+        const i32 tileSize = 16;
+
+        for (i32 tileY = 0; tileY < width; tileY += tileSize) {
+            i32 endY = (tileY + tileSize < width) ? tileY + tileSize : width;
+
+            for (i32 tileX = 0; tileX < height; tileX += tileSize) {
+                i32 endX = (tileX + tileSize < height) ? tileX + tileSize : height;
+
+                for (i32 y = tileY; y < endY; y++) {
+                    u8* destRow = dest + (u64)y * destStride * BYTES_PER_PIXEL;
+
+                    for (i32 x = tileX; x < endX; x++) {
+                        const u8* srcPixel = src + ((u64)(height - 1 - x) * srcStride + y) * BYTES_PER_PIXEL;
+                        memcpy(destRow + (u64)x * BYTES_PER_PIXEL, srcPixel, BYTES_PER_PIXEL);
+                    }
+                }
+            }
+        }
+    }
+
+    void clear(u8* dest, i32 destStride, i32 width, i32 height) {
+        if (width <= 0 || height <= 0) return;
+
+        for (i32 y = 0; y < height; y++) {
+            memset(dest + (u64)y * destStride * BYTES_PER_PIXEL, 0, (u64)width * BYTES_PER_PIXEL);
+        }
+    }
+
+    void extrude(u8* dest, i32 destStride, i32 width, i32 height, i32 padding) {
+        if (width <= 0 || height <= 0 || padding <= 0) return;
+
+        u64 pitch = (u64)destStride * BYTES_PER_PIXEL;
+
+        // Left & right columns of every image row
+        for (i32 y = 0; y < height; y++) {
+            u8* row = dest + y * pitch;
+            u32 left, right;
+            memcpy(&left, row, sizeof(u32));
+            memcpy(&right, row + (u64)(width - 1) * BYTES_PER_PIXEL, sizeof(u32));
+
+            for (i32 p = 1; p <= padding; p++) {
+                memcpy(row - (i64)p * BYTES_PER_PIXEL, &left, sizeof(u32));
+                memcpy(row + (u64)(width - 1 + p) * BYTES_PER_PIXEL, &right, sizeof(u32));
+            }
+        }
+
+        // Top & bottom rows, widened by the columns above so the corners get filled too
+        u64 rowBytes = (u64)(width + padding * 2) * BYTES_PER_PIXEL;
+        u8* top = dest - (u64)padding * BYTES_PER_PIXEL;
+        u8* bottom = top + (height - 1) * pitch;
+
+        for (i32 p = 1; p <= padding; p++) {
+            memcpy(top - p * pitch, top, rowBytes);
+            memcpy(bottom + p * pitch, bottom, rowBytes);
+        }
+    }
+
+    void bleed(u8* dest, i32 destStride, i32 width, i32 height, u32 maxPassCount) {
+        if (width <= 0 || height <= 0 || maxPassCount == 0) return;
+
+        // Pass in which a pixel got its colour, 0 = not yet, 1 = visible from the start
+        u64 pixelCount = (u64)width * height;
+        u16* filledPass = (u16*)memory::alloc(sizeof(u16) * pixelCount);
+
+        u64 visibleCount = 0;
+        for (i32 y = 0; y < height; y++) {
+            const u8* row = dest + (u64)y * destStride * BYTES_PER_PIXEL;
+
+            for (i32 x = 0; x < width; x++) {
+                if (row[x * BYTES_PER_PIXEL + 3] != 0) {
+                    filledPass[(u64)y * width + x] = 1;
+                    visibleCount++;
+                }
+            }
+        }
+
+        // Nothing to grow from, or nothing to grow into
+        if (visibleCount == 0 || visibleCount == pixelCount) {
+            memory::free(filledPass);
+            return;
+        }
+
+        for (u32 pass = 1; pass <= maxPassCount && pass < UINT16_MAX; pass++) {
+            bool hasChanged = false;
+
+            for (i32 y = 0; y < height; y++) {
+                u8* row = dest + (u64)y * destStride * BYTES_PER_PIXEL;
+
+                for (i32 x = 0; x < width; x++) {
+                    if (filledPass[(u64)y * width + x] != 0) continue;
+
+                    // Average of the neighbours filled in an earlier pass
+                    u32 sum[3] = {};
+                    u32 count = 0;
+
+                    for (i32 ny = y - 1; ny <= y + 1; ny++) {
+                        if (ny < 0 || ny >= height) continue;
+
+                        for (i32 nx = x - 1; nx <= x + 1; nx++) {
+                            if (nx < 0 || nx >= width) continue;
+
+                            u16 neighbourPass = filledPass[(u64)ny * width + nx];
+                            if (neighbourPass == 0 || neighbourPass > pass) continue;
+
+                            const u8* neighbour = dest + ((u64)ny * destStride + nx) * BYTES_PER_PIXEL;
+                            sum[0] += neighbour[0];
+                            sum[1] += neighbour[1];
+                            sum[2] += neighbour[2];
+                            count++;
+                        }
+                    }
+
+                    if (count == 0) continue;
+
+                    u8* pixel = row + x * BYTES_PER_PIXEL;
+                    pixel[0] = (u8)(sum[0] / count);
+                    pixel[1] = (u8)(sum[1] / count);
+                    pixel[2] = (u8)(sum[2] / count);
+                    filledPass[(u64)y * width + x] = (u16)(pass + 1);
+                    hasChanged = true;
+                }
+            }
+
+            if (!hasChanged) break;
+        }
+
+        memory::free(filledPass);
+    }
+}
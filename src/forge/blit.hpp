@@ -0,0 +1,29 @@
+#pragma once
+
+#include "pch.hpp"
+
+// -------------------------------------------
+// Pixel Blitting
+// -------------------------------------------
+// All kernels operate on tightly packed RGBA8 pixels, strides are given in pixels.
+
+namespace blit {
+    const u32 BYTES_PER_PIXEL = 4;
+
+    // Copies a width x height block, row by row
+    // NOTE: 8px & 16px wide blocks (grid tiles) use unrolled SSE2 rows, everything else goes through memcpy.
+    void rect(u8* dest, i32 destStride, const u8* src, i32 srcStride, i32 width, i32 height);
+
+    // Copies a width x height block turned 90 degrees clockwise, the destination is height x width
+    void rect_rotated(u8* dest, i32 destStride, const u8* src, i32 srcStride, i32 width, i32 height);
+
+    // Zeroes a width x height block
+    void clear(u8* dest, i32 destStride, i32 width, i32 height);
+
+    // Repeats the outermost pixels of a width x height block 'padding' pixels outwards, the band around it must be writable
+    void extrude(u8* dest, i32 destStride, i32 width, i32 height, i32 padding);
+
+    // Grows the colour of visible pixels into fully transparent ones (alpha stays 0), one pixel ring per pass.
+    // Keeps bilinear sampling & mip levels from pulling black fringes in around sprite edges.
+    void bleed(u8* dest, i32 destStride, i32 width, i32 height, u32 maxPassCount);
+}
@@ -0,0 +1,56 @@
+#ifndef FORGE_ARCHIVE_H
+#define FORGE_ARCHIVE_H
+
+// -------------------------------------------
+// Resource Archive Layout
+// -------------------------------------------
+// [ ArchiveHeader | ArchiveEntry * entryCount | padding | data... ]
+// Every data block starts at a multiple of 'alignment', so the archive can be mapped and used in place.
+
+#define ARCHIVE_MAGIC     0x4B415047 // "GPAK"
+#define ARCHIVE_VERSION   4
+#define ARCHIVE_ALIGNMENT 4096
+
+enum class ArchiveFormat : u32 {
+    RAW = 0,      // Unprocessed file contents
+    RGBA8,        // Tightly packed atlas pixels, see 'image'
+    PCM,          // Interleaved signed 16-bit samples at the mix rate, see 'audio'
+    FONT,         // Compiled glyph table, see 'forge/component/font.hpp'
+    OGG,          // Vorbis stream, decoded at runtime
+    PCM_F32,      // Interleaved float samples at the mix rate
+    IMA_ADPCM,    // Blocks of AUDIO_ADPCM_BLOCK_SIZE bytes per channel, see 'forge/component/audio.hpp'
+    COUNT,
+};
+
+struct ArchiveHeader {
+    u32 magic;
+    u32 version;
+    u32 alignment;
+    u32 entryCount;
+    u64 totalSize;
+};
+
+struct ArchiveEntry {
+    u32 assetType; // Matches the order of the forge asset types (sprite, tilemap, particle, font, sound, music, atlas)
+    u32 assetId;   // Matches the generated enum value of the asset, e.g. SND_*
+    ArchiveFormat format;
+    u32 reserved;
+
+    u64 offset;
+    u64 size;
+
+    union {
+        struct {
+            u32 width;
+            u32 height;
+            u32 layerCount; // Atlas pages, stored one after another
+        } image;
+        struct {
+            u32 sampleRate;
+            u16 channelCount;
+            u16 bitsPerSample;
+        } audio;
+    };
+};
+
+#endif // FORGE_ARCHIVE_H
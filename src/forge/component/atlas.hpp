@@ -27,4 +27,12 @@ enum class AtlasPriority {
     COUNT,
 };
 
+enum class AtlasMipFilter {
+    BOX = 0, // 2x2 average, cheapest
+    KAISER,  // Kaiser-windowed sinc, keeps small details sharper
+    COUNT,
+};
+
+#define ATLAS_MIP_FULL_CHAIN 0xFFFFFFFF // Every level down to 1x1
+
 #endif // FORGE_ATLAS_H
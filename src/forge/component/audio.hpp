@@ -0,0 +1,39 @@
+#ifndef FORGE_AUDIO_H
+#define FORGE_AUDIO_H
+
+// -------------------------------------------
+// Processed Sound Layout
+// -------------------------------------------
+// [ AudioHeader | samples... ]
+// Samples are interleaved & already at the engine mix rate, so a sound can be mapped and played in place.
+
+#define AUDIO_MAGIC    0x444E5347 // "GSND"
+#define AUDIO_VERSION  1
+#define AUDIO_MIX_RATE 48000
+
+// IMA ADPCM blocks (Microsoft layout), every channel starts with { i16 sample, u8 stepIndex, u8 0 }
+// followed by groups of 4 bytes (8 samples, low nibble first) interleaved per channel.
+#define AUDIO_ADPCM_BLOCK_SIZE   1024 // Bytes per channel
+#define AUDIO_ADPCM_BLOCK_FRAMES 2041 // (AUDIO_ADPCM_BLOCK_SIZE - 4) * 2 + 1, the header holds the first sample
+
+enum class AudioFormat : u32 {
+    S16 = 0,   // Signed 16-bit integer
+    F32,       // 32-bit float in [-1, 1]
+    IMA_ADPCM, // 4 bits per sample, ~3.6x smaller than S16
+    COUNT,
+};
+
+struct AudioHeader {
+    u32 magic;
+    u32 version;
+    AudioFormat format;
+    u32 sampleRate;
+
+    u32 channelCount;
+    u32 dataOffset; // From the start of the file
+    u64 dataSize;
+
+    u64 sampleCount; // Per channel
+};
+
+#endif // FORGE_AUDIO_H
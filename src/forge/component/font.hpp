@@ -0,0 +1,91 @@
+#ifndef FORGE_FONT_H
+#define FORGE_FONT_H
+
+// -------------------------------------------
+// Compiled Font Layout
+// -------------------------------------------
+// [ FontHeader | u16 * blockCount | u16 * FONT_BLOCK_SIZE * usedBlockCount | Glyph * glyphCount | GlyphKerning * kerningCount ]
+// Codepoints are split into blocks of FONT_BLOCK_SIZE, only blocks that hold at least one glyph are stored.
+// A lookup is two array reads, the block index picks the block and the block picks the glyph.
+
+#define FONT_MAGIC      0x544E4647 // "GFNT"
+#define FONT_VERSION    1
+#define FONT_BLOCK_SIZE 256
+#define FONT_NONE       0xFFFF     // Empty block or missing glyph
+
+struct Glyph {
+    u16 x;             // Position of the glyph in the font's image (0 is the top left point)
+    u16 y;
+    u16 width;         // Size of the glyph in the font's image
+    u16 height;
+    i16 offsetX;       // Offset when drawing the glyph to the screen
+    i16 offsetY;
+    i16 advanceX;      // Number of pixels to advance for when drawing the next glyph
+    u16 kerningCount;  // Pairs that start with this glyph, sorted by their second codepoint
+    u32 kerningIndex;
+};
+
+struct GlyphKerning {
+    u32 second; // Codepoint
+    i16 amount;
+    u16 reserved;
+};
+
+struct FontHeader {
+    u32 magic;
+    u32 version;
+
+    u16 lineHeight;
+    u16 baseLine;
+    u8 paddingUp;
+    u8 paddingRight;
+    u8 paddingDown;
+    u8 paddingLeft;
+
+    u32 blockCount;     // Covers every codepoint up to the highest glyph
+    u32 usedBlockCount;
+    u32 glyphCount;
+    u32 kerningCount;
+
+    // From the start of the header
+    u32 blockIndexOffset;
+    u32 blockOffset;
+    u32 glyphOffset;
+    u32 kerningOffset;
+};
+
+inline const Glyph* font_get_glyph(const FontHeader* font, u32 codepoint) {
+    const u8* base = (const u8*)font;
+
+    u32 block = codepoint / FONT_BLOCK_SIZE;
+    if (block >= font->blockCount) return NULL;
+
+    u16 blockIdx = ((const u16*)(base + font->blockIndexOffset))[block];
+    if (blockIdx == FONT_NONE) return NULL;
+
+    u16 glyphIdx = ((const u16*)(base + font->blockOffset))[(u32)blockIdx * FONT_BLOCK_SIZE + codepoint % FONT_BLOCK_SIZE];
+    if (glyphIdx == FONT_NONE) return NULL;
+
+    return (const Glyph*)(base + font->glyphOffset) + glyphIdx;
+}
+
+inline i32 font_get_kerning(const FontHeader* font, const Glyph* first, u32 second) {
+    const GlyphKerning* pairs = (const GlyphKerning*)((const u8*)font + font->kerningOffset) + first->kerningIndex;
+
+    u32 low = 0;
+    u32 high = first->kerningCount;
+    while (low < high) {
+        u32 mid = (low + high) / 2;
+        if (pairs[mid].second == second) return pairs[mid].amount;
+
+        if (pairs[mid].second < second) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return 0;
+}
+
+#endif // FORGE_FONT_H
@@ -0,0 +1,48 @@
+#ifndef FORGE_LOOKUP_H
+#define FORGE_LOOKUP_H
+
+// -------------------------------------------
+// Asset Name Lookup
+// -------------------------------------------
+// Minimal perfect hash from an asset's base name to its enum value (hash & displace).
+// Names are spread over buckets by a first hash, forge then picks a seed per bucket so every name gets a slot of its own.
+// A lookup hashes twice and compares one string, everything is constexpr so names can be resolved at compile time.
+
+#define LOOKUP_DIRECT_SLOT 0x80000000 // Buckets with a single name store its slot instead of a seed
+
+constexpr u32 lookup_hash(const char* str, u32 seed) {
+    // FNV-1a, with a murmur finalizer since plain FNV-1a leaves the low bits poorly mixed for small tables
+    u32 hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (; *str != '\0'; str++) {
+        hash ^= (u8)*str;
+        hash *= 16777619u;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+constexpr bool lookup_equals(const char* a, const char* b) {
+    for (; *a != '\0' && *a == *b; a++, b++) {}
+    return *a == *b;
+}
+
+template <typename T, u32 N>
+struct NameTable {
+    u32 seeds[N];         // Per bucket
+    const char* names[N]; // Per slot
+    T values[N];          // Per slot
+
+    constexpr T find(const char* name, T notFound) const {
+        u32 seed = seeds[lookup_hash(name, 0) % N];
+        u32 slot = (seed & LOOKUP_DIRECT_SLOT) ? (seed & ~LOOKUP_DIRECT_SLOT) : lookup_hash(name, seed) % N;
+
+        return lookup_equals(names[slot], name) ? values[slot] : notFound;
+    }
+};
+
+#endif // FORGE_LOOKUP_H
@@ -0,0 +1,386 @@
+#include "pch.hpp"
+
+#include "forge/font.hpp"
+
+#include "GEM/core/memory.hpp"
+
+namespace font {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Reference: AngelCode BMFont file format (binary version 3 & text)
+    static const u32 BINARY_CHAR_SIZE = 20;
+    static const u32 BINARY_KERNING_SIZE = 10;
+
+    enum class BinaryBlock : u8 {
+        INFO = 1,
+        COMMON,
+        PAGES,
+        CHARS,
+        KERNING_PAIRS,
+    };
+
+    struct SortedGlyph {
+        u32 codepoint;
+        u32 index; // Into the description
+    };
+
+    struct SortedKerning {
+        u32 glyph; // Into the compiled glyphs
+        u32 second;
+        i16 amount;
+    };
+
+    static i32 sorted_glyph_compare(const void* a, const void* b) {
+        const SortedGlyph* glyphA = (const SortedGlyph*)a;
+        const SortedGlyph* glyphB = (const SortedGlyph*)b;
+
+        if (glyphA->codepoint != glyphB->codepoint) return (glyphA->codepoint > glyphB->codepoint) ? 1 : -1;
+        return (glyphA->index > glyphB->index) ? 1 : -1;
+    }
+
+    static i32 sorted_kerning_compare(const void* a, const void* b) {
+        const SortedKerning* pairA = (const SortedKerning*)a;
+        const SortedKerning* pairB = (const SortedKerning*)b;
+
+        if (pairA->glyph != pairB->glyph) return (pairA->glyph > pairB->glyph) ? 1 : -1;
+        if (pairA->second != pairB->second) return (pairA->second > pairB->second) ? 1 : -1;
+        return 0;
+    }
+
+    static inline u32 align4(u32 value) {
+        return (value + 3) & ~3u;
+    }
+
+    static inline u16 read_u16(const u8* ptr) {
+        u16 value;
+        memcpy(&value, ptr, sizeof(u16));
+        return value;
+    }
+
+    static inline i16 read_i16(const u8* ptr) {
+        i16 value;
+        memcpy(&value, ptr, sizeof(i16));
+        return value;
+    }
+
+    static inline u32 read_u32(const u8* ptr) {
+        u32 value;
+        memcpy(&value, ptr, sizeof(u32));
+        return value;
+    }
+
+    static bool parse_binary(const u8* data, u64 size, Description* desc) {
+        if (size < 4 || data[3] != 3) return false;
+
+        u64 offset = 4;
+        while (offset + 5 <= size) {
+            BinaryBlock type = (BinaryBlock)data[offset];
+            u32 blockSize = read_u32(data + offset + 1);
+            const u8* block = data + offset + 5;
+
+            if (offset + 5 + blockSize > size) return false;
+
+            switch (type) {
+                case BinaryBlock::INFO:
+                    {
+                        if (blockSize < 14) return false;
+                        memcpy(desc->padding, block + 7, sizeof(desc->padding));
+                    }
+                    break;
+                case BinaryBlock::COMMON:
+                    {
+                        if (blockSize < 10) return false;
+                        desc->lineHeight = read_u16(block + 0);
+                        desc->baseLine = read_u16(block + 2);
+                        desc->pageCount = read_u16(block + 8);
+                    }
+                    break;
+                case BinaryBlock::CHARS:
+                    {
+                        if (desc->glyphs) return false;
+
+                        desc->glyphCount = blockSize / BINARY_CHAR_SIZE;
+                        desc->codepoints = (u32*)memory::alloc(sizeof(u32) * (desc->glyphCount > 0 ? desc->glyphCount : 1));
+                        desc->glyphs = (Glyph*)memory::alloc(sizeof(Glyph) * (desc->glyphCount > 0 ? desc->glyphCount : 1));
+
+                        for (u32 i = 0; i < desc->glyphCount; i++) {
+                            const u8* entry = block + i * BINARY_CHAR_SIZE;
+                            Glyph* glyph = &desc->glyphs[i];
+
+                            desc->codepoints[i] = read_u32(entry + 0);
+                            glyph->x = read_u16(entry + 4);
+                            glyph->y = read_u16(entry + 6);
+                            glyph->width = read_u16(entry + 8);
+                            glyph->height = read_u16(entry + 10);
+                            glyph->offsetX = read_i16(entry + 12);
+                            glyph->offsetY = read_i16(entry + 14);
+                            glyph->advanceX = read_i16(entry + 16);
+                        }
+                    }
+                    break;
+                case BinaryBlock::KERNING_PAIRS:
+                    {
+                        if (desc->kernings) return false;
+
+                        desc->kerningCount = blockSize / BINARY_KERNING_SIZE;
+                        desc->kernings = (Kerning*)memory::alloc(sizeof(Kerning) * (desc->kerningCount > 0 ? desc->kerningCount : 1));
+
+                        for (u32 i = 0; i < desc->kerningCount; i++) {
+                            const u8* entry = block + i * BINARY_KERNING_SIZE;
+
+                            desc->kernings[i].first = read_u32(entry + 0);
+                            desc->kernings[i].second = read_u32(entry + 4);
+                            desc->kernings[i].amount = read_i16(entry + 8);
+                        }
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            offset += 5 + (u64)blockSize;
+        }
+
+        return desc->glyphs != NULL;
+    }
+
+    // Value of 'key=' within a line, NULL if the line doesn't have the key
+    static const char* find_value(const char* line, const char* lineEnd, const char* key) {
+        u64 keyLength = strlen(key);
+
+        for (const char* ptr = line; ptr + keyLength < lineEnd; ptr++) {
+            bool isTokenStart = (ptr == line || ptr[-1] == ' ' || ptr[-1] == '\t');
+            if (isTokenStart && memcmp(ptr, key, keyLength) == 0 && ptr[keyLength] == '=') return ptr + keyLength + 1;
+        }
+
+        return NULL;
+    }
+
+    // Bounded by the line, the mapped file has no terminator that would stop 'strtol' at the end of the data
+    static i32 parse_int(const char* value, const char* lineEnd, const char** outNext) {
+        bool isNegative = value < lineEnd && *value == '-';
+        if (isNegative || (value < lineEnd && *value == '+')) value++;
+
+        i64 result = 0;
+        for (; value < lineEnd && *value >= '0' && *value <= '9'; value++) {
+            if (result <= INT32_MAX) result = result * 10 + (*value - '0');
+        }
+
+        if (outNext) *outNext = value;
+        if (result > INT32_MAX) return isNegative ? INT32_MIN : INT32_MAX;
+        return (i32)(isNegative ? -result : result);
+    }
+
+    static i32 find_int(const char* line, const char* lineEnd, const char* key) {
+        const char* value = find_value(line, lineEnd, key);
+        return value ? parse_int(value, lineEnd, NULL) : 0;
+    }
+
+    static bool starts_with(const char* line, const char* lineEnd, const char* tag) {
+        u64 tagLength = strlen(tag);
+        return (u64)(lineEnd - line) > tagLength && memcmp(line, tag, tagLength) == 0 && (line[tagLength] == ' ' || line[tagLength] == '\t');
+    }
+
+    static bool parse_text(const char* data, u64 size, Description* desc) {
+        const char* end = data + size;
+
+        // Count first, so the glyphs & pairs fit in a single block each
+        u32 glyphCapacity = 0;
+        u32 kerningCapacity = 0;
+        for (const char* line = data; line < end;) {
+            const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+            if (!lineEnd) lineEnd = end;
+
+            if (starts_with(line, lineEnd, "char")) glyphCapacity++;
+            if (starts_with(line, lineEnd, "kerning")) kerningCapacity++;
+
+            line = lineEnd + 1;
+        }
+
+        desc->codepoints = (u32*)memory::alloc(sizeof(u32) * (glyphCapacity > 0 ? glyphCapacity : 1));
+        desc->glyphs = (Glyph*)memory::alloc(sizeof(Glyph) * (glyphCapacity > 0 ? glyphCapacity : 1));
+        desc->kernings = (Kerning*)memory::alloc(sizeof(Kerning) * (kerningCapacity > 0 ? kerningCapacity : 1));
+
+        for (const char* line = data; line < end;) {
+            const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+            if (!lineEnd) lineEnd = end;
+
+            if (starts_with(line, lineEnd, "info")) {
+                const char* value = find_value(line, lineEnd, "padding");
+                for (u32 i = 0; value && i < 4; i++) {
+                    const char* next = NULL;
+                    desc->padding[i] = (u8)parse_int(value, lineEnd, &next);
+                    value = (next < lineEnd && *next == ',') ? next + 1 : NULL;
+                }
+            } else if (starts_with(line, lineEnd, "common")) {
+                desc->lineHeight = (u16)find_int(line, lineEnd, "lineHeight");
+                desc->baseLine = (u16)find_int(line, lineEnd, "base");
+                desc->pageCount = (u32)find_int(line, lineEnd, "pages");
+            } else if (starts_with(line, lineEnd, "char")) {
+                Glyph* glyph = &desc->glyphs[desc->glyphCount];
+
+                desc->codepoints[desc->glyphCount] = (u32)find_int(line, lineEnd, "id");
+                glyph->x = (u16)find_int(line, lineEnd, "x");
+                glyph->y = (u16)find_int(line, lineEnd, "y");
+                glyph->width = (u16)find_int(line, lineEnd, "width");
+                glyph->height = (u16)find_int(line, lineEnd, "height");
+                glyph->offsetX = (i16)find_int(line, lineEnd, "xoffset");
+                glyph->offsetY = (i16)find_int(line, lineEnd, "yoffset");
+                glyph->advanceX = (i16)find_int(line, lineEnd, "xadvance");
+                desc->glyphCount++;
+            } else if (starts_with(line, lineEnd, "kerning")) {
+                Kerning* pair = &desc->kernings[desc->kerningCount];
+
+                pair->first = (u32)find_int(line, lineEnd, "first");
+                pair->second = (u32)find_int(line, lineEnd, "second");
+                pair->amount = (i16)find_int(line, lineEnd, "amount");
+                desc->kerningCount++;
+            }
+
+            line = lineEnd + 1;
+        }
+
+        return desc->glyphCount > 0;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool parse_bmfont(const u8* data, u64 size, Description* outDesc) {
+        memory::zero(outDesc, sizeof(Description));
+
+        bool success = false;
+        if (size >= 4 && memcmp(data, "BMF", 3) == 0) {
+            success = parse_binary(data, size, outDesc);
+        } else {
+            success = parse_text((const char*)data, size, outDesc);
+        }
+
+        if (!success) release(outDesc);
+        return success;
+    }
+
+    void release(Description* desc) {
+        if (desc->codepoints) memory::free(desc->codepoints);
+        if (desc->glyphs) memory::free(desc->glyphs);
+        if (desc->kernings) memory::free(desc->kernings);
+
+        memory::zero(desc, sizeof(Description));
+    }
+
+    u8* compile(const Description* desc, u64* outSize) {
+        // Glyph indices are u16 with FONT_NONE reserved
+        if (desc->glyphCount >= FONT_NONE) return NULL;
+
+        // Order by codepoint, repeated codepoints keep their first glyph
+        SortedGlyph* sorted = (SortedGlyph*)memory::alloc(sizeof(SortedGlyph) * (desc->glyphCount > 0 ? desc->glyphCount : 1));
+        for (u32 i = 0; i < desc->glyphCount; i++) {
+            sorted[i].codepoint = desc->codepoints[i];
+            sorted[i].index = i;
+        }
+        qsort(sorted, desc->glyphCount, sizeof(SortedGlyph), sorted_glyph_compare);
+
+        u32 glyphCount = 0;
+        for (u32 i = 0; i < desc->glyphCount; i++) {
+            if (glyphCount > 0 && sorted[glyphCount - 1].codepoint == sorted[i].codepoint) continue;
+            sorted[glyphCount++] = sorted[i];
+        }
+
+        u32 blockCount = (glyphCount > 0) ? sorted[glyphCount - 1].codepoint / FONT_BLOCK_SIZE + 1 : 0;
+        u32 usedBlockCount = 0;
+        for (u32 i = 0; i < glyphCount; i++) {
+            if (i == 0 || sorted[i].codepoint / FONT_BLOCK_SIZE != sorted[i - 1].codepoint / FONT_BLOCK_SIZE) usedBlockCount++;
+        }
+
+        // Pairs whose glyphs don't exist are dropped
+        u32 kerningCount = 0;
+        SortedKerning* pairs = (SortedKerning*)memory::alloc(sizeof(SortedKerning) * (desc->kerningCount > 0 ? desc->kerningCount : 1));
+
+        // Layout
+        FontHeader header = {};
+        header.magic = FONT_MAGIC;
+        header.version = FONT_VERSION;
+        header.lineHeight = desc->lineHeight;
+        header.baseLine = desc->baseLine;
+        header.paddingUp = desc->padding[0];
+        header.paddingRight = desc->padding[1];
+        header.paddingDown = desc->padding[2];
+        header.paddingLeft = desc->padding[3];
+        header.blockCount = blockCount;
+        header.usedBlockCount = usedBlockCount;
+        header.glyphCount = glyphCount;
+
+        header.blockIndexOffset = sizeof(FontHeader);
+        header.blockOffset = align4(header.blockIndexOffset + sizeof(u16) * blockCount);
+        header.glyphOffset = align4(header.blockOffset + sizeof(u16) * FONT_BLOCK_SIZE * usedBlockCount);
+        header.kerningOffset = header.glyphOffset + sizeof(Glyph) * glyphCount;
+
+        u64 maxSize = header.kerningOffset + sizeof(GlyphKerning) * (u64)desc->kerningCount;
+        u8* output = (u8*)memory::alloc(maxSize);
+
+        u16* blockIndex = (u16*)(output + header.blockIndexOffset);
+        u16* blocks = (u16*)(output + header.blockOffset);
+        Glyph* glyphs = (Glyph*)(output + header.glyphOffset);
+        GlyphKerning* kernings = (GlyphKerning*)(output + header.kerningOffset);
+
+        memory::set(blockIndex, sizeof(u16) * blockCount, 0xFF);
+        memory::set(blocks, sizeof(u16) * FONT_BLOCK_SIZE * usedBlockCount, 0xFF);
+
+        u16 nextBlock = 0;
+        for (u32 i = 0; i < glyphCount; i++) {
+            u32 codepoint = sorted[i].codepoint;
+            u32 block = codepoint / FONT_BLOCK_SIZE;
+            if (blockIndex[block] == FONT_NONE) blockIndex[block] = nextBlock++;
+
+            blocks[(u32)blockIndex[block] * FONT_BLOCK_SIZE + codepoint % FONT_BLOCK_SIZE] = (u16)i;
+
+            glyphs[i] = desc->glyphs[sorted[i].index];
+            glyphs[i].kerningCount = 0;
+            glyphs[i].kerningIndex = 0;
+        }
+
+        // -- Kerning, grouped by their first glyph so every glyph owns a sorted range
+        // NOTE: The header is written early, the glyph lookup below already works on the output.
+        memory::copy(output, &header, sizeof(FontHeader));
+
+        for (u32 i = 0; i < desc->kerningCount; i++) {
+            const Kerning* pair = &desc->kernings[i];
+
+            const Glyph* first = font_get_glyph((const FontHeader*)output, pair->first);
+            if (!first || !font_get_glyph((const FontHeader*)output, pair->second) || pair->amount == 0) continue;
+
+            pairs[kerningCount].glyph = (u32)(first - glyphs);
+            pairs[kerningCount].second = pair->second;
+            pairs[kerningCount].amount = pair->amount;
+            kerningCount++;
+        }
+        qsort(pairs, kerningCount, sizeof(SortedKerning), sorted_kerning_compare);
+
+        u32 uniqueCount = 0;
+        for (u32 i = 0; i < kerningCount; i++) {
+            if (uniqueCount > 0 && pairs[i].glyph == pairs[uniqueCount - 1].glyph && pairs[i].second == pairs[uniqueCount - 1].second) continue;
+            pairs[uniqueCount++] = pairs[i];
+        }
+
+        for (u32 i = 0; i < uniqueCount; i++) {
+            Glyph* glyph = &glyphs[pairs[i].glyph];
+            if (glyph->kerningCount == 0) glyph->kerningIndex = i;
+            if (glyph->kerningCount < FONT_NONE) glyph->kerningCount++;
+
+            kernings[i].second = pairs[i].second;
+            kernings[i].amount = pairs[i].amount;
+        }
+
+        header.kerningCount = uniqueCount;
+        memory::copy(output, &header, sizeof(FontHeader));
+
+        memory::free(pairs);
+        memory::free(sorted);
+
+        *outSize = header.kerningOffset + sizeof(GlyphKerning) * (u64)uniqueCount;
+        return output;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "forge/component/font.hpp"
+
+// -------------------------------------------
+// Font Compilation
+// -------------------------------------------
+// Reads BMFont descriptors (binary version 3 or text) and compiles them into the sparse glyph table
+// the engine uses in place, see 'forge/component/font.hpp'.
+
+namespace font {
+    struct Kerning {
+        u32 first;  // Codepoints
+        u32 second;
+        i16 amount;
+    };
+
+    struct Description {
+        u16 lineHeight;
+        u16 baseLine;
+        u8 padding[4]; // Up, right, down, left
+        u32 pageCount;
+
+        u32 glyphCount;
+        u32* codepoints;
+        Glyph* glyphs;
+
+        u32 kerningCount;
+        Kerning* kernings;
+    };
+
+    bool parse_bmfont(const u8* data, u64 size, Description* outDesc);
+    void release(Description* desc);
+
+    // Returns the compiled font in a single block, which must be released with 'memory::free'
+    u8*  compile(const Description* desc, u64* outSize);
+}
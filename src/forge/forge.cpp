@@ -1,21 +1,35 @@
-// -------------------------------------------
-// To Do
-// -------------------------------------------
-// - When rebuilding a specific asset type, assets.hpp/cpp will ONLY contain code for its type erasing all others.
-// | SOLUTION: Separate each asset type into it's own file. Include all existing asset files into asset.hpp
-
 // -------------------------------------------
 // Includes
 // -------------------------------------------
 
 #include "pch.hpp"
 
+#include "forge/arena.hpp"
+#include "forge/audio.hpp"
+#include "forge/bcn.hpp"
+#include "forge/blit.hpp"
+#include "forge/font.hpp"
+#include "forge/mip.hpp"
+#include "forge/pack.hpp"
+#include "forge/png.hpp"
+#include "forge/qoi.hpp"
+#include "forge/scan.hpp"
+#include "forge/text.hpp"
+#include "forge/trace.hpp"
+#include "forge/watch.hpp"
+#include "forge/component/archive.hpp"
 #include "forge/component/atlas.hpp"
+#include "forge/component/audio.hpp"
+#include "forge/component/font.hpp"
+#include "forge/component/lookup.hpp"
 
 #define GEM_FORCE_LOGGING
 #include "GEM/logger.hpp"
 #include "GEM/core/filesystem.hpp"
+#include "GEM/core/hash.hpp"
 #include "GEM/core/memory.hpp"
+#include "GEM/core/thread.hpp"
+#include "GEM/core/timer.hpp"
 #include "GEM/math/mathf.hpp"
 #include "GEM/math/geometry.hpp"
 #include "GEM/math/vector.hpp"
@@ -24,7 +38,6 @@
 // Constants
 // -------------------------------------------
 
-#define CONFIG_MAX_ASSET_FILES     256
 #define CONFIG_MAX_SUB_GRID_IMAGES 64
 
 #define CONFIG_ATLAS_MIN_WIDTH  64
@@ -33,16 +46,68 @@
 #define CONFIG_ATLAS_MAX_WIDTH  8192
 #define CONFIG_ATLAS_MAX_HEIGHT 8192
 
+#define CONFIG_ATLAS_MAX_MIP_LEVELS 14 // Full chain of the largest atlas, 8192 down to 1
+
+// Best fit atlases that don't fit into a single atlas of the max size spill over into more pages of the same size,
+// which are meant to be loaded as the layers of a texture array
+#define CONFIG_ATLAS_MAX_PAGES 8
+
+// Upper bound for alpha bleeding, transparent pixels further than this from any visible pixel keep their colour
+#define CONFIG_ATLAS_MAX_BLEED_PASSES 16
+
 // TODO: CONFIG_COMPONENT_PATH is not validated!
 #define CONFIG_COMPONENT_PATH "../../src/forge/component"
 // TODO: CONFIG_ASSET_PATH is not validated!
 #define CONFIG_ASSET_PATH "../../assets"
 
 #define CONFIG_TEMP_PATH "temp"
+
+// Decoded images keyed by the content hash of their source, kept across runs so unchanged images skip PNG decoding
+#define CONFIG_PIXEL_CACHE_PATH CONFIG_TEMP_PATH "/pixels"
+#define CONFIG_PIXEL_CACHE_EXT ".qoi"
+#define CONFIG_PIXEL_CACHE_BUDGET_MB 1024 // Least recently used images are evicted past this, 0 disables the cache
+
+// Atlases whose decoded images add up to more than this are streamed, every image is decoded, copied into the atlas & freed
+// in turn instead of all of them staying in memory until the atlas is done. Each job holds at most one image at a time.
+#define CONFIG_ATLAS_DECODE_BUDGET_MB 1024 // 0 streams every atlas
+
+// Seeds tried per bucket of the name lookup tables before giving up, small buckets typically need a handful
+#define CONFIG_LOOKUP_MAX_SEED 0x100000
+
+// Quiet period before a watch rebuild starts, so a bulk save only triggers a single rebuild
+#define CONFIG_WATCH_DEBOUNCE_MS 50
+
+// Upper bound of '--jobs', the calling thread counts as one of them
+#define CONFIG_MAX_JOB_COUNT 64
+
+// Distinct scope names in the trace summary
+#define CONFIG_TRACE_MAX_TOTALS 64
 #define CONFIG_RESOURCE_PATH "resources"
+#define CONFIG_SOUND_EXT ".snd"   // Processed sounds, see 'forge/component/audio.hpp'
+#define CONFIG_FONT_EXT ".glyphs" // Compiled glyph tables, see 'forge/component/font.hpp'
+#define CONFIG_ARCHIVE_PATH CONFIG_RESOURCE_PATH "/assets.pak"
 // TODO: CONFIG_GEN_PATH is not validated!
 #define CONFIG_GEN_PATH "../../src/GEM"
 
+// Binary manifest identifier & layout version, bump the version whenever the layout changes
+#define CONFIG_MANIFEST_MAGIC   0x4E414D46 // "FMAN"
+#define CONFIG_MANIFEST_VERSION 2
+
+// Cached atlas layout & pixels, used to patch atlases in place between runs
+#define CONFIG_ATLAS_CACHE_MAGIC   0x53414C41 // "ALAS"
+#define CONFIG_ATLAS_CACHE_VERSION 8
+
+// Every output of an atlas in a single file, keyed by all of its inputs so inputs built before (e.g. on another branch) are restored
+// NOTE: Bump the version whenever the same inputs would generate a different atlas.
+#define CONFIG_ATLAS_STORE_PATH      CONFIG_TEMP_PATH "/store"
+#define CONFIG_ATLAS_STORE_EXT       ".store"
+#define CONFIG_ATLAS_STORE_MAGIC     0x524F5453 // "STOR"
+#define CONFIG_ATLAS_STORE_VERSION   1
+#define CONFIG_ATLAS_STORE_MAX_FILES (CONFIG_ATLAS_MAX_PAGES * CONFIG_ATLAS_MAX_MIP_LEVELS + 1) // Pngs, mips or dds & the atlas cache
+#define CONFIG_ATLAS_STORE_BUDGET_MB 2048 // Least recently used entries are evicted past this, 0 disables the store
+
+#define FORGE_ALL_ASSET_TYPES ((1u << as_index(AssetType::COUNT)) - 1)
+
 #define LOG_PREFIX_WARN ANSI_YELLOW "WARN" ANSI_RESET ": "
 #define LOG_PREFIX_ERRO ANSI_RED    "ERRO" ANSI_RESET ": "
 
@@ -59,6 +124,9 @@ enum class StatusCode {
 
 enum class Flags {
     FORCE_GENERATION = 1 << 0, // Forces file generation, regardless of whether we have any changes or not
+    WRITE_ARCHIVE    = 1 << 1, // Packs atlases, sounds, music & fonts into a single memory-mappable archive
+    WATCH            = 1 << 2, // Stays resident after the first build, rebuilding asset types as their directories change
+    TRUST_WRITE_TIME = 1 << 3, // Skips hashing files whose name, size & write time match the manifest, misses edits that keep both
 };
 
 struct Image {
@@ -90,6 +158,16 @@ enum class BundleType {
 struct AtlasConfig {
     // Shared
     AtlasType type;
+    bool alphaBleed;
+
+    u32 mipLevelCount; // Including the base level, 0 = no mips, ATLAS_MIP_FULL_CHAIN = down to 1x1
+    AtlasMipFilter mipFilter;
+
+    // Best Fit
+    u32 padding;          // Pixels kept free around each image
+    bool extrudeEdges;    // Fills the padding with the image's edge pixels
+    bool trimTransparent; // Packs only the visible part of each image
+    bool allowRotation;   // Lets the packer turn images by 90 degrees
 
     // Grid
     u32 gridSize;
@@ -112,37 +190,212 @@ struct AssetConfig {
     // Runtime
     char typeUpper[GEM_MAX_STRING_LENGTH];
     char typeCapital[GEM_MAX_STRING_LENGTH];
-    char headerPath[MAX_PATH];
-    char sourcePath[MAX_PATH];
+    text::Builder headerPart;
+    text::Builder sourcePart;
 };
 
 struct Asset {
-    char baseName[GEM_MAX_STRING_LENGTH];
-    char fileName[GEM_MAX_STRING_LENGTH];
+    const char* baseName; // Both live in the bundle's name arena
+    const char* fileName;
+
+    // Manifest
+    u64 nameHash;         // Of the file name
+    u64 contentHash;
+    u64 fileSize;
+    u64 writeTime;        // Files with an unchanged name, size & write time keep the content hash of the manifest
 
     // Optional
     struct {
-        geometry::Rectangle rect;
+        geometry::Rectangle rect; // Area in the atlas, width & height are swapped for rotated images
+        geometry::Rectangle trim; // Visible part of the source image
+        Vec2i sourceSize;
+        bool isRotated;           // Stored 90 degrees clockwise
+        u32 page;                 // Atlas page the rect is on
+
+        u64 pixelHash;            // Visible pixels only, identical images share their place in the atlas
+        i32 aliasOf;              // Index of the identical image this one reuses, -1 when unique
+
+        AudioFormat audioFormat;  // Processed sound, at AUDIO_MIX_RATE
+        u32 channelCount;
+        u64 sampleCount;          // Per channel
+
+        FontHeader font;          // Metrics & counts of the compiled font
+
+        AssetType atlasOf;        // Atlas files only, the type that generated the atlas (COUNT if none did)
     } data;
 };
 
+// NOTE: Assets are only ever pushed while the bundle is filled, so they stay one contiguous array in their arena.
 struct Bundle {
     const char* path;
 
     u32 assetCount;
-    Asset assets[CONFIG_MAX_ASSET_FILES];
+    Asset* assets;
+
+    arena::Arena assetArena;
+    arena::Arena nameArena;
 
     bool containsChanges;
 };
 
+// -- Atlas Jobs
+struct AtlasDecodeJob {
+    Bundle* bundle;
+    Image* images;
+    const AtlasConfig* config;
+    volatile i64 failedCount;
+};
+
+struct AtlasBlitJob {
+    const AtlasConfig* config;
+    const Image* images;
+    const stbrp_rect* rects;
+    const Asset* assets;        // Best fit only, trimmed bounds & rotation of each image
+    const u32* subImageOffsets; // Grid only, number of sub-images placed before each image
+    const u32* indices;         // Optional, limits the blit to a subset of the images
+
+    Vec2i atlasSize;
+    unsigned char* atlasImgData;
+};
+
+// Decodes, blits & frees one image at a time, see 'CONFIG_ATLAS_DECODE_BUDGET_MB'
+struct AtlasStreamJob {
+    AtlasDecodeJob* decodeJob;
+    AtlasBlitJob* blitJob;
+    void (*blit)(void* data, u32 index);
+};
+
+// -- Atlas Cache
+// [ AtlasCacheHeader | AtlasCacheEntry * assetCount | pixels of every page, one after another ]
+struct AtlasCacheHeader {
+    u32 magic;
+    u32 version;
+    u32 assetCount;
+    u32 pageCount;
+
+    Vec2i size; // Of each page
+    AtlasConfig config;
+    bcn::Format bcFormat; // Of the dds next to the pngs, NONE writes mip level pngs instead
+};
+
+struct AtlasCacheEntry {
+    u64 nameHash;
+    u64 contentHash;
+
+    i32 width;
+    i32 height;
+    geometry::Rectangle rect;
+    geometry::Rectangle trim;
+    u32 isRotated;
+    i32 aliasOf;
+    u32 page;
+};
+
+struct AtlasStoreHeader {
+    u32 magic;
+    u32 version;
+    u32 fileCount;
+    u32 reserved;
+    u64 key;
+};
+
+struct AtlasStoreFile {
+    char path[MAX_PATH]; // Where the file is restored to
+    u64 offset;          // From the start of the store file
+    u64 size;
+};
+
+struct AtlasAliasKey {
+    u64 pixelHash;
+    u32 index;
+};
+
+// -- Scheduling
+struct Task {
+    AssetType assetType;
+    StatusCode status;
+
+    volatile i64 dependencyCount; // Tasks that still have to finish before this one can start
+    u32 dependentCount;
+    AssetType dependents[as_index(AssetType::COUNT)];
+
+    thread::Counter* counter;
+};
+
+// -- Manifest
+struct ManifestHeader {
+    u32 magic;
+    u32 version;
+    u32 assetCount;
+    u32 reserved;
+};
+
+struct ManifestEntry {
+    u64 nameHash;
+    u64 contentHash;
+    u64 fileSize;
+    u64 writeTime;
+};
+
+struct ManifestHashJob {
+    Bundle* bundle;
+    const u32* assetIndices; // Only the assets whose content hash couldn't be reused
+    volatile i64 failedCount;
+};
+
+// -- Watch
+// Decoded image kept between rebuilds, only handed back while its file is unchanged
+struct ResidentImage {
+    u64 nameHash;
+    u64 contentHash;
+
+    Image image;
+    geometry::Rectangle trim;
+    u64 pixelHash;
+};
+
+// -- Pixel Cache
+// Counted across every asset type of a single build
+struct PixelCacheStats {
+    volatile i64 hitCount;
+    volatile i64 missCount;
+    volatile i64 readBytes;    // Encoded sizes on disk
+    volatile i64 writtenBytes;
+};
+
+// Files left in a cache directory after trimming it
+struct CacheUsage {
+    u32 fileCount;
+    u64 size;
+
+    u32 evictedCount;
+    u64 evictedSize;
+};
+
+// -- Archive
+struct ArchiveSource {
+    ArchiveEntry entry;
+    file::Mapping map;
+    u64 dataOffset; // Start of the stored data within the source file
+};
+
 struct PersistentData {
-    u32 atlasFileToAssetID[as_index(AssetType::COUNT)];
+    Bundle* bundles[as_index(AssetType::COUNT)]; // Kept alive until exit, see 'forge_write_archive'
 
     struct {
         Vec2i size;
+        u32 pageCount;
+        u32 mipLevelCount;
         u32 elementLimit;
         AtlasConfig config;
     } atlas[as_index(AssetType::COUNT)];
+
+    // Watch mode only, sorted by name hash
+    struct {
+        u32 count;
+        u32 capacity;
+        ResidentImage* entries;
+    } residentImages[as_index(AssetType::COUNT)];
 };
 
 // -------------------------------------------
@@ -151,8 +404,21 @@ struct PersistentData {
 
 StatusCode _internal_status_code = StatusCode::SKIPPED;
 u32 _internal_flags = 0;
+u32 _internal_job_count = 1;
+png::Level _internal_png_level = png::Level::DEFAULT;
+bcn::Format _internal_bc_format = bcn::Format::NONE;
+AudioFormat _internal_audio_format = AudioFormat::S16;
+const char* _internal_trace_path = NULL;
+u64 _internal_pixel_cache_budget = (u64)CONFIG_PIXEL_CACHE_BUDGET_MB * 1024 * 1024;
+u64 _internal_atlas_store_budget = (u64)CONFIG_ATLAS_STORE_BUDGET_MB * 1024 * 1024;
+u64 _internal_decode_budget = (u64)CONFIG_ATLAS_DECODE_BUDGET_MB * 1024 * 1024;
 
 PersistentData gPersistent = {};
+PixelCacheStats gPixelCache = {};
+
+thread::Pool gPool = {};
+thread::Mutex gStatusMutex = {};
+Task gTasks[as_index(AssetType::COUNT)] = {};
 
 AssetConfig gAssetConfigs[as_index(AssetType::COUNT)] = {
     {
@@ -161,6 +427,13 @@ AssetConfig gAssetConfigs[as_index(AssetType::COUNT)] = {
         .fileExt = { ".png" },
         .atlas = {
             .type = AtlasType::BEST_FIT,
+            .alphaBleed = true,
+            .mipLevelCount = 3,
+            .mipFilter = AtlasMipFilter::BOX,
+            .padding = 4,
+            .extrudeEdges = true,
+            .trimTransparent = true,
+            .allowRotation = true,
         },
     },
     {
@@ -193,6 +466,8 @@ AssetConfig gAssetConfigs[as_index(AssetType::COUNT)] = {
         .fileExt = { ".fnt", ".png" },
         .atlas = {
             .type = AtlasType::BEST_FIT,
+            .alphaBleed = true,
+            .padding = 1,
         },
     },
     {
@@ -240,6 +515,12 @@ const char* gAtlasPriorityToStr[as_index(AtlasPriority::COUNT)] = {
     "AtlasPriority::COLUMN_FIRST",
 };
 
+const char* gAudioFormatToStr[as_index(AudioFormat::COUNT)] = {
+    "AudioFormat::S16",
+    "AudioFormat::F32",
+    "AudioFormat::IMA_ADPCM",
+};
+
 // -------------------------------------------
 // Functions
 // -------------------------------------------
@@ -253,6 +534,16 @@ void forge_set_status(StatusCode status) {
     _internal_status_code = status;
 }
 
+// NOTE: Failures take priority over changes, changes take priority over skips.
+//       This way the order in which tasks finish doesn't affect the final status.
+void forge_merge_status(StatusCode status) {
+    thread::mutex_lock(&gStatusMutex);
+    if (status == StatusCode::FAILURE || (status == StatusCode::CHANGED && _internal_status_code != StatusCode::FAILURE)) {
+        _internal_status_code = status;
+    }
+    thread::mutex_unlock(&gStatusMutex);
+}
+
 u32 forge_get_flags() {
     return _internal_flags;
 }
@@ -265,46 +556,244 @@ bool forge_is_flag_set(Flags flag) {
     return FLAG_GET(_internal_flags, flag);
 }
 
+u32 forge_get_job_count() {
+    return _internal_job_count;
+}
+
+void forge_set_job_count(u32 jobCount) {
+    _internal_job_count = jobCount > 0 ? jobCount : thread::get_core_count();
+}
+
+png::Level forge_get_png_level() {
+    return _internal_png_level;
+}
+
+void forge_set_png_level(png::Level level) {
+    _internal_png_level = level;
+}
+
+bcn::Format forge_get_bc_format() {
+    return _internal_bc_format;
+}
+
+void forge_set_bc_format(bcn::Format format) {
+    _internal_bc_format = format;
+}
+
+AudioFormat forge_get_audio_format() {
+    return _internal_audio_format;
+}
+
+void forge_set_audio_format(AudioFormat format) {
+    _internal_audio_format = format;
+}
+
+const char* forge_get_trace_path() {
+    return _internal_trace_path;
+}
+
+void forge_set_trace_path(const char* path) {
+    _internal_trace_path = path;
+}
+
+u64 forge_get_pixel_cache_budget() {
+    return _internal_pixel_cache_budget;
+}
+
+void forge_set_pixel_cache_budget(u64 budget) {
+    _internal_pixel_cache_budget = budget;
+}
+
+u64 forge_get_atlas_store_budget() {
+    return _internal_atlas_store_budget;
+}
+
+void forge_set_atlas_store_budget(u64 budget) {
+    _internal_atlas_store_budget = budget;
+}
+
+u64 forge_get_decode_budget() {
+    return _internal_decode_budget;
+}
+
+void forge_set_decode_budget(u64 budget) {
+    _internal_decode_budget = budget;
+}
+
+// -- File
+// file::write takes at most an i32 worth of bytes, multi-page atlases & their caches go past that
+bool forge_file_write_large(const file::File* f, const u8* data, u64 size) {
+    const u64 chunkSize = 1ull << 30;
+
+    for (u64 offset = 0; offset < size; offset += chunkSize) {
+        u64 writeSize = (size - offset < chunkSize) ? size - offset : chunkSize;
+        if (!file::write(f, data + offset, (i32)writeSize)) return false;
+    }
+
+    return true;
+}
+
 // -- Bundle
-bool forge_try_fill_bundle(const AssetConfig* config, Bundle* bundle, u32 bundleIdx, const char* scanPath) {
+void forge_manifest_hash_asset(void* data, u32 index) {
+    ManifestHashJob* job = (ManifestHashJob*)data;
+    Asset* asset = &job->bundle->assets[job->assetIndices[index]];
+
+    char filePathStr[MAX_PATH] = "";
+    strcpy(filePathStr, job->bundle->path);
+    strcat(filePathStr, "/");
+    strcat(filePathStr, asset->fileName);
+
+    file::Mapping assetMap = {};
+    if (!file::map(filePathStr, &assetMap)) {
+        log_format(LOG_PREFIX_WARN "BUNDLE > Could not read asset " ANSI_GREEN "'%s'" ANSI_RESET, filePathStr);
+        thread::atomic_increment(&job->failedCount);
+        return;
+    }
+
+    asset->contentHash = hash::xxh64(assetMap.data, assetMap.size);
+    asset->fileSize = assetMap.size;
+    file::unmap(&assetMap);
+}
+
+i32 forge_manifest_entry_compare(const void* a, const void* b) {
+    u64 hashA = ((const ManifestEntry*)a)->nameHash;
+    u64 hashB = ((const ManifestEntry*)b)->nameHash;
+    return (hashA > hashB) - (hashA < hashB);
+}
+
+// With '--fast', takes the content hash from the manifest for every file with the same name, size & write time.
+// Fills 'outHashIndices' with the assets that still have to be hashed & returns their count.
+u32 forge_manifest_find_known_hashes(Bundle* bundle, const ManifestHeader* header, const ManifestEntry* entries, u32* outHashIndices) {
+    u32 hashCount = 0;
+
+    // By default every file is read, a checkout or extraction can keep both the size & write time of an edited file
+    ManifestEntry* sortedEntries = NULL;
+    if (header && header->assetCount > 0 && forge_is_flag_set(Flags::TRUST_WRITE_TIME) && !forge_is_flag_set(Flags::FORCE_GENERATION)) {
+        sortedEntries = (ManifestEntry*)memory::alloc(sizeof(ManifestEntry) * header->assetCount);
+    }
+
+    if (sortedEntries) {
+        memory::copy(sortedEntries, entries, sizeof(ManifestEntry) * header->assetCount);
+        qsort(sortedEntries, header->assetCount, sizeof(ManifestEntry), forge_manifest_entry_compare);
+    }
+
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        Asset* asset = &bundle->assets[i];
+
+        if (sortedEntries) {
+            u32 low = 0;
+            u32 high = header->assetCount;
+            while (low < high) {
+                u32 mid = low + (high - low) / 2;
+                if (sortedEntries[mid].nameHash < asset->nameHash) low = mid + 1;
+                else high = mid;
+            }
+
+            const ManifestEntry* entry = &sortedEntries[low];
+            if (low < header->assetCount && entry->nameHash == asset->nameHash && entry->fileSize == asset->fileSize && entry->writeTime == asset->writeTime) {
+                asset->contentHash = entry->contentHash;
+                continue;
+            }
+        }
+
+        outHashIndices[hashCount++] = i;
+    }
+
+    if (sortedEntries) memory::free(sortedEntries);
+    return hashCount;
+}
+
+// Processed outputs all sit in a single folder, assets from subfolders get the folders as a prefix ('rebels/hit' -> 'rebels_hit')
+void forge_get_flat_output_path(const char* directory, const Asset* asset, const char* extension, char* buffer) {
+    i32 prefixLength = sprintf(buffer, "%s/", directory);
+    sprintf(buffer + prefixLength, "%s%s", asset->baseName, extension);
+
+    for (char* c = buffer + prefixLength; *c != '\0'; c++) {
+        if (*c == '/') *c = '_';
+    }
+}
+
+// Releases every bundle of a type together with its arenas
+void forge_release_bundles(Bundle* bundles) {
+    if (!bundles) return;
+
+    for (u32 bundleIdx = 0; bundleIdx < as_index(BundleType::COUNT); bundleIdx++) {
+        arena::release(&bundles[bundleIdx].assetArena);
+        arena::release(&bundles[bundleIdx].nameArena);
+    }
+
+    memory::free(bundles);
+}
+
+bool forge_try_fill_bundle(const AssetConfig* config, Bundle* bundle, u32 bundleIdx, const char* scanPath, StatusCode* outStatus) {
     if (!config && !bundle && bundleIdx >= as_index(BundleType::COUNT)) return false;
     bundle->path = scanPath;
 
     // Scan for any asset files of a particular type
-    errno = 0;
-    DIR* handle = opendir(bundle->path);
-    if (!handle || errno == ENOENT) {
-        log_format(LOG_PREFIX_WARN "BUNDLE > Could not open directory " ANSI_GREEN "'%s'" ANSI_RESET, bundle->path);
-        forge_set_status(StatusCode::FAILURE);
+    trace::Scope scope = trace::begin("bundle.scan", config->type);
+
+    scan::Listing listing = {};
+    if (!scan::directory(bundle->path, config->fileExt[bundleIdx], &gPool, &listing)) {
+        log_format(LOG_PREFIX_WARN "BUNDLE > Could not scan directory " ANSI_GREEN "'%s'" ANSI_RESET, bundle->path);
+        trace::end(&scope);
+        *outStatus = StatusCode::FAILURE;
         return false;
     }
 
-    struct dirent* content;
-    while ((content = readdir(handle)) != NULL) {
-        if (file::has_extension(content->d_name, config->fileExt[bundleIdx])) {
-            if (bundle->assetCount < CONFIG_MAX_ASSET_FILES) {
-                // Filename
-                strcpy(bundle->assets[bundle->assetCount].fileName, content->d_name);
-                // Basename
-                content->d_name[strlen(content->d_name) - strlen(config->fileExt[bundleIdx])] = '\0';
-                strcpy(bundle->assets[bundle->assetCount].baseName, content->d_name);
-
-                // Map the current file to it's respective asset type
-                for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
-                    if (strcmp(content->d_name, gAssetConfigs[i].type) == 0) {
-                        gPersistent.atlasFileToAssetID[bundle->assetCount] = i;
-                    }
-                }
+    if (!arena::init(&bundle->assetArena) || !arena::init(&bundle->nameArena)) {
+        log_format(LOG_PREFIX_WARN "BUNDLE > Failed to reserve memory for " ANSI_GREEN "'%s'" ANSI_RESET, bundle->path);
+        scan::release(&listing);
+        trace::end(&scope);
+        *outStatus = StatusCode::FAILURE;
+        return false;
+    }
 
-                bundle->assetCount++;
-            } else {
-                log_format(LOG_PREFIX_WARN "BUNDLE > Maximum number of assets has exceeded, expected value < %u got %u", CONFIG_MAX_ASSET_FILES, bundle->assetCount);
-                return false;
+    bundle->assets = (Asset*)bundle->assetArena.data;
+
+    // Files in subfolders keep their relative path, e.g. 'rebels/fighter.png' becomes SPRITE_REBELS_FIGHTER
+    for (u32 i = 0; i < listing.count; i++) {
+        const scan::Entry* entry = &listing.entries[i];
+
+        // Mip levels & pages sit next to their atlas ('sprite.mip1.png', 'sprite.page1.png'), they aren't atlases of their own
+        if (config->assetType == AssetType::ATLAS && (strstr(entry->path, ".mip") != NULL || strstr(entry->path, ".page") != NULL)) continue;
+
+        u64 fileNameLength = strlen(entry->path);
+        u64 baseNameLength = fileNameLength - strlen(config->fileExt[bundleIdx]);
+
+        Asset* asset = (Asset*)arena::push(&bundle->assetArena, sizeof(Asset), alignof(Asset));
+        if (asset) {
+            asset->fileName = arena::push_string(&bundle->nameArena, entry->path, fileNameLength);
+            asset->baseName = arena::push_string(&bundle->nameArena, entry->path, baseNameLength);
+        }
+
+        if (!asset || !asset->fileName || !asset->baseName) {
+            log_format(LOG_PREFIX_WARN "BUNDLE > Ran out of reserved memory after %u assets in " ANSI_GREEN "'%s'" ANSI_RESET, bundle->assetCount, bundle->path);
+            scan::release(&listing);
+            trace::end(&scope);
+            *outStatus = StatusCode::FAILURE;
+            return false;
+        }
+
+        asset->nameHash = hash::string(asset->fileName);
+        asset->fileSize = entry->size;
+        asset->writeTime = entry->writeTime;
+
+        // Map the atlas file to the asset type it was generated for
+        if (config->assetType == AssetType::ATLAS) {
+            asset->data.atlasOf = AssetType::COUNT;
+
+            for (u32 t = 0; t < as_index(AssetType::COUNT); t++) {
+                if (strcmp(asset->baseName, gAssetConfigs[t].type) == 0) asset->data.atlasOf = (AssetType)t;
             }
         }
+
+        bundle->assetCount++;
     }
 
-    closedir(handle);
+    scan::release(&listing);
+
+    scope.itemCount = bundle->assetCount;
+    trace::end(&scope);
 
     // Check if any files were actually found
     if (bundle->assetCount == 0) {
@@ -312,7 +801,6 @@ bool forge_try_fill_bundle(const AssetConfig* config, Bundle* bundle, u32 bundle
         return false;
     }
 
-    // Check the manifest for changes
     char manifestPath[GEM_MAX_STRING_LENGTH] = "";
     strcpy(manifestPath, scanPath);
     strcat(manifestPath, "/");
@@ -320,234 +808,1622 @@ bool forge_try_fill_bundle(const AssetConfig* config, Bundle* bundle, u32 bundle
     strcat(manifestPath, config->fileExt[bundleIdx] + 1);
     strcat(manifestPath, ".manifest");
 
-    file::File manifestFile = file::open(manifestPath, file::Mode::READ_APPEND);
-    bool manifestExists = file::get_size(&manifestFile) != 0;
+    file::Mapping manifestMap = {};
+    const ManifestHeader* manifestHeader = NULL;
+    const ManifestEntry* manifestEntries = NULL;
 
-    if (manifestExists) {
-        // Check for file count change (major change)
-        char fileCountStr[GEM_MAX_STRING_LENGTH] = "";
-        file::read_line(&manifestFile, fileCountStr, GEM_MAX_STRING_LENGTH);
-        u32 fileCount = (u32)atoi(fileCountStr);
+    // NOTE: Manifests with an unknown layout (e.g. older text manifests) are simply rebuilt
+    if (file::exists(manifestPath) && file::map(manifestPath, &manifestMap)) {
+        const ManifestHeader* header = (const ManifestHeader*)manifestMap.data;
 
-        // Check for file name/time change (minor change)
-        bundle->containsChanges = fileCount != bundle->assetCount;
-        if (!bundle->containsChanges) {
-            for (u32 i = 0; i < bundle->assetCount; i++) {
-                Asset* asset = &bundle->assets[i];
+        bool isValid = manifestMap.size >= sizeof(ManifestHeader) &&
+                       header->magic == CONFIG_MANIFEST_MAGIC &&
+                       header->version == CONFIG_MANIFEST_VERSION &&
+                       manifestMap.size == sizeof(ManifestHeader) + sizeof(ManifestEntry) * (u64)header->assetCount;
 
-                char filePathStr[MAX_PATH] = "";
-                strcpy(filePathStr, scanPath);
-                strcat(filePathStr, "/");
-                strcat(filePathStr, asset->fileName);
+        if (isValid) {
+            manifestHeader = header;
+            manifestEntries = (const ManifestEntry*)(manifestMap.data + sizeof(ManifestHeader));
+        }
+    }
 
-                char lineStr[GEM_MAX_STRING_LENGTH] = "";
-                file::read_line(&manifestFile, lineStr, GEM_MAX_STRING_LENGTH);
+    // Hash the contents of every asset (only new or touched ones with '--fast'), so changes are detected even if a timestamp is kept
+    scope = trace::begin("bundle.hash", config->type);
 
-                const char* delimiter = "|";
-                if (strchr(lineStr, delimiter[0]) == NULL) {
-                    bundle->containsChanges = true;
-                    break;
-                }
+    u32* hashIndices = (u32*)memory::alloc(sizeof(u32) * bundle->assetCount);
+    u32 hashCount = forge_manifest_find_known_hashes(bundle, manifestHeader, manifestEntries, hashIndices);
 
-                // Check the asset's file name
-                // NOTE: Name checks aren't strictly necessary, as Windows updates the file modification time on name change.
-                //       I'm keeping this here as a "sanity" check.
-                char* storedNameStr = strtok(lineStr, delimiter);
-                bool hasNameChanged = strcmp(storedNameStr, asset->fileName) != 0;
+    ManifestHashJob hashJob = { bundle, hashIndices, 0 };
+    thread::pool_dispatch(&gPool, hashCount, forge_manifest_hash_asset, &hashJob);
 
-                // Check the asset's file modification time
-                char* storedTimeStr = strtok(NULL, delimiter);
-                bool hasTimeChanged = (i64)atoi(storedTimeStr) != file::get_timestamp(filePathStr);
+    scope.itemCount = hashCount;
+    for (u32 i = 0; i < hashCount; i++) scope.byteCount += bundle->assets[hashIndices[i]].fileSize;
+    trace::end(&scope);
 
-                bundle->containsChanges = hasNameChanged || hasTimeChanged;
-                if (bundle->containsChanges) break;
-            }
-        }
-    } else {
-        bundle->containsChanges = true;
+    memory::free(hashIndices);
+
+    if (hashJob.failedCount > 0) {
+        if (manifestMap.data) file::unmap(&manifestMap);
+        *outStatus = StatusCode::FAILURE;
+        return false;
     }
 
-    file::close(&manifestFile);
+    scope = trace::begin("bundle.manifest", config->type);
+    scope.itemCount = bundle->assetCount;
+    scope.byteCount = manifestMap.size;
 
-    // Rebuild the manifest if changes are present
-    if (bundle->containsChanges) {
-        manifestFile = file::open(manifestPath, file::Mode::WRITE, true);
+    // Check the file count (major change) & file names/contents (minor change) against the manifest
+    bundle->containsChanges = true;
 
-        char maxCountStr[GEM_MAX_STRING_LENGTH] = "";
-        sprintf(maxCountStr, "%i", CONFIG_MAX_ASSET_FILES);
-        u64 maxNumLen = strlen(maxCountStr);
+    if (manifestHeader && manifestHeader->assetCount == bundle->assetCount) {
+        bundle->containsChanges = false;
 
         for (u32 i = 0; i < bundle->assetCount; i++) {
-            Asset* asset = &bundle->assets[i];
+            const Asset* asset = &bundle->assets[i];
+            const ManifestEntry* entry = &manifestEntries[i];
 
-            char filePathStr[MAX_PATH] = "";
-            strcpy(filePathStr, scanPath);
-            strcat(filePathStr, "/");
-            strcat(filePathStr, asset->fileName);
-
-            // File Count Placeholder
-            char numStr[GEM_MAX_STRING_LENGTH] = "";
-            if (i == 0) {
-                for (u64 i = 0; i < maxNumLen; i++) {
-                    numStr[i] = ' ';
-                }
-                numStr[maxNumLen] = '\0';
+            bool hasNameChanged = entry->nameHash != asset->nameHash;
+            bool hasContentChanged = entry->fileSize != asset->fileSize || entry->contentHash != asset->contentHash;
 
-                file::write_line(&manifestFile, numStr);
-            }
+            bundle->containsChanges = hasNameChanged || hasContentChanged;
+            if (bundle->containsChanges) break;
+        }
+    }
+
+    // Touched files with unchanged contents only update their write time
+    bool hasTimeChanged = bundle->containsChanges;
+    for (u32 i = 0; i < bundle->assetCount && !hasTimeChanged; i++) {
+        hasTimeChanged = manifestEntries[i].writeTime != bundle->assets[i].writeTime;
+    }
+
+    if (manifestMap.data) file::unmap(&manifestMap);
+
+    // Rebuild the manifest if changes are present, touched files only refresh their write time
+    if (hasTimeChanged) {
+        u64 manifestSize = sizeof(ManifestHeader) + sizeof(ManifestEntry) * (u64)bundle->assetCount;
+        u8* manifestData = (u8*)memory::alloc(manifestSize);
 
-            // Name & Timestamp
-            char dataStr[GEM_MAX_STRING_LENGTH] = "";
-            strcpy(dataStr, asset->fileName);
-            strcat(dataStr, "|");
-            sprintf(numStr, "%lli", file::get_timestamp(filePathStr));
-            strcat(dataStr, numStr);
-            file::write_line(&manifestFile, dataStr);
+        ManifestHeader* header = (ManifestHeader*)manifestData;
+        header->magic = CONFIG_MANIFEST_MAGIC;
+        header->version = CONFIG_MANIFEST_VERSION;
+        header->assetCount = bundle->assetCount;
+
+        ManifestEntry* entries = (ManifestEntry*)(manifestData + sizeof(ManifestHeader));
+        for (u32 i = 0; i < bundle->assetCount; i++) {
+            const Asset* asset = &bundle->assets[i];
+
+            entries[i].nameHash = asset->nameHash;
+            entries[i].contentHash = asset->contentHash;
+            entries[i].fileSize = asset->fileSize;
+            entries[i].writeTime = asset->writeTime;
         }
 
-        char fileCountStr[GEM_MAX_STRING_LENGTH] = "";
-        sprintf(fileCountStr, "%u", bundle->assetCount);
-        file::set_offset_start(&manifestFile);
-        file::write(&manifestFile, fileCountStr, (i32)strlen(fileCountStr));
+        file::File manifestFile = file::open(manifestPath, file::Mode::WRITE, true);
+        file::write(&manifestFile, manifestData, (i32)manifestSize);
+        file::close(&manifestFile);
+        memory::free(manifestData);
+        scope.byteCount += manifestSize;
+    }
 
+    if (bundle->containsChanges) {
         log_format("- Updated manifest for type " ANSI_GREEN "'%s'" ANSI_RESET, config->fileExt[bundleIdx] + 1);
-        file::close(&manifestFile);
-        forge_set_status(StatusCode::CHANGED);
+        *outStatus = StatusCode::CHANGED;
     } else {
         if (forge_is_flag_set(Flags::FORCE_GENERATION)) {
             log_format("- Files of type " ANSI_GREEN "'%s'" ANSI_RESET " have changed | " ANSI_MAGENTA "Forced" ANSI_RESET, config->fileExt[bundleIdx] + 1);
-            forge_set_status(StatusCode::CHANGED);
+            *outStatus = StatusCode::CHANGED;
         } else {
             log_format("- Files of type " ANSI_GREEN "'%s'" ANSI_RESET " haven't changed | " ANSI_YELLOW "Skipped" ANSI_RESET, config->fileExt[bundleIdx] + 1);
-            forge_set_status(StatusCode::SKIPPED);
+            *outStatus = StatusCode::SKIPPED;
         }
     }
 
+    trace::end(&scope);
     return true;
 }
 
-// -- Atlas
-bool forge_atlas_try_stb_pack(Vec2i atlasSize, stbrp_rect* rects, u32 rectCount) {
-    if (atlasSize.w < CONFIG_ATLAS_MIN_WIDTH && atlasSize.h < CONFIG_ATLAS_MIN_HEIGHT && !rects && rectCount == 0) return false;
+// -- Pixel Cache
+void forge_pixel_cache_get_path(u64 contentHash, char* buffer) {
+    sprintf(buffer, CONFIG_PIXEL_CACHE_PATH "/%016llx" CONFIG_PIXEL_CACHE_EXT, (unsigned long long)contentHash);
+}
 
-    stbrp_context context = {};
-    i32 nodeCount = atlasSize.w;
-    stbrp_node* nodes = (stbrp_node*)memory::alloc(sizeof(stbrp_node) * nodeCount);
+// Hits refresh the write time of their file, which is what eviction orders by
+void forge_cache_touch(const char* path) {
+    HANDLE handle = CreateFileA(path, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return;
 
-    stbrp_init_target(&context, atlasSize.w, atlasSize.h, nodes, nodeCount);
-    stbrp_pack_rects(&context, rects, rectCount);
+    FILETIME now = {};
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(handle, NULL, NULL, &now);
+    CloseHandle(handle);
+}
 
-    bool success = true;
-    for (u32 i = 0; i < rectCount; i++) {
-        if (!rects[i].was_packed) {
-            success = false;
-        }
+// NOTE: Cached pixels are allocated with malloc, so they're released with 'stbi_image_free' like any decoded image.
+bool forge_pixel_cache_load(const Asset* asset, Image* outImage) {
+    if (forge_get_pixel_cache_budget() == 0) return false;
+
+    char cachePath[MAX_PATH] = "";
+    forge_pixel_cache_get_path(asset->contentHash, cachePath);
+
+    file::Mapping cacheMap = {};
+    if (!file::exists(cachePath) || !file::map(cachePath, &cacheMap)) {
+        thread::atomic_increment(&gPixelCache.missCount);
+        return false;
     }
 
-    memory::free(nodes);
-    return success;
-}
+    i32 width = 0, height = 0, channels = 0;
+    u8* pixels = NULL;
+    if (qoi::get_info(cacheMap.data, cacheMap.size, &width, &height, &channels)) {
+        pixels = (u8*)malloc((u64)width * height * 4);
+    }
 
-bool forge_generate_atlas(const AssetConfig* config, Bundle* bundle, u32 bundleIdx) {
-    if (!config && !bundle && bundleIdx >= as_index(BundleType::COUNT)) return false;
+    if (pixels && !qoi::decode(cacheMap.data, cacheMap.size, pixels)) {
+        free(pixels);
+        pixels = NULL;
+    }
 
-    Image* images = (Image*)memory::alloc(sizeof(Image) * bundle->assetCount);
-    stbrp_rect* rects = (stbrp_rect*)memory::alloc(sizeof(stbrp_rect) * bundle->assetCount);
+    u64 cacheSize = cacheMap.size;
+    file::unmap(&cacheMap);
 
-    if (config->atlas.type == AtlasType::COUNT) {
-        log_format(LOG_PREFIX_WARN "ATLAS > Cannot set type to its count!");
-        goto exit_generate_atlas;
+    // Damaged entries are simply decoded & stored again
+    if (!pixels) {
+        thread::atomic_increment(&gPixelCache.missCount);
+        return false;
     }
 
-    // Get images & rect data from bundle
-    for (u32 i = 0; i < bundle->assetCount; i++) {
-        Asset* asset = &bundle->assets[i];
-        Image* assetImg = &images[i];
+    forge_cache_touch(cachePath);
 
-        char filePathStr[MAX_PATH] = "";
-        strcpy(filePathStr, bundle->path);
-        strcat(filePathStr, "/");
-        strcat(filePathStr, asset->fileName);
+    outImage->data = pixels;
+    outImage->width = width;
+    outImage->height = height;
+    outImage->channels = channels;
 
-        assetImg->data = stbi_load(filePathStr, &assetImg->width, &assetImg->height, &assetImg->channels, 4);
-        if (assetImg->data) {
-            rects[i].id = i;
-            rects[i].w = assetImg->width;
-            rects[i].h = assetImg->height;
-        } else {
-            log_format(LOG_PREFIX_WARN "ATLAS > Failed to load image " ANSI_GREEN "'%s'" ANSI_RESET, filePathStr);
-            goto exit_generate_atlas;
-        }
+    thread::atomic_increment(&gPixelCache.hitCount);
+    thread::atomic_add(&gPixelCache.readBytes, (i64)cacheSize);
+    return true;
+}
+
+void forge_pixel_cache_store(const Asset* asset, const Image* image) {
+    if (forge_get_pixel_cache_budget() == 0) return;
+
+    u64 encodedSize = 0;
+    u8* encoded = qoi::encode(image->data, image->width, image->height, image->channels, &encodedSize);
+    if (!encoded) return;
+
+    // Identical files of different types may be stored at the same time, each writes its own file first
+    char cachePath[MAX_PATH] = "";
+    char writePath[MAX_PATH] = "";
+    forge_pixel_cache_get_path(asset->contentHash, cachePath);
+    sprintf(writePath, "%s.%lu.tmp", cachePath, (unsigned long)GetCurrentThreadId());
+
+    file::File cacheFile = file::open(writePath, file::Mode::WRITE, true);
+    bool hasWritten = cacheFile.handle && file::write(&cacheFile, encoded, (i32)encodedSize);
+    file::close(&cacheFile);
+    memory::free(encoded);
+
+    if (hasWritten && file::replace(writePath, cachePath)) {
+        thread::atomic_add(&gPixelCache.writtenBytes, (i64)encodedSize);
+    } else if (file::exists(writePath)) {
+        file::remove(writePath);
     }
+}
 
-    char atlasPathStr[GEM_MAX_STRING_LENGTH] = CONFIG_RESOURCE_PATH;
-    strcat(atlasPathStr, "/atlas/");
-    strcat(atlasPathStr, config->type);
-    strcat(atlasPathStr, ".png");
+i32 forge_cache_entry_compare(const void* a, const void* b) {
+    u64 timeA = (*(const scan::Entry* const*)a)->writeTime;
+    u64 timeB = (*(const scan::Entry* const*)b)->writeTime;
+    return (timeA > timeB) - (timeA < timeB);
+}
 
-    Vec2i atlasSize = Vec2i();
-    unsigned char* atlasImgData = NULL;
+// Removes the least recently used files of a cache directory until it fits its budget
+bool forge_cache_trim(const char* directory, const char* extension, u64 budget, CacheUsage* outUsage) {
+    *outUsage = {};
 
-    switch (config->atlas.type) {
-        using enum AtlasType;
-        case BEST_FIT:
-            {
-                atlasSize = { CONFIG_ATLAS_MIN_WIDTH, CONFIG_ATLAS_MIN_HEIGHT };
+    scan::Listing listing = {};
+    if (!scan::directory(directory, extension, &gPool, &listing)) return false;
 
-                for (;;) {
-                    // Reset the state
-                    for (u32 i = 0; i < bundle->assetCount; i++) {
-                        rects[i].was_packed = 0;
-                    }
+    outUsage->fileCount = listing.count;
+    for (u32 i = 0; i < listing.count; i++) outUsage->size += listing.entries[i].size;
 
-                    if (forge_atlas_try_stb_pack(atlasSize, rects, bundle->assetCount)) break;
+    const scan::Entry** entries = NULL;
+    if (outUsage->size > budget) entries = (const scan::Entry**)memory::alloc(sizeof(scan::Entry*) * listing.count);
 
-                    // If the pack failed, increase the size of the atlas. Width first, then height keeping it "square".
-                    if ((atlasSize.w * 2 <= CONFIG_ATLAS_MAX_WIDTH) && (atlasSize.w <= atlasSize.h || atlasSize.h * 2 > CONFIG_ATLAS_MAX_HEIGHT)) {
-                        atlasSize.w *= 2;
-                    } else if (atlasSize.h * 2 <= CONFIG_ATLAS_MAX_HEIGHT) {
-                        atlasSize.h *= 2;
-                    } else {
-                        atlasSize.h *= 2;
-                    }
+    if (entries) {
+        for (u32 i = 0; i < listing.count; i++) entries[i] = &listing.entries[i];
+        qsort(entries, listing.count, sizeof(scan::Entry*), forge_cache_entry_compare);
 
-                    // If the current dimensions exceed the maximum atlas size, stop packing!
-                    if (atlasSize.w > CONFIG_ATLAS_MAX_WIDTH || atlasSize.h > CONFIG_ATLAS_MAX_HEIGHT) {
-                        log_format(LOG_PREFIX_WARN "ATLAS > Images cannot be packed into a reasonable atlas size!");
-                        goto exit_generate_atlas;
-                    }
-                }
+        for (u32 i = 0; i < listing.count && outUsage->size > budget; i++) {
+            char filePath[MAX_PATH] = "";
+            sprintf(filePath, "%s/%s", directory, entries[i]->path);
+            if (!file::remove(filePath)) continue;
 
-                // Copy over the pixels from each image into the atlas
-                atlasImgData = (unsigned char*)memory::alloc(atlasSize.w * atlasSize.h * 4);
+            outUsage->fileCount--;
+            outUsage->size -= entries[i]->size;
+            outUsage->evictedCount++;
+            outUsage->evictedSize += entries[i]->size;
+        }
 
-                for (u32 i = 0; i < bundle->assetCount; i++) {
-                    if (rects[i].was_packed) {
-                        Asset* asset = &bundle->assets[i];
-                        Image* assetImg = &images[i];
-
-                        asset->data.rect.x      = rects[i].x;
-                        asset->data.rect.y      = rects[i].y;
-                        asset->data.rect.width  = rects[i].w;
-                        asset->data.rect.height = rects[i].h;
-
-                        for (i32 y = 0; y < assetImg->height; y++) {
-                            for (i32 x = 0; x < assetImg->width; x++) {
-                                i32 genPixel = ((rects[i].y + y) * atlasSize.w) + (rects[i].x + x);
-                                genPixel *= 4;
-
-                                i32 assetPixel = (y * assetImg->width) + x;
-                                assetPixel *= 4;
-
-                                atlasImgData[genPixel + 0] = assetImg->data[assetPixel + 0];
-                                atlasImgData[genPixel + 1] = assetImg->data[assetPixel + 1];
-                                atlasImgData[genPixel + 2] = assetImg->data[assetPixel + 2];
-                                atlasImgData[genPixel + 3] = assetImg->data[assetPixel + 3];
-                            }
-                        }
-                    }
-                }
-            }
+        memory::free(entries);
+    }
+
+    scan::release(&listing);
+    return true;
+}
+
+// Trims the cache down to its budget & reports this build's hits & misses
+void forge_pixel_cache_evict() {
+    u64 budget = forge_get_pixel_cache_budget();
+    if (budget == 0) return;
+
+    trace::Scope scope = trace::begin("cache.evict", "pixels");
+
+    CacheUsage usage = {};
+    if (!forge_cache_trim(CONFIG_PIXEL_CACHE_PATH, CONFIG_PIXEL_CACHE_EXT, budget, &usage)) {
+        log_format(LOG_PREFIX_WARN "CACHE > Could not scan " ANSI_GREEN "'%s'" ANSI_RESET, CONFIG_PIXEL_CACHE_PATH);
+        trace::end(&scope);
+        return;
+    }
+
+    scope.itemCount = usage.fileCount;
+    scope.byteCount = usage.size;
+    trace::end(&scope);
+
+    i64 lookupCount = gPixelCache.hitCount + gPixelCache.missCount;
+    log_format(ANSI_CYAN "[CACHE] " ANSI_RESET "%lld hits, %lld misses (%.1f%% hit rate) | %.1f MB read, %.1f MB written",
+               (long long)gPixelCache.hitCount, (long long)gPixelCache.missCount, lookupCount > 0 ? gPixelCache.hitCount * 100.0 / lookupCount : 0.0,
+               gPixelCache.readBytes / (1024.0 * 1024.0), gPixelCache.writtenBytes / (1024.0 * 1024.0));
+    log_format("  %u images, %.1f of %.1f MB | %u evicted (%.1f MB)", usage.fileCount, usage.size / (1024.0 * 1024.0),
+               budget / (1024.0 * 1024.0), usage.evictedCount, usage.evictedSize / (1024.0 * 1024.0));
+
+    memory::zero((void*)&gPixelCache, sizeof(PixelCacheStats));
+}
+
+// -- Atlas
+// Bounds of every pixel that isn't fully transparent, images without any end up empty
+void forge_atlas_find_trim(const AtlasConfig* config, const Image* image, geometry::Rectangle* outTrim) {
+    *outTrim = { 0, 0, image->width, image->height };
+    if (config->type != AtlasType::BEST_FIT || !config->trimTransparent) return;
+
+    i32 minX = image->width, minY = image->height;
+    i32 maxX = -1, maxY = -1;
+
+    for (i32 y = 0; y < image->height; y++) {
+        const u8* row = image->data + (u64)y * image->width * blit::BYTES_PER_PIXEL;
+
+        for (i32 x = 0; x < image->width; x++) {
+            if (row[x * blit::BYTES_PER_PIXEL + 3] == 0) continue;
+
+            if (x < minX) minX = x;
+            if (x > maxX) maxX = x;
+            if (y < minY) minY = y;
+            maxY = y;
+        }
+    }
+
+    if (maxX < 0) {
+        *outTrim = {};
+        return;
+    }
+
+    *outTrim = { minX, minY, maxX - minX + 1, maxY - minY + 1 };
+}
+
+// Hashes the visible rows only, so copies with different transparent margins still match
+u64 forge_atlas_hash_pixels(const Image* image, const geometry::Rectangle* trim) {
+    u64 hash = ((u64)trim->width << 32) | (u32)trim->height;
+    u64 rowBytes = (u64)trim->width * blit::BYTES_PER_PIXEL;
+
+    for (i32 y = 0; y < trim->height; y++) {
+        const u8* row = image->data + ((u64)(trim->y + y) * image->width + trim->x) * blit::BYTES_PER_PIXEL;
+        hash = hash::xxh64(row, rowBytes, hash);
+    }
+
+    return hash;
+}
+
+bool forge_atlas_is_same_image(const Image* imageA, const geometry::Rectangle* trimA, const Image* imageB, const geometry::Rectangle* trimB) {
+    if (trimA->width != trimB->width || trimA->height != trimB->height) return false;
+
+    u64 rowBytes = (u64)trimA->width * blit::BYTES_PER_PIXEL;
+    for (i32 y = 0; y < trimA->height; y++) {
+        const u8* rowA = imageA->data + ((u64)(trimA->y + y) * imageA->width + trimA->x) * blit::BYTES_PER_PIXEL;
+        const u8* rowB = imageB->data + ((u64)(trimB->y + y) * imageB->width + trimB->x) * blit::BYTES_PER_PIXEL;
+        if (memcmp(rowA, rowB, rowBytes) != 0) return false;
+    }
+
+    return true;
+}
+
+void forge_atlas_get_image_path(const Bundle* bundle, const Asset* asset, char* buffer) {
+    strcpy(buffer, bundle->path);
+    strcat(buffer, "/");
+    strcat(buffer, asset->fileName);
+}
+
+// Only reads the size from the file header, trimming & hashing still need the pixels
+void forge_atlas_read_image_info(void* data, u32 index) {
+    AtlasDecodeJob* job = (AtlasDecodeJob*)data;
+    Asset* asset = &job->bundle->assets[index];
+    Image* assetImg = &job->images[index];
+
+    // Resident images are already measured
+    if (assetImg->data) return;
+
+    char filePathStr[MAX_PATH] = "";
+    forge_atlas_get_image_path(job->bundle, asset, filePathStr);
+
+    if (!stbi_info(filePathStr, &assetImg->width, &assetImg->height, &assetImg->channels)) {
+        log_format(LOG_PREFIX_WARN "ATLAS > Failed to read image " ANSI_GREEN "'%s'" ANSI_RESET, filePathStr);
+        thread::atomic_increment(&job->failedCount);
+        return;
+    }
+
+    asset->data.sourceSize = { assetImg->width, assetImg->height };
+    asset->data.trim = { 0, 0, assetImg->width, assetImg->height };
+}
+
+void forge_atlas_decode_image(void* data, u32 index) {
+    AtlasDecodeJob* job = (AtlasDecodeJob*)data;
+    Asset* asset = &job->bundle->assets[index];
+    Image* assetImg = &job->images[index];
+
+    // Images can already be loaded by an earlier (partial) pass
+    if (assetImg->data) return;
+
+    char filePathStr[MAX_PATH] = "";
+    forge_atlas_get_image_path(job->bundle, asset, filePathStr);
+
+    if (!forge_pixel_cache_load(asset, assetImg)) {
+        assetImg->data = stbi_load(filePathStr, &assetImg->width, &assetImg->height, &assetImg->channels, 4);
+        if (!assetImg->data) {
+            log_format(LOG_PREFIX_WARN "ATLAS > Failed to load image " ANSI_GREEN "'%s'" ANSI_RESET, filePathStr);
+            thread::atomic_increment(&job->failedCount);
+            return;
+        }
+
+        forge_pixel_cache_store(asset, assetImg);
+    }
+
+    asset->data.sourceSize = { assetImg->width, assetImg->height };
+    forge_atlas_find_trim(job->config, assetImg, &asset->data.trim);
+    asset->data.pixelHash = forge_atlas_hash_pixels(assetImg, &asset->data.trim);
+}
+
+// Streamed best fit atlases need the trim & pixel hash of every image before packing, the pixels are dropped right after
+void forge_atlas_measure_image(void* data, u32 index) {
+    AtlasDecodeJob* job = (AtlasDecodeJob*)data;
+    Image* assetImg = &job->images[index];
+    if (assetImg->data) return;
+
+    forge_atlas_decode_image(job, index);
+
+    if (assetImg->data) {
+        stbi_image_free(assetImg->data);
+        assetImg->data = NULL;
+    }
+}
+
+// NOTE: Every image owns its own destination rectangle, so images can be copied over in any order.
+void forge_atlas_blit_best_fit(void* data, u32 index) {
+    AtlasBlitJob* job = (AtlasBlitJob*)data;
+    if (job->indices) index = job->indices[index];
+    const stbrp_rect* rect = &job->rects[index];
+    const Image* assetImg = &job->images[index];
+    if (!rect->was_packed || job->assets[index].data.aliasOf >= 0) return;
+
+    // The rect covers the image, its padding & the alignment to whole blocks
+    const AtlasConfig* config = job->config;
+    const Asset* asset = &job->assets[index];
+    const geometry::Rectangle* trim = &asset->data.trim;
+    i32 padding = (i32)config->padding;
+    u8* page = job->atlasImgData + (u64)asset->data.page * job->atlasSize.w * job->atlasSize.h * blit::BYTES_PER_PIXEL;
+    u8* region = page + ((u64)rect->y * job->atlasSize.w + rect->x) * blit::BYTES_PER_PIXEL;
+    u8* dest = region + ((u64)padding * job->atlasSize.w + padding) * blit::BYTES_PER_PIXEL;
+    const u8* src = assetImg->data + ((u64)trim->y * assetImg->width + trim->x) * blit::BYTES_PER_PIXEL;
+
+    // Patched atlases still hold the previous pixels around the image
+    if (job->indices) blit::clear(region, job->atlasSize.w, rect->w, rect->h);
+
+    if (asset->data.isRotated) {
+        blit::rect_rotated(dest, job->atlasSize.w, src, assetImg->width, trim->width, trim->height);
+    } else {
+        blit::rect(dest, job->atlasSize.w, src, assetImg->width, trim->width, trim->height);
+    }
+
+    if (config->extrudeEdges) blit::extrude(dest, job->atlasSize.w, asset->data.rect.width, asset->data.rect.height, padding);
+    if (config->alphaBleed) blit::bleed(region, job->atlasSize.w, rect->w, rect->h, CONFIG_ATLAS_MAX_BLEED_PASSES);
+}
+
+void forge_atlas_blit_grid(void* data, u32 index) {
+    AtlasBlitJob* job = (AtlasBlitJob*)data;
+    if (job->indices) index = job->indices[index];
+    const AtlasConfig* config = job->config;
+    const Image* assetImg = &job->images[index];
+    Vec2i atlasSize = job->atlasSize;
+
+    u32 subImagesPassed = job->subImageOffsets[index];
+    u32 subImageCount = (assetImg->width / config->gridSize) * (assetImg->height / config->gridSize);
+
+    u32 columnCount = atlasSize.w / config->gridSize;
+    u32 rowCount    = atlasSize.h / config->gridSize;
+    u32 row = 0, col = 0;
+
+    for (u32 subIdx = 0; subIdx < subImageCount; subIdx++) {
+        if (config->priority == AtlasPriority::COLUMN_FIRST) {
+            col = (subImagesPassed + subIdx) / rowCount;
+            row = (subImagesPassed + subIdx) % rowCount;
+        } else {
+            col = (subImagesPassed + subIdx) % columnCount;
+            row = (subImagesPassed + subIdx) / columnCount;
+        }
+
+        u32 subColumnCount = assetImg->width / config->gridSize;
+        u32 convertedSubIdx = (config->subGridType == AtlasSubGrid::STANDARD) ? subIdx : gSubGridConversionLUT[as_index(config->subGridType)][subIdx];
+        u32 subCol = convertedSubIdx / subColumnCount;
+        u32 subRow = convertedSubIdx % subColumnCount;
+
+        // Remap once per tile, then copy the whole tile row by row
+        u64 destPixel = ((u64)row * config->gridSize * atlasSize.w) + (col * config->gridSize);
+        u64 srcPixel = ((u64)subCol * config->gridSize * assetImg->width) + (subRow * config->gridSize);
+
+        u8* dest = job->atlasImgData + destPixel * blit::BYTES_PER_PIXEL;
+        const u8* src = assetImg->data + srcPixel * blit::BYTES_PER_PIXEL;
+        blit::rect(dest, atlasSize.w, src, assetImg->width, config->gridSize, config->gridSize);
+
+        // Tiles sit edge to edge, so bleeding stays within each tile
+        if (config->alphaBleed) blit::bleed(dest, atlasSize.w, config->gridSize, config->gridSize, CONFIG_ATLAS_MAX_BLEED_PASSES);
+    }
+}
+
+void forge_atlas_stream_image(void* data, u32 index) {
+    AtlasStreamJob* job = (AtlasStreamJob*)data;
+    AtlasBlitJob* blitJob = job->blitJob;
+    Image* assetImg = &job->decodeJob->images[index];
+
+    // Duplicates & images that didn't fit are never decoded again
+    if (blitJob->assets && (!blitJob->rects[index].was_packed || blitJob->assets[index].data.aliasOf >= 0)) return;
+
+    bool isResident = assetImg->data != NULL;
+    if (!isResident) {
+        // The layout was made for the size in the header, a file changed since can't be copied over
+        Vec2i measuredSize = { assetImg->width, assetImg->height };
+        forge_atlas_decode_image(job->decodeJob, index);
+        if (!assetImg->data) return;
+
+        if (assetImg->width != measuredSize.w || assetImg->height != measuredSize.h) {
+            log_format(LOG_PREFIX_WARN "ATLAS > Image " ANSI_GREEN "'%s'" ANSI_RESET " changed size during the build",
+                       job->decodeJob->bundle->assets[index].fileName);
+            thread::atomic_increment(&job->decodeJob->failedCount);
+
+            stbi_image_free(assetImg->data);
+            assetImg->data = NULL;
+            return;
+        }
+    }
+
+    job->blit(blitJob, index);
+
+    if (!isResident) {
+        stbi_image_free(assetImg->data);
+        assetImg->data = NULL;
+    }
+}
+
+i32 forge_resident_image_compare(const void* a, const void* b) {
+    u64 hashA = ((const ResidentImage*)a)->nameHash;
+    u64 hashB = ((const ResidentImage*)b)->nameHash;
+    return (hashA > hashB) - (hashA < hashB);
+}
+
+// Hands images decoded by an earlier rebuild back to the bundle, anything left over belonged to a changed or removed file
+void forge_atlas_take_resident_images(const AssetConfig* config, Bundle* bundle, Image* images) {
+    auto* resident = &gPersistent.residentImages[as_index(config->assetType)];
+
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        Asset* asset = &bundle->assets[i];
+
+        // Entries are sorted by name hash, see 'forge_atlas_keep_resident_images'
+        u32 low = 0;
+        u32 high = resident->count;
+        while (low < high) {
+            u32 mid = low + (high - low) / 2;
+            if (resident->entries[mid].nameHash < asset->nameHash) low = mid + 1;
+            else high = mid;
+        }
+
+        if (low == resident->count) continue;
+
+        ResidentImage* entry = &resident->entries[low];
+        if (!entry->image.data || entry->nameHash != asset->nameHash || entry->contentHash != asset->contentHash) continue;
+
+        images[i] = entry->image;
+        asset->data.sourceSize = { entry->image.width, entry->image.height };
+        asset->data.trim = entry->trim;
+        asset->data.pixelHash = entry->pixelHash;
+
+        entry->image.data = NULL;
+    }
+
+    for (u32 r = 0; r < resident->count; r++) {
+        if (resident->entries[r].image.data) stbi_image_free(resident->entries[r].image.data);
+    }
+
+    resident->count = 0;
+}
+
+void forge_atlas_keep_resident_images(const AssetConfig* config, const Bundle* bundle, Image* images) {
+    auto* resident = &gPersistent.residentImages[as_index(config->assetType)];
+
+    if (resident->capacity < bundle->assetCount) {
+        ResidentImage* entries = (ResidentImage*)memory::alloc(sizeof(ResidentImage) * bundle->assetCount);
+        if (!entries) return; // The images are simply decoded again next rebuild
+
+        if (resident->entries) memory::free(resident->entries);
+        resident->entries = entries;
+        resident->capacity = bundle->assetCount;
+    }
+
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        if (!images[i].data) continue;
+
+        const Asset* asset = &bundle->assets[i];
+        ResidentImage* entry = &resident->entries[resident->count++];
+        entry->nameHash = asset->nameHash;
+        entry->contentHash = asset->contentHash;
+        entry->image = images[i];
+        entry->trim = asset->data.trim;
+        entry->pixelHash = asset->data.pixelHash;
+
+        images[i].data = NULL;
+    }
+
+    qsort(resident->entries, resident->count, sizeof(ResidentImage), forge_resident_image_compare);
+}
+
+u32 forge_atlas_get_contained_mip_level_count(const AtlasConfig* config) {
+    u32 padding = (config->type == AtlasType::BEST_FIT) ? config->padding : 0;
+    return mip::get_contained_level_count(config->mipFilter, padding);
+}
+
+u32 forge_atlas_get_mip_level_count(const AtlasConfig* config, Vec2i size) {
+    u32 levelCount = mip::get_level_count(size.w, size.h);
+    if (config->mipLevelCount < levelCount) levelCount = (config->mipLevelCount > 0) ? config->mipLevelCount : 1;
+    if (levelCount > CONFIG_ATLAS_MAX_MIP_LEVELS) levelCount = CONFIG_ATLAS_MAX_MIP_LEVELS;
+
+    // Levels that would sample the neighbouring images are dropped
+    u32 containedCount = forge_atlas_get_contained_mip_level_count(config);
+    if (levelCount > containedCount) levelCount = containedCount;
+
+    return levelCount;
+}
+
+void forge_atlas_get_path(const AssetConfig* config, char* buffer) {
+    strcpy(buffer, CONFIG_RESOURCE_PATH "/atlas/");
+    strcat(buffer, config->type);
+    strcat(buffer, ".png");
+}
+
+void forge_atlas_get_cache_path(const AssetConfig* config, char* buffer) {
+    strcpy(buffer, CONFIG_TEMP_PATH "/");
+    strcat(buffer, config->type);
+    strcat(buffer, ".atlas");
+}
+
+// The first page keeps the atlas path, then 'sprite.mip1.png', 'sprite.page1.png', 'sprite.page1.mip1.png', ...
+void forge_atlas_get_page_path(const char* atlasPath, u32 page, u32 mipLevel, char* buffer) {
+    strcpy(buffer, atlasPath);
+    char* suffix = buffer + strlen(buffer) - strlen(".png");
+
+    if (page > 0) suffix += sprintf(suffix, ".page%u", page);
+    if (mipLevel > 0) suffix += sprintf(suffix, ".mip%u", mipLevel);
+    strcpy(suffix, ".png");
+}
+
+// Page & mip level pngs of an earlier build with more of either would otherwise be left behind next to the new ones
+void forge_atlas_remove_stale_outputs(const char* atlasPath, u32 pageCount, u32 mipLevelCount) {
+    bool hasMipPngs = forge_get_bc_format() == bcn::Format::NONE;
+
+    // Without block compression the dds of an earlier build would be left behind as well
+    if (hasMipPngs) {
+        char ddsPathStr[MAX_PATH] = "";
+        strcpy(ddsPathStr, atlasPath);
+        strcpy(ddsPathStr + strlen(ddsPathStr) - strlen(".png"), ".dds");
+        if (file::exists(ddsPathStr)) file::remove(ddsPathStr);
+    }
+
+    for (u32 p = 0; p < CONFIG_ATLAS_MAX_PAGES; p++) {
+        for (u32 i = 0; i < CONFIG_ATLAS_MAX_MIP_LEVELS; i++) {
+            bool isCurrent = p < pageCount && (i == 0 || (hasMipPngs && i < mipLevelCount));
+            if (isCurrent) continue;
+
+            char pathStr[MAX_PATH] = "";
+            forge_atlas_get_page_path(atlasPath, p, i, pathStr);
+            if (file::exists(pathStr)) file::remove(pathStr);
+        }
+    }
+}
+
+// Compared field by field, the padding between the bools & enums isn't guaranteed to match between a cached & a live config
+bool forge_atlas_config_equal(const AtlasConfig* a, const AtlasConfig* b) {
+    return a->type == b->type &&
+           a->alphaBleed == b->alphaBleed &&
+           a->mipLevelCount == b->mipLevelCount &&
+           a->mipFilter == b->mipFilter &&
+           a->padding == b->padding &&
+           a->extrudeEdges == b->extrudeEdges &&
+           a->trimTransparent == b->trimTransparent &&
+           a->allowRotation == b->allowRotation &&
+           a->gridSize == b->gridSize &&
+           a->activeLength == b->activeLength &&
+           a->subGridType == b->subGridType &&
+           a->orientation == b->orientation &&
+           a->priority == b->priority;
+}
+
+// Atlases are only rebuilt when their images change, so switching the config or the block compression has to be caught separately
+bool forge_atlas_is_stale(const AssetConfig* config) {
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+    if (!file::exists(cachePath)) return true;
+
+    file::Mapping cacheMap = {};
+    if (!file::map(cachePath, &cacheMap)) return true;
+
+    const AtlasCacheHeader* header = (const AtlasCacheHeader*)cacheMap.data;
+    bool isStale = cacheMap.size < sizeof(AtlasCacheHeader) || header->magic != CONFIG_ATLAS_CACHE_MAGIC || header->version != CONFIG_ATLAS_CACHE_VERSION ||
+                   !forge_atlas_config_equal(&header->config, &config->atlas) || header->bcFormat != forge_get_bc_format();
+
+    file::unmap(&cacheMap);
+    return isStale;
+}
+
+// Atlases of types skipped this run weren't generated, their description is restored from the cache header instead
+bool forge_atlas_load_info(const AssetConfig* config) {
+    auto* atlas = &gPersistent.atlas[as_index(config->assetType)];
+    if (atlas->size.w > 0) return true;
+
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+    if (!file::exists(cachePath)) return false;
+
+    file::Mapping cacheMap = {};
+    if (!file::map(cachePath, &cacheMap)) return false;
+
+    const AtlasCacheHeader* header = (const AtlasCacheHeader*)cacheMap.data;
+    bool isValid = cacheMap.size >= sizeof(AtlasCacheHeader) &&
+                   header->magic == CONFIG_ATLAS_CACHE_MAGIC &&
+                   header->version == CONFIG_ATLAS_CACHE_VERSION;
+
+    if (isValid) {
+        atlas->config = header->config;
+        atlas->size = header->size;
+        atlas->pageCount = header->pageCount;
+        atlas->mipLevelCount = forge_atlas_get_mip_level_count(&header->config, header->size);
+        atlas->elementLimit = header->assetCount;
+    }
+
+    file::unmap(&cacheMap);
+    return isValid;
+}
+
+// Caches restored from the store come without pixels, they're read back from the page pngs which hold the exact same ones.
+// Returns false if there is no complete cache afterwards.
+bool forge_atlas_complete_cache(const AssetConfig* config) {
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+    if (!file::exists(cachePath)) return false;
+
+    file::Mapping cacheMap = {};
+    if (!file::map(cachePath, &cacheMap)) return false;
+
+    const AtlasCacheHeader* header = (const AtlasCacheHeader*)cacheMap.data;
+    bool isValid = cacheMap.size >= sizeof(AtlasCacheHeader) &&
+                   header->magic == CONFIG_ATLAS_CACHE_MAGIC &&
+                   header->version == CONFIG_ATLAS_CACHE_VERSION &&
+                   header->pageCount > 0 && header->pageCount <= CONFIG_ATLAS_MAX_PAGES;
+
+    u64 tableSize = isValid ? sizeof(AtlasCacheHeader) + sizeof(AtlasCacheEntry) * (u64)header->assetCount : 0;
+    if (!isValid || cacheMap.size != tableSize) {
+        file::unmap(&cacheMap);
+        return isValid;
+    }
+
+    char atlasPathStr[MAX_PATH] = "";
+    char writePath[MAX_PATH] = "";
+    forge_atlas_get_path(config, atlasPathStr);
+    sprintf(writePath, "%s.%lu.tmp", cachePath, (unsigned long)GetCurrentThreadId());
+
+    u64 pageSize = (u64)header->size.w * header->size.h * 4;
+    u8* pixels = (u8*)memory::alloc(pageSize * header->pageCount);
+    bool success = pixels != NULL;
+
+    for (u32 p = 0; p < header->pageCount && success; p++) {
+        char pagePathStr[MAX_PATH] = "";
+        forge_atlas_get_page_path(atlasPathStr, p, 0, pagePathStr);
+
+        i32 width = 0;
+        i32 height = 0;
+        i32 channels = 0;
+        u8* data = stbi_load(pagePathStr, &width, &height, &channels, 4);
+
+        success = data && width == header->size.w && height == header->size.h;
+        if (success) memory::copy(pixels + p * pageSize, data, pageSize);
+        if (data) stbi_image_free(data);
+    }
+
+    if (success) {
+        file::File cacheFile = file::open(writePath, file::Mode::WRITE, true);
+        success = cacheFile.handle &&
+                  forge_file_write_large(&cacheFile, cacheMap.data, tableSize) &&
+                  forge_file_write_large(&cacheFile, pixels, pageSize * header->pageCount);
+        file::close(&cacheFile);
+    }
+
+    if (pixels) memory::free(pixels);
+    file::unmap(&cacheMap);
+
+    if (success) success = file::replace(writePath, cachePath);
+    if (file::exists(writePath)) file::remove(writePath);
+
+    return success;
+}
+
+// Patches only the changed images into the previous atlas, as long as the layout stays identical.
+// NOTE: On failure, any images decoded here stay loaded so a full rebuild doesn't decode them twice.
+bool forge_atlas_try_patch(const AssetConfig* config, Bundle* bundle, Image* images, Vec2i* outSize, u32* outPageCount, unsigned char** outData) {
+    if (!forge_atlas_complete_cache(config)) return false;
+
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+
+    file::Mapping cacheMap = {};
+    if (!file::map(cachePath, &cacheMap)) return false;
+
+    const AtlasCacheHeader* header = (const AtlasCacheHeader*)cacheMap.data;
+    const AtlasCacheEntry* entries = (const AtlasCacheEntry*)(cacheMap.data + sizeof(AtlasCacheHeader));
+    const u8* pixels = cacheMap.data + sizeof(AtlasCacheHeader) + sizeof(AtlasCacheEntry) * (u64)bundle->assetCount;
+
+    bool success = false;
+    u32 changedCount = 0;
+    u32* changedIndices = NULL;
+    u32* subImageOffsets = NULL;
+    AtlasDecodeJob decodeJob = { bundle, images, &config->atlas, 0 };
+    AtlasBlitJob blitJob = { &config->atlas, images, NULL };
+
+    // Any difference in the set of images or in the atlas config requires a full repack
+    u64 pixelSize = 0;
+    bool isValid = cacheMap.size >= sizeof(AtlasCacheHeader) &&
+                   header->magic == CONFIG_ATLAS_CACHE_MAGIC &&
+                   header->version == CONFIG_ATLAS_CACHE_VERSION &&
+                   header->assetCount == bundle->assetCount &&
+                   forge_atlas_config_equal(&header->config, &config->atlas);
+
+    if (isValid) {
+        pixelSize = (u64)header->size.w * header->size.h * 4 * header->pageCount;
+        isValid = header->pageCount > 0 && header->pageCount <= CONFIG_ATLAS_MAX_PAGES && cacheMap.size == (u64)(pixels - cacheMap.data) + pixelSize;
+    }
+
+    if (!isValid) goto exit_atlas_patch;
+
+    changedIndices = (u32*)memory::alloc(sizeof(u32) * bundle->assetCount);
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        const Asset* asset = &bundle->assets[i];
+        if (entries[i].nameHash != asset->nameHash) goto exit_atlas_patch;
+
+        if (entries[i].contentHash != asset->contentHash) {
+            changedIndices[changedCount++] = i;
+        }
+    }
+
+    // Decode only the changed images, their sizes decide whether the layout can be kept
+    for (u32 i = 0; i < changedCount; i++) {
+        forge_atlas_decode_image(&decodeJob, changedIndices[i]);
+    }
+
+    if (decodeJob.failedCount > 0) goto exit_atlas_patch;
+
+    // Trimmed images also have to keep their visible bounds, and images shared between duplicates can't change in place
+    for (u32 i = 0; i < changedCount; i++) {
+        u32 idx = changedIndices[i];
+        if (images[idx].width != entries[idx].width || images[idx].height != entries[idx].height) goto exit_atlas_patch;
+        if (memcmp(&bundle->assets[idx].data.trim, &entries[idx].trim, sizeof(geometry::Rectangle)) != 0) goto exit_atlas_patch;
+        if (entries[idx].aliasOf >= 0) goto exit_atlas_patch;
+    }
+
+    for (u32 j = 0; changedCount > 0 && j < bundle->assetCount; j++) {
+        i32 original = entries[j].aliasOf;
+        if (original < 0 || original >= (i32)bundle->assetCount) continue;
+        if (entries[original].contentHash != bundle->assets[original].contentHash) goto exit_atlas_patch;
+    }
+
+    // Restore the previous layout
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        Asset* asset = &bundle->assets[i];
+
+        images[i].width = entries[i].width;
+        images[i].height = entries[i].height;
+        asset->data.rect = entries[i].rect;
+        asset->data.trim = entries[i].trim;
+        asset->data.sourceSize = { entries[i].width, entries[i].height };
+        asset->data.isRotated = entries[i].isRotated != 0;
+        asset->data.aliasOf = entries[i].aliasOf;
+        asset->data.page = entries[i].page;
+    }
+
+    *outSize = header->size;
+    *outPageCount = header->pageCount;
+    *outData = (unsigned char*)memory::alloc(pixelSize);
+    memory::copy(*outData, pixels, pixelSize);
+
+    // Copy over the changed images
+    blitJob.indices = changedIndices;
+    blitJob.atlasSize = header->size;
+    blitJob.atlasImgData = *outData;
+
+    if (config->atlas.type == AtlasType::BEST_FIT) {
+        stbrp_rect* rects = (stbrp_rect*)memory::alloc(sizeof(stbrp_rect) * bundle->assetCount);
+        i32 padding = (i32)config->atlas.padding;
+        for (u32 i = 0; i < bundle->assetCount; i++) {
+            i32 w = (entries[i].rect.width + padding * 2 + 3) & ~3;
+            i32 h = (entries[i].rect.height + padding * 2 + 3) & ~3;
+            rects[i] = { (i32)i, w, h, entries[i].rect.x - padding, entries[i].rect.y - padding, 1 };
+        }
+
+        blitJob.rects = rects;
+        blitJob.assets = bundle->assets;
+        thread::pool_dispatch(&gPool, changedCount, forge_atlas_blit_best_fit, &blitJob);
+        memory::free(rects);
+    } else {
+        subImageOffsets = (u32*)memory::alloc(sizeof(u32) * bundle->assetCount);
+
+        u32 subImagesPassed = 0;
+        for (u32 i = 0; i < bundle->assetCount; i++) {
+            subImageOffsets[i] = subImagesPassed;
+            subImagesPassed += (images[i].width / config->atlas.gridSize) * (images[i].height / config->atlas.gridSize);
+        }
+
+        blitJob.subImageOffsets = subImageOffsets;
+        thread::pool_dispatch(&gPool, changedCount, forge_atlas_blit_grid, &blitJob);
+    }
+
+    log_format("- Patched %u of %u images into atlas " ANSI_GREEN "'%s'" ANSI_RESET, changedCount, bundle->assetCount, config->type);
+    success = true;
+
+exit_atlas_patch:
+    if (changedIndices) memory::free(changedIndices);
+    if (subImageOffsets) memory::free(subImageOffsets);
+    file::unmap(&cacheMap);
+
+    return success;
+}
+
+void forge_atlas_save_cache(const AssetConfig* config, const Bundle* bundle, const Image* images, Vec2i atlasSize, u32 pageCount, const unsigned char* atlasImgData) {
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+
+    u64 tableSize = sizeof(AtlasCacheHeader) + sizeof(AtlasCacheEntry) * (u64)bundle->assetCount;
+    u8* table = (u8*)memory::alloc(tableSize);
+
+    AtlasCacheHeader* header = (AtlasCacheHeader*)table;
+    header->magic = CONFIG_ATLAS_CACHE_MAGIC;
+    header->version = CONFIG_ATLAS_CACHE_VERSION;
+    header->assetCount = bundle->assetCount;
+    header->pageCount = pageCount;
+    header->size = atlasSize;
+    header->config = config->atlas;
+    header->bcFormat = forge_get_bc_format();
+
+    AtlasCacheEntry* entries = (AtlasCacheEntry*)(table + sizeof(AtlasCacheHeader));
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        const Asset* asset = &bundle->assets[i];
+
+        entries[i].nameHash = asset->nameHash;
+        entries[i].contentHash = asset->contentHash;
+        entries[i].width = images[i].width;
+        entries[i].height = images[i].height;
+        entries[i].rect = asset->data.rect;
+        entries[i].trim = asset->data.trim;
+        entries[i].isRotated = asset->data.isRotated ? 1 : 0;
+        entries[i].aliasOf = asset->data.aliasOf;
+        entries[i].page = asset->data.page;
+    }
+
+    u64 rowSize = (u64)atlasSize.w * 4;
+    u32 rowCount = (u32)atlasSize.h * pageCount;
+
+    // Patch builds only change a few images, rows that are already on disk are left alone if the cache has the same shape
+    u32* dirtyRows = NULL;
+    u32 dirtyCount = 0;
+
+    file::Mapping cacheMap = {};
+    if (file::exists(cachePath) && file::map(cachePath, &cacheMap)) {
+        const AtlasCacheHeader* cachedHeader = (const AtlasCacheHeader*)cacheMap.data;
+        bool isSameShape = cacheMap.size == tableSize + rowSize * rowCount &&
+                           cachedHeader->magic == header->magic &&
+                           cachedHeader->version == header->version &&
+                           cachedHeader->assetCount == header->assetCount &&
+                           cachedHeader->pageCount == header->pageCount &&
+                           cachedHeader->size.w == header->size.w &&
+                           cachedHeader->size.h == header->size.h &&
+                           cachedHeader->bcFormat == header->bcFormat &&
+                           forge_atlas_config_equal(&cachedHeader->config, &header->config);
+
+        if (isSameShape) {
+            const u8* cachedPixels = cacheMap.data + tableSize;
+            dirtyRows = (u32*)memory::alloc(sizeof(u32) * (rowCount > 0 ? rowCount : 1));
+
+            for (u32 r = 0; r < rowCount; r++) {
+                if (memcmp(cachedPixels + r * rowSize, atlasImgData + r * rowSize, rowSize) != 0) dirtyRows[dirtyCount++] = r;
+            }
+        }
+
+        file::unmap(&cacheMap);
+    }
+
+    if (dirtyRows) {
+        // Pixels go first & the table last, an interrupted write then only leaves images that look changed
+        file::File cacheFile = file::open(cachePath, file::Mode::UPDATE, true);
+        bool success = cacheFile.handle != NULL;
+
+        for (u32 i = 0; i < dirtyCount && success; ) {
+            u32 first = dirtyRows[i];
+            u32 last = first;
+            while (++i < dirtyCount && dirtyRows[i] == last + 1) last++;
+
+            success = file::set_offset(&cacheFile, (i64)(tableSize + first * rowSize), file::Offset::SET) &&
+                      forge_file_write_large(&cacheFile, atlasImgData + first * rowSize, (last - first + 1) * rowSize);
+        }
+
+        if (success) success = file::set_offset_start(&cacheFile) && file::write(&cacheFile, table, (i32)tableSize);
+        file::close(&cacheFile);
+        memory::free(dirtyRows);
+
+        // A cache that couldn't be updated is written out in full instead
+        if (success) {
+            memory::free(table);
+            return;
+        }
+    }
+
+    file::File cacheFile = file::open(cachePath, file::Mode::WRITE, true);
+    file::write(&cacheFile, table, (i32)tableSize);
+    forge_file_write_large(&cacheFile, atlasImgData, rowSize * rowCount);
+    file::close(&cacheFile);
+
+    memory::free(table);
+}
+
+// Fills 'outLevels' with the base level followed by each downsampled level, every level after the base must be released with 'memory::free'
+u32 forge_atlas_build_mips(const AtlasConfig* config, const u8* pixels, Vec2i size, bcn::Surface* outLevels) {
+    u32 levelCount = forge_atlas_get_mip_level_count(config, size);
+
+    outLevels[0] = { pixels, size.w, size.h };
+
+    for (u32 i = 1; i < levelCount; i++) {
+        const bcn::Surface* prev = &outLevels[i - 1];
+        i32 width = (prev->width > 1) ? prev->width / 2 : 1;
+        i32 height = (prev->height > 1) ? prev->height / 2 : 1;
+
+        u8* level = (u8*)memory::alloc((u64)width * height * 4);
+        mip::downsample(prev->pixels, prev->width, prev->height, level, config->mipFilter, &gPool);
+        outLevels[i] = { level, width, height };
+    }
+
+    return levelCount;
+}
+
+i32 forge_atlas_alias_key_compare(const void* a, const void* b) {
+    const AtlasAliasKey* keyA = (const AtlasAliasKey*)a;
+    const AtlasAliasKey* keyB = (const AtlasAliasKey*)b;
+
+    if (keyA->pixelHash != keyB->pixelHash) return (keyA->pixelHash > keyB->pixelHash) ? 1 : -1;
+    return (keyA->index > keyB->index) - (keyA->index < keyB->index);
+}
+
+// Streamed images are decoded again just for the comparison, which only images sharing a pixel hash get to
+bool forge_atlas_is_same_asset(AtlasDecodeJob* job, u32 indexA, u32 indexB) {
+    const geometry::Rectangle* trimA = &job->bundle->assets[indexA].data.trim;
+    const geometry::Rectangle* trimB = &job->bundle->assets[indexB].data.trim;
+    if (trimA->width != trimB->width || trimA->height != trimB->height) return false;
+    if (trimA->width == 0 || trimA->height == 0) return true;
+
+    Image* imageA = &job->images[indexA];
+    Image* imageB = &job->images[indexB];
+    bool isLoadedA = imageA->data != NULL;
+    bool isLoadedB = imageB->data != NULL;
+
+    if (!isLoadedA) forge_atlas_decode_image(job, indexA);
+    if (!isLoadedB) forge_atlas_decode_image(job, indexB);
+
+    bool isSame = imageA->data && imageB->data && forge_atlas_is_same_image(imageA, trimA, imageB, trimB);
+
+    if (!isLoadedA && imageA->data) {
+        stbi_image_free(imageA->data);
+        imageA->data = NULL;
+    }
+
+    if (!isLoadedB && imageB->data) {
+        stbi_image_free(imageB->data);
+        imageB->data = NULL;
+    }
+
+    return isSame;
+}
+
+// Points every duplicate at the first identical image, only images sharing a pixel hash are compared.
+// NOTE: Sorting by (hash, index) keeps the same originals as comparing each image against all earlier ones.
+void forge_atlas_find_aliases(AtlasDecodeJob* job) {
+    Bundle* bundle = job->bundle;
+    AtlasAliasKey* keys = (AtlasAliasKey*)memory::alloc(sizeof(AtlasAliasKey) * bundle->assetCount);
+    if (!keys) return; // Every image is simply packed on its own
+
+    for (u32 i = 0; i < bundle->assetCount; i++) keys[i] = { bundle->assets[i].data.pixelHash, i };
+    qsort(keys, bundle->assetCount, sizeof(AtlasAliasKey), forge_atlas_alias_key_compare);
+
+    for (u32 runStart = 0; runStart < bundle->assetCount;) {
+        u32 runEnd = runStart + 1;
+        while (runEnd < bundle->assetCount && keys[runEnd].pixelHash == keys[runStart].pixelHash) runEnd++;
+
+        for (u32 k = runStart + 1; k < runEnd; k++) {
+            u32 i = keys[k].index;
+            Asset* asset = &bundle->assets[i];
+
+            for (u32 o = runStart; o < k; o++) {
+                u32 j = keys[o].index;
+                const Asset* other = &bundle->assets[j];
+                if (other->data.aliasOf >= 0) continue;
+
+                if (forge_atlas_is_same_asset(job, i, j)) {
+                    asset->data.aliasOf = (i32)j;
+                    break;
+                }
+            }
+        }
+
+        runStart = runEnd;
+    }
+
+    memory::free(keys);
+}
+
+// Depth of the deepest folder both paths are in, 0 when they only share the root
+u32 forge_atlas_get_shared_folder_depth(const char* pathA, const char* pathB) {
+    u32 depth = 0;
+    for (u32 i = 0; pathA[i] != '\0' && pathA[i] == pathB[i]; i++) {
+        if (pathA[i] == '/') depth++;
+    }
+
+    return depth;
+}
+
+// Spreads images that don't fit into a single atlas over as few pages as it takes, every page ends up the same size.
+// Images come in bundle order, which keeps each folder together, and pages preferably end where a folder does: sprites
+// of the same folder are usually drawn together, so their batches rarely need more than one page.
+bool forge_atlas_pack_pages(const AssetConfig* config, Bundle* bundle, stbrp_rect* rects, Vec2i* outSize, u32* outPageCount, u64* outUsedArea) {
+    Vec2i minSize = { CONFIG_ATLAS_MIN_WIDTH, CONFIG_ATLAS_MIN_HEIGHT };
+    Vec2i maxSize = { CONFIG_ATLAS_MAX_WIDTH, CONFIG_ATLAS_MAX_HEIGHT };
+
+    *outSize = Vec2i();
+    *outPageCount = 0;
+    *outUsedArea = 0;
+
+    for (u32 start = 0; start < bundle->assetCount;) {
+        if (*outPageCount == CONFIG_ATLAS_MAX_PAGES) {
+            log_format(LOG_PREFIX_WARN "ATLAS > Images need more than %u pages of %ix%i!", CONFIG_ATLAS_MAX_PAGES, maxSize.w, maxSize.h);
+            return false;
+        }
+
+        u32 remainingCount = bundle->assetCount - start;
+        u32 fitCount = pack::fill_page(&rects[start], remainingCount, maxSize, config->atlas.allowRotation);
+        if (fitCount == 0) {
+            log_format(LOG_PREFIX_WARN "ATLAS > Image " ANSI_GREEN "'%s'" ANSI_RESET " doesn't fit into a single page!", bundle->assets[start].fileName);
+            return false;
+        }
+
+        u64 fitArea = 0;
+        for (u32 i = start; i < start + fitCount; i++) fitArea += (u64)rects[i].w * rects[i].h;
+
+        // Step back to the boundary between the least related folders, as long as the page keeps at least half of its area
+        u32 cutCount = fitCount;
+        u64 cutArea = fitArea;
+
+        if (fitCount < remainingCount) {
+            u32 cutDepth = forge_atlas_get_shared_folder_depth(bundle->assets[start + fitCount - 1].fileName, bundle->assets[start + fitCount].fileName);
+            u64 keptArea = fitArea;
+
+            for (u32 k = fitCount - 1; k > 0 && cutDepth > 0; k--) {
+                keptArea -= (u64)rects[start + k].w * rects[start + k].h;
+                if (keptArea * 2 < fitArea) break;
+
+                u32 depth = forge_atlas_get_shared_folder_depth(bundle->assets[start + k - 1].fileName, bundle->assets[start + k].fileName);
+                if (depth < cutDepth) {
+                    cutDepth = depth;
+                    cutCount = k;
+                    cutArea = keptArea;
+                }
+            }
+        }
+
+        // Pages share one size, the furthest any layout reaches decides it
+        for (u32 i = start; i < start + cutCount; i++) {
+            bundle->assets[i].data.page = *outPageCount;
+
+            if (rects[i].x + rects[i].w > outSize->w) outSize->w = rects[i].x + rects[i].w;
+            if (rects[i].y + rects[i].h > outSize->h) outSize->h = rects[i].y + rects[i].h;
+        }
+
+        *outUsedArea += cutArea;
+        (*outPageCount)++;
+        start += cutCount;
+    }
+
+    // Rects are whole blocks, so their extents already are a multiple of pack::SIZE_STEP
+    if (outSize->w < minSize.w) outSize->w = minSize.w;
+    if (outSize->h < minSize.h) outSize->h = minSize.h;
+
+    return true;
+}
+
+// -- Atlas Store
+// Covers everything the atlas of a type is generated from, the contents of each image, the config & the output formats
+u64 forge_atlas_get_store_key(const AssetConfig* config, const Bundle* bundle) {
+    const u32 settingCount = 6;
+    u64 valueCount = settingCount + (u64)bundle->assetCount * 2;
+    u64* values = (u64*)memory::alloc(sizeof(u64) * valueCount);
+    if (!values) return 0;
+
+    values[0] = CONFIG_ATLAS_STORE_VERSION;
+    values[1] = CONFIG_ATLAS_CACHE_VERSION;
+    values[2] = hash::string(config->type);
+    values[3] = hash::xxh64(&config->atlas, sizeof(AtlasConfig));
+    values[4] = ((u64)as_index(forge_get_png_level()) << 32) | as_index(forge_get_bc_format());
+    values[5] = bundle->assetCount;
+
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        values[settingCount + i * 2] = bundle->assets[i].nameHash;
+        values[settingCount + i * 2 + 1] = bundle->assets[i].contentHash;
+    }
+
+    u64 key = hash::xxh64(values, sizeof(u64) * valueCount);
+    memory::free(values);
+    return key;
+}
+
+void forge_atlas_get_store_path(u64 key, char* buffer) {
+    sprintf(buffer, CONFIG_ATLAS_STORE_PATH "/%016llx" CONFIG_ATLAS_STORE_EXT, (unsigned long long)key);
+}
+
+// The png of each page, then either the dds or every mip level png, then the atlas cache
+u32 forge_atlas_get_output_paths(const AssetConfig* config, const char* atlasPath, u32 pageCount, u32 mipLevelCount, char (*outPaths)[MAX_PATH]) {
+    u32 pathCount = 0;
+    for (u32 p = 0; p < pageCount; p++) forge_atlas_get_page_path(atlasPath, p, 0, outPaths[pathCount++]);
+
+    if (forge_get_bc_format() != bcn::Format::NONE) {
+        strcpy(outPaths[pathCount], atlasPath);
+        strcpy(outPaths[pathCount] + strlen(outPaths[pathCount]) - strlen(".png"), ".dds");
+        pathCount++;
+    } else {
+        for (u32 p = 0; p < pageCount; p++) {
+            for (u32 i = 1; i < mipLevelCount; i++) forge_atlas_get_page_path(atlasPath, p, i, outPaths[pathCount++]);
+        }
+    }
+
+    forge_atlas_get_cache_path(config, outPaths[pathCount++]);
+    return pathCount;
+}
+
+// The atlas cache is stored without its pixels, they are a copy of the page pngs & would double the size of every entry
+void forge_atlas_store_save(const AssetConfig* config, u64 key, const char (*paths)[MAX_PATH], u32 pathCount) {
+    if (forge_get_atlas_store_budget() == 0 || key == 0) return;
+
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+
+    AtlasStoreHeader header = { CONFIG_ATLAS_STORE_MAGIC, CONFIG_ATLAS_STORE_VERSION, pathCount, 0, key };
+    AtlasStoreFile storeFiles[CONFIG_ATLAS_STORE_MAX_FILES] = {};
+    file::Mapping maps[CONFIG_ATLAS_STORE_MAX_FILES] = {};
+
+    char storePath[MAX_PATH] = "";
+    char writePath[MAX_PATH] = "";
+    forge_atlas_get_store_path(key, storePath);
+    sprintf(writePath, "%s.%lu.tmp", storePath, (unsigned long)GetCurrentThreadId());
+
+    file::File storeFile = {};
+    bool success = true;
+    u64 offset = sizeof(AtlasStoreHeader) + sizeof(AtlasStoreFile) * (u64)pathCount;
+
+    for (u32 i = 0; i < pathCount && success; i++) {
+        success = strlen(paths[i]) < MAX_PATH && file::map(paths[i], &maps[i]);
+        if (!success) break;
+
+        strcpy(storeFiles[i].path, paths[i]);
+        storeFiles[i].offset = offset;
+        storeFiles[i].size = maps[i].size;
+
+        if (strcmp(paths[i], cachePath) == 0) {
+            const AtlasCacheHeader* cacheHeader = (const AtlasCacheHeader*)maps[i].data;
+            success = maps[i].size >= sizeof(AtlasCacheHeader);
+            if (success) storeFiles[i].size = sizeof(AtlasCacheHeader) + sizeof(AtlasCacheEntry) * (u64)cacheHeader->assetCount;
+            success = success && storeFiles[i].size <= maps[i].size;
+        }
+
+        offset += storeFiles[i].size;
+    }
+
+    // An entry past the whole budget would only be evicted again right away
+    bool isStored = success && offset <= forge_get_atlas_store_budget();
+
+    if (isStored) {
+        storeFile = file::open(writePath, file::Mode::WRITE, true);
+        success = storeFile.handle &&
+                  file::write(&storeFile, &header, sizeof(AtlasStoreHeader)) &&
+                  file::write(&storeFile, storeFiles, (i32)(sizeof(AtlasStoreFile) * pathCount));
+    }
+
+    for (u32 i = 0; i < pathCount && isStored && success; i++) {
+        success = forge_file_write_large(&storeFile, maps[i].data, storeFiles[i].size);
+    }
+
+    file::close(&storeFile);
+
+    for (u32 i = 0; i < pathCount; i++) {
+        if (maps[i].data) file::unmap(&maps[i]);
+    }
+
+    if (success && !isStored) return;
+
+    if (!success || !file::replace(writePath, storePath)) {
+        if (file::exists(writePath)) file::remove(writePath);
+        log_format(LOG_PREFIX_WARN "ATLAS > Failed to store " ANSI_GREEN "'%s'" ANSI_RESET, storePath);
+    }
+}
+
+// Writes every stored output back & takes the layout from the stored atlas cache, nothing is decoded, packed or encoded
+bool forge_atlas_store_restore(const AssetConfig* config, Bundle* bundle, u64 key) {
+    if (forge_get_atlas_store_budget() == 0 || key == 0) return false;
+
+    char storePath[MAX_PATH] = "";
+    forge_atlas_get_store_path(key, storePath);
+    if (!file::exists(storePath)) return false;
+
+    file::Mapping storeMap = {};
+    if (!file::map(storePath, &storeMap)) return false;
+
+    trace::Scope scope = trace::begin("atlas.restore", config->type);
+    scope.byteCount = storeMap.size;
+
+    char cachePath[MAX_PATH] = "";
+    forge_atlas_get_cache_path(config, cachePath);
+
+    const AtlasStoreHeader* header = (const AtlasStoreHeader*)storeMap.data;
+    const AtlasStoreFile* storeFiles = (const AtlasStoreFile*)(storeMap.data + sizeof(AtlasStoreHeader));
+    const AtlasCacheHeader* cacheHeader = NULL;
+    const AtlasCacheEntry* cacheEntries = NULL;
+
+    bool success = storeMap.size >= sizeof(AtlasStoreHeader) &&
+                   header->magic == CONFIG_ATLAS_STORE_MAGIC &&
+                   header->version == CONFIG_ATLAS_STORE_VERSION &&
+                   header->key == key &&
+                   header->fileCount > 0 && header->fileCount <= CONFIG_ATLAS_STORE_MAX_FILES &&
+                   storeMap.size >= sizeof(AtlasStoreHeader) + sizeof(AtlasStoreFile) * (u64)header->fileCount;
+
+    // Validate everything before the first output is touched
+    for (u32 i = 0; success && i < header->fileCount; i++) {
+        const AtlasStoreFile* storeFile = &storeFiles[i];
+        success = storeFile->offset <= storeMap.size && storeFile->size <= storeMap.size - storeFile->offset &&
+                  memchr(storeFile->path, '\0', MAX_PATH) != NULL;
+
+        if (success && strcmp(storeFile->path, cachePath) == 0 && storeFile->size >= sizeof(AtlasCacheHeader)) {
+            cacheHeader = (const AtlasCacheHeader*)(storeMap.data + storeFile->offset);
+            cacheEntries = (const AtlasCacheEntry*)(storeMap.data + storeFile->offset + sizeof(AtlasCacheHeader));
+
+            success = cacheHeader->magic == CONFIG_ATLAS_CACHE_MAGIC &&
+                      cacheHeader->version == CONFIG_ATLAS_CACHE_VERSION &&
+                      cacheHeader->assetCount == bundle->assetCount &&
+                      cacheHeader->pageCount > 0 && cacheHeader->pageCount <= CONFIG_ATLAS_MAX_PAGES &&
+                      storeFile->size >= sizeof(AtlasCacheHeader) + sizeof(AtlasCacheEntry) * (u64)bundle->assetCount;
+        }
+    }
+
+    success = success && cacheHeader != NULL;
+
+    for (u32 i = 0; success && i < bundle->assetCount; i++) {
+        success = cacheEntries[i].nameHash == bundle->assets[i].nameHash && cacheEntries[i].contentHash == bundle->assets[i].contentHash;
+    }
+
+    // Every output is written next to its destination first & only swapped in once all of them were written,
+    // so a failed restore leaves the previous outputs untouched
+    char tempPaths[CONFIG_ATLAS_STORE_MAX_FILES][MAX_PATH] = {};
+    u32 writtenCount = 0;
+
+    for (u32 i = 0; success && i < header->fileCount; i++) {
+        const AtlasStoreFile* storeFile = &storeFiles[i];
+
+        // Room for '.<thread id>.tmp'
+        success = strlen(storeFile->path) + 16 < MAX_PATH;
+        if (!success) break;
+
+        sprintf(tempPaths[i], "%s.%lu.tmp", storeFile->path, (unsigned long)GetCurrentThreadId());
+
+        file::File outputFile = file::open(tempPaths[i], file::Mode::WRITE, true);
+        success = outputFile.handle && forge_file_write_large(&outputFile, storeMap.data + storeFile->offset, storeFile->size);
+        file::close(&outputFile);
+        writtenCount = i + 1;
+
+        if (!success) log_format(LOG_PREFIX_WARN "ATLAS > Failed to restore " ANSI_GREEN "'%s'" ANSI_RESET, storeFile->path);
+    }
+
+    for (u32 i = 0; success && i < header->fileCount; i++) {
+        success = file::replace(tempPaths[i], storeFiles[i].path);
+        if (!success) log_format(LOG_PREFIX_WARN "ATLAS > Failed to restore " ANSI_GREEN "'%s'" ANSI_RESET, storeFiles[i].path);
+    }
+
+    for (u32 i = 0; i < writtenCount; i++) {
+        if (file::exists(tempPaths[i])) file::remove(tempPaths[i]);
+    }
+
+    if (success) {
+        for (u32 i = 0; i < bundle->assetCount; i++) {
+            Asset* asset = &bundle->assets[i];
+            asset->data.rect = cacheEntries[i].rect;
+            asset->data.trim = cacheEntries[i].trim;
+            asset->data.sourceSize = { cacheEntries[i].width, cacheEntries[i].height };
+            asset->data.isRotated = cacheEntries[i].isRotated != 0;
+            asset->data.aliasOf = cacheEntries[i].aliasOf;
+            asset->data.page = cacheEntries[i].page;
+        }
+
+        u32 typeIdx = as_index(config->assetType);
+        gPersistent.atlas[typeIdx].config = config->atlas;
+        gPersistent.atlas[typeIdx].size = cacheHeader->size;
+        gPersistent.atlas[typeIdx].pageCount = cacheHeader->pageCount;
+        gPersistent.atlas[typeIdx].mipLevelCount = forge_atlas_get_mip_level_count(&config->atlas, cacheHeader->size);
+
+        // The png of the first page always comes first
+        forge_atlas_remove_stale_outputs(storeFiles[0].path, cacheHeader->pageCount, gPersistent.atlas[typeIdx].mipLevelCount);
+        gPersistent.atlas[typeIdx].elementLimit = bundle->assetCount;
+
+        scope.itemCount = header->fileCount;
+    }
+
+    file::unmap(&storeMap);
+    trace::end(&scope);
+
+    if (success) forge_cache_touch(storePath);
+    return success;
+}
+
+void forge_atlas_store_evict() {
+    u64 budget = forge_get_atlas_store_budget();
+    if (budget == 0) return;
+
+    trace::Scope scope = trace::begin("cache.evict", "store");
+
+    CacheUsage usage = {};
+    if (!forge_cache_trim(CONFIG_ATLAS_STORE_PATH, CONFIG_ATLAS_STORE_EXT, budget, &usage)) {
+        log_format(LOG_PREFIX_WARN "CACHE > Could not scan " ANSI_GREEN "'%s'" ANSI_RESET, CONFIG_ATLAS_STORE_PATH);
+        trace::end(&scope);
+        return;
+    }
+
+    scope.itemCount = usage.fileCount;
+    scope.byteCount = usage.size;
+    trace::end(&scope);
+
+    if (usage.evictedCount > 0) {
+        log_format("- Evicted %u stored atlases (%.1f MB), %u left (%.1f MB)", usage.evictedCount, usage.evictedSize / (1024.0 * 1024.0),
+                   usage.fileCount, usage.size / (1024.0 * 1024.0));
+    }
+}
+
+bool forge_generate_atlas(const AssetConfig* config, Bundle* bundle, u32 bundleIdx) {
+    if (!config && !bundle && bundleIdx >= as_index(BundleType::COUNT)) return false;
+
+    // Inputs that were built before only have their outputs restored
+    u64 storeKey = forge_atlas_get_store_key(config, bundle);
+    if (!forge_is_flag_set(Flags::FORCE_GENERATION) && forge_atlas_store_restore(config, bundle, storeKey)) {
+        log_format("- Restored atlas " ANSI_GREEN "'%s'" ANSI_RESET " from the store", config->type);
+        return true;
+    }
+
+    Image* images = (Image*)memory::alloc(sizeof(Image) * bundle->assetCount);
+    stbrp_rect* rects = (stbrp_rect*)memory::alloc(sizeof(stbrp_rect) * bundle->assetCount);
+    u32* subImageOffsets = NULL;
+
+    AtlasDecodeJob decodeJob = { bundle, images, &config->atlas, 0 };
+    AtlasBlitJob blitJob = { &config->atlas, images, rects };
+    AtlasStreamJob streamJob = { &decodeJob, &blitJob, NULL };
+
+    u64 decodedSize = 0;
+    bool isStreamed = false;
+
+    char atlasPathStr[GEM_MAX_STRING_LENGTH] = "";
+    forge_atlas_get_path(config, atlasPathStr);
+
+    Vec2i atlasSize = Vec2i();
+    u32 pageCount = 1;
+    unsigned char* atlasImgData = NULL;
+
+    // Decode, pack, blit & encode are traced one after another
+    trace::Scope stageScope = {};
+
+    if (config->atlas.type == AtlasType::COUNT) {
+        log_format(LOG_PREFIX_WARN "ATLAS > Cannot set type to its count!");
+        goto exit_generate_atlas;
+    }
+
+    {
+        u32 containedCount = forge_atlas_get_contained_mip_level_count(&config->atlas);
+        if (config->atlas.mipLevelCount > containedCount) {
+            log_format(LOG_PREFIX_WARN "ATLAS > Padding only keeps %u mip levels free of bleeding, the rest are dropped", containedCount);
+        }
+    }
+
+    if (forge_is_flag_set(Flags::WATCH)) forge_atlas_take_resident_images(config, bundle, images);
+
+    // Reuse the previous layout if only the contents of some images changed
+    if (!forge_is_flag_set(Flags::FORCE_GENERATION)) {
+        stageScope = trace::begin("atlas.patch", config->type);
+        if (forge_atlas_try_patch(config, bundle, images, &atlasSize, &pageCount, &atlasImgData)) {
+            trace::end(&stageScope);
+            goto write_atlas;
+        }
+        trace::end(&stageScope);
+    }
+
+    // Image sizes come from the file headers, bundles too large to keep decoded all at once are streamed into the atlas
+    stageScope = trace::begin("atlas.info", config->type);
+    stageScope.itemCount = bundle->assetCount;
+
+    thread::pool_dispatch(&gPool, bundle->assetCount, forge_atlas_read_image_info, &decodeJob);
+    if (decodeJob.failedCount > 0) goto exit_generate_atlas;
+
+    for (u32 i = 0; i < bundle->assetCount; i++) decodedSize += (u64)images[i].width * images[i].height * 4;
+    isStreamed = decodedSize > forge_get_decode_budget();
+    trace::end(&stageScope);
+
+    // Streamed grid atlases get by on the sizes alone, best fit ones still need the visible bounds & hash of each image
+    stageScope = trace::begin("atlas.decode", config->type);
+    stageScope.itemCount = bundle->assetCount;
+    stageScope.byteCount = decodedSize;
+
+    if (!isStreamed) {
+        thread::pool_dispatch(&gPool, bundle->assetCount, forge_atlas_decode_image, &decodeJob);
+    } else if (config->atlas.type == AtlasType::BEST_FIT) {
+        thread::pool_dispatch(&gPool, bundle->assetCount, forge_atlas_measure_image, &decodeJob);
+    }
+
+    if (decodeJob.failedCount > 0) goto exit_generate_atlas;
+    trace::end(&stageScope);
+
+    stageScope = trace::begin("atlas.pack", config->type);
+    stageScope.itemCount = bundle->assetCount;
+
+    // Identical images are packed once, grid atlases keep every tile since their position is their index
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        bundle->assets[i].data.aliasOf = -1;
+        bundle->assets[i].data.page = 0;
+    }
+
+    if (config->atlas.type == AtlasType::BEST_FIT) forge_atlas_find_aliases(&decodeJob);
+
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        const geometry::Rectangle* trim = &bundle->assets[i].data.trim;
+        i32 padding = (config->atlas.type == AtlasType::BEST_FIT) ? (i32)config->atlas.padding : 0;
+
+        rects[i].id = i;
+        // Pad to whole 4x4 blocks so block compression never mixes neighbouring images
+        rects[i].w = (trim->width + padding * 2 + 3) & ~3;
+        rects[i].h = (trim->height + padding * 2 + 3) & ~3;
+
+        // Duplicates take no space, they point at their original after packing
+        if (bundle->assets[i].data.aliasOf >= 0) {
+            rects[i].w = 0;
+            rects[i].h = 0;
+        }
+    }
+
+    switch (config->atlas.type) {
+        using enum AtlasType;
+        case BEST_FIT:
+            {
+                // Search down from the total area instead of doubling, every heuristic gets a go and the smallest atlas wins
+                pack::Result packResult = {};
+                Vec2i minSize = { CONFIG_ATLAS_MIN_WIDTH, CONFIG_ATLAS_MIN_HEIGHT };
+                Vec2i maxSize = { CONFIG_ATLAS_MAX_WIDTH, CONFIG_ATLAS_MAX_HEIGHT };
+
+                if (bundle->assetCount > pack::SEARCH_RECT_LIMIT) {
+                    log_format("- %u images are past the MaxRects limit of %u, packing with skyline only", bundle->assetCount, pack::SEARCH_RECT_LIMIT);
+                }
+
+                if (pack::find_best(rects, bundle->assetCount, minSize, maxSize, config->atlas.allowRotation, &gPool, &packResult)) {
+                    atlasSize = packResult.size;
+
+                    f64 efficiency = (f64)packResult.usedArea / ((f64)atlasSize.w * atlasSize.h) * 100.0;
+                    log_format("- Packed %u images into %ix%i using %s (%.1f%% efficiency)", bundle->assetCount,
+                               atlasSize.w, atlasSize.h, pack::get_heuristic_name(packResult.heuristic), efficiency);
+                } else {
+                    // Past the max size the images spill over into more pages
+                    u64 usedArea = 0;
+                    if (!forge_atlas_pack_pages(config, bundle, rects, &atlasSize, &pageCount, &usedArea)) {
+                        log_format(LOG_PREFIX_WARN "ATLAS > Images cannot be packed into a reasonable atlas size!");
+                        goto exit_generate_atlas;
+                    }
+
+                    f64 efficiency = (f64)usedArea / ((f64)atlasSize.w * atlasSize.h * pageCount) * 100.0;
+                    log_format("- Packed %u images onto %u pages of %ix%i using %s (%.1f%% efficiency)", bundle->assetCount,
+                               pageCount, atlasSize.w, atlasSize.h, pack::get_heuristic_name(pack::Heuristic::SKYLINE), efficiency);
+                }
+
+                trace::end(&stageScope);
+
+                // Copy over the pixels from each image into the atlas
+                stageScope = trace::begin("atlas.blit", config->type);
+                stageScope.itemCount = bundle->assetCount;
+                stageScope.byteCount = (u64)atlasSize.w * atlasSize.h * 4 * pageCount;
+
+                atlasImgData = (unsigned char*)memory::alloc((u64)atlasSize.w * atlasSize.h * 4 * pageCount);
+
+                u64 sourceArea = 0;
+                u64 trimmedArea = 0;
+                u32 rotatedCount = 0;
+
+                for (u32 i = 0; i < bundle->assetCount; i++) {
+                    if (rects[i].was_packed && bundle->assets[i].data.aliasOf < 0) {
+                        Asset* asset = &bundle->assets[i];
+                        const geometry::Rectangle* trim = &asset->data.trim;
+
+                        // The packer hands rotated rects back with their sides swapped
+                        i32 paddedWidth = (trim->width + (i32)config->atlas.padding * 2 + 3) & ~3;
+                        asset->data.isRotated = rects[i].w != paddedWidth;
+
+                        asset->data.rect.x      = rects[i].x + config->atlas.padding;
+                        asset->data.rect.y      = rects[i].y + config->atlas.padding;
+                        asset->data.rect.width  = asset->data.isRotated ? trim->height : trim->width;
+                        asset->data.rect.height = asset->data.isRotated ? trim->width : trim->height;
+
+                        sourceArea += (u64)images[i].width * images[i].height;
+                        trimmedArea += (u64)trim->width * trim->height;
+                        if (asset->data.isRotated) rotatedCount++;
+                    }
+                }
+
+                if (config->atlas.trimTransparent || config->atlas.allowRotation) {
+                    f64 trimmedPercentage = (sourceArea > 0) ? (1.0 - (f64)trimmedArea / sourceArea) * 100.0 : 0.0;
+                    log_format("- Trimmed %.1f%% transparent area, rotated %u of %u images", trimmedPercentage, rotatedCount, bundle->assetCount);
+                }
+
+                // Duplicates share the placement of their original, keeping their own trim offset
+                u32 aliasCount = 0;
+                u64 aliasArea = 0;
+
+                for (u32 i = 0; i < bundle->assetCount; i++) {
+                    Asset* asset = &bundle->assets[i];
+                    if (asset->data.aliasOf < 0) continue;
+
+                    const Asset* original = &bundle->assets[asset->data.aliasOf];
+                    asset->data.rect = original->data.rect;
+                    asset->data.isRotated = original->data.isRotated;
+                    asset->data.page = original->data.page;
+
+                    aliasCount++;
+                    aliasArea += (u64)original->data.rect.width * original->data.rect.height;
+                    log_format("  - Duplicate " ANSI_GREEN "'%s'" ANSI_RESET " -> " ANSI_GREEN "'%s'" ANSI_RESET, asset->fileName, original->fileName);
+                }
+
+                if (aliasCount > 0) {
+                    f64 savedPercentage = (f64)aliasArea / (f64)(trimmedArea + aliasArea) * 100.0;
+                    log_format("- Deduplicated %u of %u images, saving %.1f%% of the image area", aliasCount, bundle->assetCount, savedPercentage);
+                }
+
+                blitJob.assets = bundle->assets;
+                blitJob.atlasSize = atlasSize;
+                blitJob.atlasImgData = atlasImgData;
+                streamJob.blit = forge_atlas_blit_best_fit;
+                thread::pool_dispatch(&gPool, bundle->assetCount, isStreamed ? forge_atlas_stream_image : forge_atlas_blit_best_fit,
+                                      isStreamed ? (void*)&streamJob : (void*)&blitJob);
+                if (decodeJob.failedCount > 0) goto exit_generate_atlas;
+                trace::end(&stageScope);
+            }
             break;
         case GRID:
             {
@@ -623,50 +2499,31 @@ bool forge_generate_atlas(const AssetConfig* config, Bundle* bundle, u32 bundleI
                     atlasSize.h = temp;
                 }
 
-                atlasImgData = (unsigned char*)memory::alloc(atlasSize.w * atlasSize.h * 4);
+                trace::end(&stageScope);
 
                 // Copy over the pixels from each image into the atlas
+                stageScope = trace::begin("atlas.blit", config->type);
+                stageScope.itemCount = bundle->assetCount;
+                stageScope.byteCount = (u64)atlasSize.w * atlasSize.h * 4;
+
+                atlasImgData = (unsigned char*)memory::alloc(atlasSize.w * atlasSize.h * 4);
+                subImageOffsets = (u32*)memory::alloc(sizeof(u32) * bundle->assetCount);
+
                 u32 subImagesPassed = 0;
                 for (u32 i = 0; i < bundle->assetCount; i++) {
                     Image* assetImg = &images[i];
-                    u32 subImageCount = (assetImg->width / config->atlas.gridSize) * (assetImg->height / config->atlas.gridSize);
-
-                    u32 columnCount = atlasSize.w / config->atlas.gridSize;
-                    u32 rowCount    = atlasSize.h / config->atlas.gridSize;
-                    u32 row = 0, col = 0;
-
-                    for (u32 subIdx = 0; subIdx < subImageCount; subIdx++) {
-                        if (config->atlas.priority == AtlasPriority::COLUMN_FIRST) {
-                            col = (subImagesPassed + subIdx) / rowCount;
-                            row = (subImagesPassed + subIdx) % rowCount;
-                        } else {
-                            col = (subImagesPassed + subIdx) % columnCount;
-                            row = (subImagesPassed + subIdx) / columnCount;
-                        }
-
-                        u32 subColumnCount = assetImg->width / config->atlas.gridSize;
-                        u32 convertedSubIdx = (config->atlas.subGridType == AtlasSubGrid::STANDARD) ? subIdx : gSubGridConversionLUT[as_index(config->atlas.subGridType)][subIdx];
-                        u32 subCol = convertedSubIdx / subColumnCount;
-                        u32 subRow = convertedSubIdx % subColumnCount;
-
-                        for (u32 y = 0; y < config->atlas.gridSize; y++) {
-                            for (u32 x = 0; x < config->atlas.gridSize; x++) {
-                                u32 genPixel = (y * atlasSize.w) + (row * config->atlas.gridSize * atlasSize.w) + (col * config->atlas.gridSize) + x;
-                                genPixel *= 4;
-
-                                u32 assetPixel = (y * assetImg->width) + (subRow * config->atlas.gridSize) + (subCol * config->atlas.gridSize * assetImg->width) + x;
-                                assetPixel *= 4;
-
-                                atlasImgData[genPixel + 0] = assetImg->data[assetPixel + 0];
-                                atlasImgData[genPixel + 1] = assetImg->data[assetPixel + 1];
-                                atlasImgData[genPixel + 2] = assetImg->data[assetPixel + 2];
-                                atlasImgData[genPixel + 3] = assetImg->data[assetPixel + 3];
-                            }
-                        }
-                    }
-
-                    subImagesPassed += subImageCount;
+                    subImageOffsets[i] = subImagesPassed;
+                    subImagesPassed += (assetImg->width / config->atlas.gridSize) * (assetImg->height / config->atlas.gridSize);
                 }
+
+                blitJob.subImageOffsets = subImageOffsets;
+                blitJob.atlasSize = atlasSize;
+                blitJob.atlasImgData = atlasImgData;
+                streamJob.blit = forge_atlas_blit_grid;
+                thread::pool_dispatch(&gPool, bundle->assetCount, isStreamed ? forge_atlas_stream_image : forge_atlas_blit_grid,
+                                      isStreamed ? (void*)&streamJob : (void*)&blitJob);
+                if (decodeJob.failedCount > 0) goto exit_generate_atlas;
+                trace::end(&stageScope);
             }
             break;
         default:
@@ -677,16 +2534,91 @@ bool forge_generate_atlas(const AssetConfig* config, Bundle* bundle, u32 bundleI
             break;
     }
 
+    if (isStreamed) {
+        // NOTE: Windows only keeps the peak of the whole process, in watch mode that includes every earlier build
+        log_format("- Streamed %.1f MB of images into the atlas, at most %u decoded at a time (%.1f MB process peak working set so far)",
+                   decodedSize / (1024.0 * 1024.0), forge_get_job_count(), trace::get_peak_working_set() / (1024.0 * 1024.0));
+    }
+
     // -- SUCCESS --
+write_atlas:
     // Write out the atlas image
     bool success = false;
-    if (atlasImgData && atlasSize.w > 0 && atlasSize.h > 0) {
-        i32 stride = atlasSize.w * 4;
-        stbi_write_png(atlasPathStr, atlasSize.w, atlasSize.h, 4, atlasImgData, stride);
+    if (atlasImgData && atlasSize.w > 0 && atlasSize.h > 0 && pageCount > 0) {
+        // PNG, mip levels & the optional block compressed copy
+        stageScope = trace::begin("atlas.encode", config->type);
+        stageScope.itemCount = pageCount;
+        stageScope.byteCount = (u64)atlasSize.w * atlasSize.h * 4 * pageCount;
+
+        u64 pageSize = (u64)atlasSize.w * atlasSize.h * 4;
+
+        // Pages after the first get a png of their own, 'atlas.page1.png', 'atlas.page2.png', ...
+        for (u32 p = 0; p < pageCount; p++) {
+            char pagePathStr[MAX_PATH] = "";
+            forge_atlas_get_page_path(atlasPathStr, p, 0, pagePathStr);
+
+            if (!png::write(pagePathStr, atlasImgData + p * pageSize, atlasSize.w, atlasSize.h, forge_get_png_level(), &gPool)) {
+                log_format(LOG_PREFIX_WARN "ATLAS > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, pagePathStr);
+                goto exit_generate_atlas;
+            }
+        }
+
+        // Every mip level of the first page, then every mip level of the next one & so on
+        bcn::Surface mipLevels[CONFIG_ATLAS_MAX_PAGES * CONFIG_ATLAS_MAX_MIP_LEVELS] = {};
+        u32 mipLevelCount = forge_atlas_get_mip_level_count(&config->atlas, atlasSize);
+        bool hasWrittenMips = true;
+
+        for (u32 p = 0; p < pageCount; p++) {
+            forge_atlas_build_mips(&config->atlas, atlasImgData + p * pageSize, atlasSize, &mipLevels[p * mipLevelCount]);
+        }
+
+        // Block compressed copy for the GPU next to the png, mips & pages are stored in the same file
+        if (forge_get_bc_format() != bcn::Format::NONE) {
+            char ddsPathStr[GEM_MAX_STRING_LENGTH] = "";
+            strcpy(ddsPathStr, atlasPathStr);
+            strcpy(ddsPathStr + strlen(ddsPathStr) - strlen(".png"), ".dds");
+
+            if (!bcn::write_dds(ddsPathStr, mipLevels, mipLevelCount, pageCount, forge_get_bc_format(), &gPool)) {
+                log_format(LOG_PREFIX_WARN "ATLAS > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, ddsPathStr);
+                hasWrittenMips = false;
+            }
+        } else {
+            // Uncompressed mips get a png each, 'atlas.mip1.png', 'atlas.mip2.png', ... 'atlas.page1.mip1.png', ...
+            for (u32 p = 0; p < pageCount && hasWrittenMips; p++) {
+                for (u32 i = 1; i < mipLevelCount && hasWrittenMips; i++) {
+                    const bcn::Surface* level = &mipLevels[p * mipLevelCount + i];
+
+                    char mipPathStr[MAX_PATH] = "";
+                    forge_atlas_get_page_path(atlasPathStr, p, i, mipPathStr);
+
+                    if (!png::write(mipPathStr, level->pixels, level->width, level->height, forge_get_png_level(), &gPool)) {
+                        log_format(LOG_PREFIX_WARN "ATLAS > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, mipPathStr);
+                        hasWrittenMips = false;
+                    }
+                }
+            }
+        }
+
+        for (u32 p = 0; p < pageCount; p++) {
+            for (u32 i = 1; i < mipLevelCount; i++) memory::free((void*)mipLevels[p * mipLevelCount + i].pixels);
+        }
+
+        if (!hasWrittenMips) goto exit_generate_atlas;
+
+        forge_atlas_remove_stale_outputs(atlasPathStr, pageCount, mipLevelCount);
+        trace::end(&stageScope);
+
+        forge_atlas_save_cache(config, bundle, images, atlasSize, pageCount, atlasImgData);
+
+        char storePaths[CONFIG_ATLAS_STORE_MAX_FILES][MAX_PATH] = {};
+        u32 storePathCount = forge_atlas_get_output_paths(config, atlasPathStr, pageCount, mipLevelCount, storePaths);
+        forge_atlas_store_save(config, storeKey, storePaths, storePathCount);
 
         u32 typeIdx = as_index(config->assetType);
         gPersistent.atlas[typeIdx].config = config->atlas;
         gPersistent.atlas[typeIdx].size = atlasSize;
+        gPersistent.atlas[typeIdx].pageCount = pageCount;
+        gPersistent.atlas[typeIdx].mipLevelCount = mipLevelCount;
         gPersistent.atlas[typeIdx].elementLimit = bundle->assetCount;
 
         log_format("- Generated atlas: " ANSI_GREEN "'%s'" ANSI_RESET "", atlasPathStr);
@@ -697,7 +2629,11 @@ bool forge_generate_atlas(const AssetConfig* config, Bundle* bundle, u32 bundleI
 
     // -- FAILURE --
 exit_generate_atlas:
+    trace::end(&stageScope);
+
     if (images) {
+        if (forge_is_flag_set(Flags::WATCH)) forge_atlas_keep_resident_images(config, bundle, images);
+
         for (u32 i = 0; i < bundle->assetCount; i++) {
             unsigned char* data = images[i].data;
             if (data) stbi_image_free(data);
@@ -707,13 +2643,260 @@ exit_generate_atlas:
     }
 
     if (rects) memory::free(rects);
+    if (subImageOffsets) memory::free(subImageOffsets);
     if (atlasImgData) memory::free(atlasImgData);
 
     // -- END --
     return success;
 }
 
+// -- Sound
+void forge_sound_get_output_path(const Asset* asset, char* buffer) {
+    forge_get_flat_output_path(CONFIG_RESOURCE_PATH "/sound", asset, CONFIG_SOUND_EXT, buffer);
+}
+
+// Sounds are only rebuilt when their waves change, so switching the output format has to be caught separately
+bool forge_sound_is_stale(const Bundle* bundle) {
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        char outputPathStr[MAX_PATH] = "";
+        forge_sound_get_output_path(&bundle->assets[i], outputPathStr);
+
+        // Probed first, mapping a missing output would log an error on every clean build
+        if (!file::exists(outputPathStr)) return true;
+
+        file::Mapping map = {};
+        if (!file::map(outputPathStr, &map)) return true;
+
+        const AudioHeader* header = (const AudioHeader*)map.data;
+        bool isStale = map.size < sizeof(AudioHeader) || header->magic != AUDIO_MAGIC || header->version != AUDIO_VERSION ||
+                       header->format != forge_get_audio_format() || header->sampleRate != AUDIO_MIX_RATE;
+
+        file::unmap(&map);
+        if (isStale) return true;
+    }
+
+    return false;
+}
+
+bool forge_generate_sound(const Bundle* bundle, Asset* asset) {
+    char wavePathStr[MAX_PATH] = "";
+    strcpy(wavePathStr, bundle->path);
+    strcat(wavePathStr, "/");
+    strcat(wavePathStr, asset->fileName);
+
+    char outputPathStr[MAX_PATH] = "";
+    forge_sound_get_output_path(asset, outputPathStr);
+
+    AudioFormat format = forge_get_audio_format();
+    bool success = false;
+
+    audio::Wave wave = {};
+    f32* planes = NULL;
+    f32* resampled = NULL;
+    u8* samples = NULL;
+    u64 frameCount = 0;
+    u64 dataSize = 0;
+    AudioHeader header = {};
+    file::File outputFile = {};
+
+    file::Mapping waveMap = {};
+    if (!file::map(wavePathStr, &waveMap)) {
+        log_format(LOG_PREFIX_WARN "SOUND > Could not read " ANSI_GREEN "'%s'" ANSI_RESET, wavePathStr);
+        return false;
+    }
+
+    if (!audio::parse_wav(waveMap.data, waveMap.size, &wave)) {
+        log_format(LOG_PREFIX_WARN "SOUND > Unsupported wave file " ANSI_GREEN "'%s'" ANSI_RESET, wavePathStr);
+        goto exit_generate_sound;
+    }
+
+    planes = audio::to_planes(&wave);
+    resampled = audio::resample(planes, wave.channelCount, wave.frameCount, wave.sampleRate, AUDIO_MIX_RATE, &gPool, &frameCount);
+    samples = audio::encode(resampled, wave.channelCount, frameCount, format, &dataSize);
+
+    header.magic = AUDIO_MAGIC;
+    header.version = AUDIO_VERSION;
+    header.format = format;
+    header.sampleRate = AUDIO_MIX_RATE;
+    header.channelCount = wave.channelCount;
+    header.dataOffset = sizeof(AudioHeader);
+    header.dataSize = dataSize;
+    header.sampleCount = frameCount;
+
+    outputFile = file::open(outputPathStr, file::Mode::WRITE, true);
+    if (!outputFile.handle) {
+        log_format(LOG_PREFIX_WARN "SOUND > Could not write " ANSI_GREEN "'%s'" ANSI_RESET, outputPathStr);
+        goto exit_generate_sound;
+    }
+
+    // A partly written sound would still pass as up to date, so it is removed
+    if (!file::write(&outputFile, &header, sizeof(AudioHeader)) || !forge_file_write_large(&outputFile, samples, dataSize)) {
+        file::close(&outputFile);
+        file::remove(outputPathStr);
+        log_format(LOG_PREFIX_WARN "SOUND > Could not write " ANSI_GREEN "'%s'" ANSI_RESET, outputPathStr);
+        goto exit_generate_sound;
+    }
+
+    file::close(&outputFile);
+
+    asset->data.audioFormat = format;
+    asset->data.channelCount = wave.channelCount;
+    asset->data.sampleCount = frameCount;
+    success = true;
+
+exit_generate_sound:
+    if (samples) memory::free(samples);
+    if (resampled) memory::free(resampled);
+    if (planes) memory::free(planes);
+    file::unmap(&waveMap);
+
+    return success;
+}
+
+// Resamples every wave to the mix rate & stores it in the output format, so loading a sound at runtime is a plain copy
+bool forge_generate_sounds(Bundle* bundle) {
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        trace::Scope scope = trace::begin("sound.process", bundle->assets[i].fileName);
+        scope.itemCount = 1;
+        scope.byteCount = bundle->assets[i].fileSize;
+
+        bool isProcessed = forge_generate_sound(bundle, &bundle->assets[i]);
+        trace::end(&scope);
+
+        if (!isProcessed) return false;
+    }
+
+    log_format("- Processed %u sounds (%u Hz, %s)", bundle->assetCount, AUDIO_MIX_RATE, gAudioFormatToStr[as_index(forge_get_audio_format())]);
+    return true;
+}
+
+// -- Font
+void forge_font_get_output_path(const Asset* asset, char* buffer) {
+    forge_get_flat_output_path(CONFIG_RESOURCE_PATH "/font", asset, CONFIG_FONT_EXT, buffer);
+}
+
+// Only the header is read, a missing or outdated table means the font has to be compiled again
+bool forge_font_read_header(const Asset* asset, FontHeader* outHeader) {
+    char outputPathStr[MAX_PATH] = "";
+    forge_font_get_output_path(asset, outputPathStr);
+    if (!file::exists(outputPathStr)) return false;
+
+    file::Mapping map = {};
+    if (!file::map(outputPathStr, &map)) return false;
+
+    bool isValid = map.size >= sizeof(FontHeader);
+    if (isValid) memory::copy(outHeader, map.data, sizeof(FontHeader));
+
+    file::unmap(&map);
+    return isValid && outHeader->magic == FONT_MAGIC && outHeader->version == FONT_VERSION;
+}
+
+bool forge_font_is_stale(const Bundle* bundle) {
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        FontHeader header = {};
+        if (!forge_font_read_header(&bundle->assets[i], &header)) return true;
+    }
+
+    return false;
+}
+
+bool forge_generate_font(const Bundle* bundle, Asset* asset) {
+    char descPathStr[MAX_PATH] = "";
+    strcpy(descPathStr, bundle->path);
+    strcat(descPathStr, "/");
+    strcat(descPathStr, asset->fileName);
+
+    char outputPathStr[MAX_PATH] = "";
+    forge_font_get_output_path(asset, outputPathStr);
+
+    bool success = false;
+    font::Description desc = {};
+    u8* compiled = NULL;
+    u64 compiledSize = 0;
+    file::File outputFile = {};
+
+    file::Mapping descMap = {};
+    if (!file::map(descPathStr, &descMap)) {
+        log_format(LOG_PREFIX_WARN "FONT > Could not read " ANSI_GREEN "'%s'" ANSI_RESET, descPathStr);
+        return false;
+    }
+
+    if (!font::parse_bmfont(descMap.data, descMap.size, &desc)) {
+        log_format(LOG_PREFIX_WARN "FONT > Unsupported font descriptor " ANSI_GREEN "'%s'" ANSI_RESET, descPathStr);
+        goto exit_generate_font;
+    }
+
+    // Every font owns exactly one image in the font atlas
+    if (desc.pageCount > 1) {
+        log_format(LOG_PREFIX_WARN "FONT > " ANSI_GREEN "'%s'" ANSI_RESET " uses %u pages, only a single page is supported", descPathStr, desc.pageCount);
+        goto exit_generate_font;
+    }
+
+    compiled = font::compile(&desc, &compiledSize);
+    if (!compiled) {
+        log_format(LOG_PREFIX_WARN "FONT > " ANSI_GREEN "'%s'" ANSI_RESET " has too many glyphs (%u)", descPathStr, desc.glyphCount);
+        goto exit_generate_font;
+    }
+
+    outputFile = file::open(outputPathStr, file::Mode::WRITE, true);
+    if (!outputFile.handle) {
+        log_format(LOG_PREFIX_WARN "FONT > Could not write " ANSI_GREEN "'%s'" ANSI_RESET, outputPathStr);
+        goto exit_generate_font;
+    }
+
+    // A partly written table would still pass as up to date, so it is removed
+    if (!file::write(&outputFile, compiled, (i32)compiledSize)) {
+        file::close(&outputFile);
+        file::remove(outputPathStr);
+        log_format(LOG_PREFIX_WARN "FONT > Could not write " ANSI_GREEN "'%s'" ANSI_RESET, outputPathStr);
+        goto exit_generate_font;
+    }
+
+    file::close(&outputFile);
+
+    memory::copy(&asset->data.font, compiled, sizeof(FontHeader));
+    log_format("- Compiled font: " ANSI_GREEN "'%s'" ANSI_RESET " (%u glyphs in %u blocks, %u kerning pairs, %llu bytes)", outputPathStr,
+               asset->data.font.glyphCount, asset->data.font.usedBlockCount, asset->data.font.kerningCount, (unsigned long long)compiledSize);
+    success = true;
+
+exit_generate_font:
+    if (compiled) memory::free(compiled);
+    font::release(&desc);
+    file::unmap(&descMap);
+
+    return success;
+}
+
+// Glyph tables are compiled offline, so the engine maps them instead of parsing descriptors at load time
+bool forge_generate_fonts(Bundle* bundle) {
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        trace::Scope scope = trace::begin("font.compile", bundle->assets[i].fileName);
+        scope.itemCount = 1;
+        scope.byteCount = bundle->assets[i].fileSize;
+
+        bool isCompiled = forge_generate_font(bundle, &bundle->assets[i]);
+        trace::end(&scope);
+
+        if (!isCompiled) return false;
+    }
+
+    return true;
+}
+
 // -- Generation
+// Copies a layout shared between forge & the engine into a generated file
+bool forge_append_component(text::Builder* builder, const char* fileName) {
+    char componentPath[MAX_PATH] = "";
+    sprintf(componentPath, CONFIG_COMPONENT_PATH "/%s", fileName);
+
+    if (!text::append_file(builder, componentPath)) {
+        log_format(LOG_PREFIX_WARN "GEN > Failed to read " ANSI_GREEN "'%s'" ANSI_RESET, componentPath);
+        return false;
+    }
+
+    return true;
+}
+
 // NOTE: Could be better, c-strings are a pain
 void forge_format_string_as_enum(char* buffer, u64 bufferSize, const char* name, bool appendZero) {
     u64 offset = strlen(buffer);
@@ -729,8 +2912,8 @@ void forge_format_string_as_enum(char* buffer, u64 bufferSize, const char* name,
         prevVal = curVal;
         curVal = (u32)name[cIdx];
 
-        // Check if the current character is a 'Space', 'Hyphen-minus' or 'Underscore'
-        if (curVal == 32 || curVal == 45 || curVal == 95) {
+        // Check if the current character is a 'Space', 'Hyphen-minus', 'Underscore' or a 'Solidus' between subfolders
+        if (curVal == 32 || curVal == 45 || curVal == 95 || curVal == 47) {
             // Check if an underscore was already set
             if (buffer[cIdx + offset - 1] == '_') {
                 offset--;
@@ -786,24 +2969,201 @@ void forge_format_string_as_enum(char* buffer, u64 bufferSize, const char* name,
     buffer[offset + nameLen] = ',';
 }
 
+// Finds a seed for every bucket so each base name gets its own slot, see 'forge/component/lookup.hpp'
+// NOTE: Buckets are placed largest first while most slots are still free, single name buckets just take the leftovers.
+bool forge_build_name_table(const Bundle* bundle, u32* outSeeds, i32* outSlotToAsset) {
+    u32 count = bundle->assetCount;
+    if (count == 0) return true;
+
+    // Bucket members are grouped by a counting sort, each group keeps its assets in ascending order
+    u32* assetBucket = (u32*)memory::alloc(sizeof(u32) * count);
+    u32* bucketSize = (u32*)memory::alloc(sizeof(u32) * count);
+    u32* bucketStart = (u32*)memory::alloc(sizeof(u32) * (count + 1));
+    u32* bucketMembers = (u32*)memory::alloc(sizeof(u32) * count);
+    u32* slots = NULL;
+    u32 maxBucketSize = 0;
+    u32 freeSlot = 0;
+    bool success = false;
+
+    if (!assetBucket || !bucketSize || !bucketStart || !bucketMembers) {
+        log_format(LOG_PREFIX_WARN "GEN > Failed to allocate the name table for %u names", count);
+        goto exit_build_name_table;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        assetBucket[i] = lookup_hash(bundle->assets[i].baseName, 0) % count;
+        bucketSize[assetBucket[i]]++;
+
+        if (bucketSize[assetBucket[i]] > maxBucketSize) maxBucketSize = bucketSize[assetBucket[i]];
+    }
+
+    for (u32 bucket = 0; bucket < count; bucket++) {
+        bucketStart[bucket + 1] = bucketStart[bucket] + bucketSize[bucket];
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        u32 bucket = assetBucket[i];
+        bucketMembers[bucketStart[bucket + 1] - bucketSize[bucket]] = i;
+        bucketSize[bucket]--;
+    }
+
+    for (u32 bucket = 0; bucket < count; bucket++) {
+        bucketSize[bucket] = bucketStart[bucket + 1] - bucketStart[bucket];
+    }
+
+    slots = (u32*)memory::alloc(sizeof(u32) * maxBucketSize);
+    if (!slots) goto exit_build_name_table;
+
+    for (u32 i = 0; i < count; i++) {
+        outSeeds[i] = 0;
+        outSlotToAsset[i] = -1;
+    }
+
+    for (u32 size = maxBucketSize; size > 1; size--) {
+        for (u32 bucket = 0; bucket < count; bucket++) {
+            if (bucketSize[bucket] != size) continue;
+
+            const u32* members = &bucketMembers[bucketStart[bucket]];
+            u32 memberCount = size;
+
+            u32 seed = 1;
+            for (; seed < CONFIG_LOOKUP_MAX_SEED; seed++) {
+                bool isValid = true;
+
+                for (u32 m = 0; m < memberCount && isValid; m++) {
+                    slots[m] = lookup_hash(bundle->assets[members[m]].baseName, seed) % count;
+                    if (outSlotToAsset[slots[m]] != -1) isValid = false;
+
+                    for (u32 prev = 0; prev < m && isValid; prev++) {
+                        if (slots[prev] == slots[m]) isValid = false;
+                    }
+                }
+
+                if (isValid) break;
+            }
+
+            if (seed == CONFIG_LOOKUP_MAX_SEED) {
+                // Identical names always collide, no seed can separate them
+                log_format(LOG_PREFIX_WARN "GEN > No lookup seed found for " ANSI_GREEN "'%s'" ANSI_RESET, bundle->assets[members[0]].baseName);
+                goto exit_build_name_table;
+            }
+
+            outSeeds[bucket] = seed;
+            for (u32 m = 0; m < memberCount; m++) {
+                outSlotToAsset[slots[m]] = (i32)members[m];
+            }
+        }
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        if (bucketSize[assetBucket[i]] != 1) continue;
+
+        while (outSlotToAsset[freeSlot] != -1) freeSlot++;
+
+        outSeeds[assetBucket[i]] = LOOKUP_DIRECT_SLOT | freeSlot;
+        outSlotToAsset[freeSlot] = (i32)i;
+    }
+
+    success = true;
+
+exit_build_name_table:
+    if (assetBucket) memory::free(assetBucket);
+    if (bucketSize) memory::free(bucketSize);
+    if (bucketStart) memory::free(bucketStart);
+    if (bucketMembers) memory::free(bucketMembers);
+    if (slots) memory::free(slots);
+
+    return success;
+}
+
+// Fails the whole type if no table can be built, game code calling 'find_<type>' would otherwise stop compiling
+bool forge_write_name_table(text::Builder* header, const AssetConfig* config, const Bundle* bundle, const char* enumCountStr) {
+    // Zero sized arrays aren't allowed, an empty type can only ever return NONE
+    if (bundle->assetCount == 0) {
+        text::line(header);
+        text::linef(header, "constexpr %sName find_%s(const char*) { return %sNONE; }", config->typeCapital, config->type, config->prefix);
+        return true;
+    }
+
+    u32* seeds = (u32*)memory::alloc(sizeof(u32) * bundle->assetCount);
+    i32* slotToAsset = (i32*)memory::alloc(sizeof(i32) * bundle->assetCount);
+    if (!seeds || !slotToAsset || !forge_build_name_table(bundle, seeds, slotToAsset)) {
+        if (seeds) memory::free(seeds);
+        if (slotToAsset) memory::free(slotToAsset);
+        return false;
+    }
+
+    text::line(header);
+
+    // Inline so every translation unit including the header shares a single table
+    text::linef(header, "inline constexpr NameTable<%sName, %s> g%sNames = {", config->typeCapital, enumCountStr, config->typeCapital);
+
+    text::append(header, "    {");
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        text::appendf(header, (seeds[i] & LOOKUP_DIRECT_SLOT) ? " 0x%X," : " %u,", seeds[i]);
+    }
+    text::line(header, " },");
+
+    text::append(header, "    {");
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        text::appendf(header, " \"%s\",", bundle->assets[slotToAsset[i]].baseName);
+    }
+    text::line(header, " },");
+
+    text::append(header, "    {");
+    for (u32 i = 0; i < bundle->assetCount; i++) {
+        char enumValStr[GEM_MAX_STRING_LENGTH] = "";
+        sprintf(enumValStr, " %s", config->prefix);
+        forge_format_string_as_enum(enumValStr, GEM_MAX_STRING_LENGTH, bundle->assets[slotToAsset[i]].baseName, false);
+
+        text::append(header, enumValStr);
+    }
+    text::line(header, " },");
+    text::line(header, "};");
+    text::line(header);
+
+    text::linef(header, "constexpr %sName find_%s(const char* name) { return g%sNames.find(name, %sNONE); }", config->typeCapital, config->type, config->typeCapital, config->prefix);
+
+    memory::free(seeds);
+    memory::free(slotToAsset);
+    return true;
+}
+
 // TODO: Generated asset files should have a manifest as well, so if any changes are detected they're rebuilt (prevents accidental changes)
+// Keeps a copy of each part in temp, types that are skipped in a later run are combined from there
+void forge_get_part_path(const AssetConfig* config, const char* partName, char* buffer) {
+    sprintf(buffer, CONFIG_TEMP_PATH "/%s_%s.tmp", config->type, partName);
+}
+
+bool forge_save_part(const AssetConfig* config, const char* partName, const text::Builder* part) {
+    char partPath[MAX_PATH] = "";
+    forge_get_part_path(config, partName, partPath);
+
+    if (!text::write_if_changed(part, partPath)) {
+        log_format(LOG_PREFIX_WARN "GEN > Failed to save " ANSI_GREEN "'%s'" ANSI_RESET, partPath);
+        return false;
+    }
+
+    log_format("- Generated part: " ANSI_GREEN "'%s'" ANSI_RESET, partPath);
+    return true;
+}
+
 bool forge_write_asset_file(AssetType assetType, const Bundle* bundles) {
     if (assetType == AssetType::COUNT && !bundles) return false;
     AssetConfig* config = &gAssetConfigs[as_index(assetType)];
 
     // Initialize some reusable data
     const Bundle* primaryBundle = &bundles[as_index(BundleType::PRIMARY)];
-    char tempStr[GEM_MAX_STRING_LENGTH] = "";
 
     // -- [ ASSET HEADER ] --
-    sprintf(config->headerPath, CONFIG_TEMP_PATH "/%s_header.tmp", config->type);
-    file::File headerFile = file::open(config->headerPath, file::Mode::WRITE);
+    text::Builder* header = &config->headerPart;
+    if (!header->data && !text::init(header)) return false;
+    text::clear(header);
 
-    sprintf(tempStr, "// %s", config->typeCapital);
-    file::write_line(&headerFile, "// -------------------------------------------");
-    file::write_line(&headerFile, tempStr);
-    file::write_line(&headerFile, "// -------------------------------------------");
-    file::write_line(&headerFile, "");
+    text::line(header, "// -------------------------------------------");
+    text::linef(header, "// %s", config->typeCapital);
+    text::line(header, "// -------------------------------------------");
+    text::line(header);
 
     // -- Asset Structure
     bool assetHasStructure = true;
@@ -812,53 +3172,23 @@ bool forge_write_asset_file(AssetType assetType, const Bundle* bundles) {
         goto skip_asset_structure;
     }
 
-    if (assetType == AssetType::FONT) {
-        // Unicode Block
-        file::write_line(&headerFile, "enum class UnicodeBlock {");
-        file::write_line(&headerFile, "    LATIN = 128,");
-        file::write_line(&headerFile, "    LATIN1_SUPPLEMENT = 256,");
-        file::write_line(&headerFile, "};");
-        file::write_line(&headerFile, "");
-
-        // Glyph
-        file::write_line(&headerFile, "struct Glyph {");
-        file::write_line(&headerFile, "    u16 x;");        // (2 bytes) Horizontal position of the glyph in the texture (0 is the leftmost point in the texture)
-        file::write_line(&headerFile, "    u16 y;");        // (2 bytes) Vertical position of the glyph in the texture (0 is the topmost point in the texture)
-        file::write_line(&headerFile, "    u16 width;");    // (2 bytes) Width of the glyph in the texture
-        file::write_line(&headerFile, "    u16 height;");   // (2 bytes) Height of the glyph in the texture
-        file::write_line(&headerFile, "    i16 offsetX;");  // (2 bytes) Horizontal offset when drawing the glyph to the screen
-        file::write_line(&headerFile, "    i16 offsetY;");  // (2 bytes) Vertical offset when drawing the glyph to the screen
-        file::write_line(&headerFile, "    i16 advanceX;"); // (2 bytes) Number of pixels to advance for when drawing the next glyph
-        file::write_line(&headerFile, "    u16 isValid;");  // (2 bytes) Boolean representing if the glyph was initialized with correct values
-        file::write_line(&headerFile, "};");        // total: 16 bytes
-        file::write_line(&headerFile, "");
-    }
-
-    if (assetType == AssetType::ATLAS) {
-        file::File atlasFile = file::open(CONFIG_COMPONENT_PATH "/atlas.hpp", file::Mode::READ);
-
-        i32 size = file::get_size(&atlasFile);
-        char* data = (char*)memory::alloc(size);
+    if (assetType == AssetType::FONT && !forge_append_component(header, "font.hpp")) return false;
+    if (assetType == AssetType::SOUND && !forge_append_component(header, "audio.hpp")) return false;
+    if (assetType == AssetType::ATLAS && !forge_append_component(header, "atlas.hpp")) return false;
 
-        i32 bytesRead = 0;
-        file::read(&atlasFile, data, size, &bytesRead);
+    if (assetType == AssetType::FONT || assetType == AssetType::SOUND || assetType == AssetType::ATLAS) text::line(header);
 
-        i32 offset = file::get_offset(&headerFile);
-        file::set_offset_end(&headerFile);
-        file::write(&headerFile, data, bytesRead);
-        file::set_offset(&headerFile, offset, file::Offset::SET);
-
-        memory::free(data);
-    }
-
-    sprintf(tempStr, "struct %s {", config->typeCapital);
-    file::write_line(&headerFile, tempStr);
+    text::linef(header, "struct %s {", config->typeCapital);
 
     switch (assetType) {
         using enum AssetType;
         case SPRITE:
             {
-                file::write_line(&headerFile, "    geometry::Rectangle atlasRect;");
+                text::line(header, "    geometry::Rectangle atlasRect;"); // Trimmed area in the atlas, width & height are swapped when rotated
+                text::line(header, "    u32 atlasPage;");                 // Layer of the atlas texture array the rect is on
+                text::line(header, "    Vec2i trimOffset;");              // Top left of the trimmed area within the source image
+                text::line(header, "    Vec2i sourceSize;");              // Size of the source image before trimming
+                text::line(header, "    bool isRotated;");                // Stored 90 degrees clockwise, UVs have to be turned back
             }
             break;
         case TILEMAP:
@@ -866,62 +3196,70 @@ bool forge_write_asset_file(AssetType assetType, const Bundle* bundles) {
             break;
         case FONT:
             {
-                file::write_line(&headerFile, "    const char* filePath;");
-                file::write_line(&headerFile, "    geometry::Rectangle atlasRect;");
-                file::write_line(&headerFile, "    // Runtime");
-                file::write_line(&headerFile, "    u16 lineHeight;");
-                file::write_line(&headerFile, "    u16 baseLine;");
-                file::write_line(&headerFile, "    u8 paddingUp;");
-                file::write_line(&headerFile, "    u8 paddingRight;");
-                file::write_line(&headerFile, "    u8 paddingDown;");
-                file::write_line(&headerFile, "    u8 paddingLeft;");
-                file::write_line(&headerFile, "    u32 glyphCount;");
-                file::write_line(&headerFile, "    i32 pad[1];");
-                file::write_line(&headerFile, "    Glyph glyphBank[(u32)UnicodeBlock::LATIN1_SUPPLEMENT];");
+                text::line(header, "    const char* filePath;"); // Compiled glyph table, starts with a FontHeader
+                text::line(header, "    geometry::Rectangle atlasRect;");
+                text::line(header, "    u32 atlasPage;");
+                text::line(header, "    u16 lineHeight;");
+                text::line(header, "    u16 baseLine;");
+                text::line(header, "    u8 paddingUp;");
+                text::line(header, "    u8 paddingRight;");
+                text::line(header, "    u8 paddingDown;");
+                text::line(header, "    u8 paddingLeft;");
+                text::line(header, "    u32 glyphCount;");
+                text::line(header, "    u32 kerningCount;");
             }
             break;
         case SOUND:
+            {
+                text::line(header, "    const char* filePath;");
+                text::line(header, "    AudioFormat format;");
+                text::line(header, "    u32 sampleRate;");
+                text::line(header, "    u32 channelCount;");
+                text::line(header, "    u32 duration;");    // in milliseconds
+                text::line(header, "    u64 sampleCount;"); // Per channel
+            }
+            break;
         case MUSIC:
             {
-                file::write_line(&headerFile, "    const char* filePath;");
+                text::line(header, "    const char* filePath;");
             }
             break;
         case ATLAS:
             {
-                file::write_line(&headerFile, "    const char* filePath;");
-                file::write_line(&headerFile, "    AtlasType type;");
-                file::write_line(&headerFile, "    Vec2i size;");
-                file::write_line(&headerFile, "    // -- Best Fit");
-                file::write_line(&headerFile, "    u32 elementLimit;");
-                file::write_line(&headerFile, "    // -- Grid");
-                file::write_line(&headerFile, "    u32 gridSize;");
-                file::write_line(&headerFile, "    AtlasOrientation orientation;");
-                file::write_line(&headerFile, "    AtlasPriority priority;");
-                file::write_line(&headerFile, "    AtlasSubGrid subGridType;");
+                text::line(header, "    const char* filePath;");
+                text::line(header, "    AtlasType type;");
+                text::line(header, "    Vec2i size;");     // Of each page
+                text::line(header, "    u32 pageCount;");  // Layers of the texture array, pages after the first are in 'atlas.page1.png', ...
+                text::line(header, "    u32 mipLevelCount;");
+                text::line(header, "    // -- Best Fit");
+                text::line(header, "    u32 elementLimit;");
+                text::line(header, "    // -- Grid");
+                text::line(header, "    u32 gridSize;");
+                text::line(header, "    AtlasOrientation orientation;");
+                text::line(header, "    AtlasPriority priority;");
+                text::line(header, "    AtlasSubGrid subGridType;");
             }
             break;
         default:
             {
                 log_format(LOG_PREFIX_WARN "GEN > Structure fields for asset type '%s' aren't defined", config->type);
-                file::write_line(&headerFile, "    // ...");
+                text::line(header, "    // ...");
             }
             break;
     }
 
-    file::write_line(&headerFile, "};");
-    file::write_line(&headerFile, "");
+    text::line(header, "};");
+    text::line(header);
 
 skip_asset_structure:
     // -- Asset Enum
     char enumCountStr[GEM_MAX_STRING_LENGTH] = "";
     sprintf(enumCountStr, "ASSET_%s_COUNT", config->typeUpper);
 
-    sprintf(tempStr, "enum %sName {", config->typeCapital);
-    file::write_line(&headerFile, tempStr);
+    text::linef(header, "enum %sName {", config->typeCapital);
 
     // Format and write all the file names as enum values
-    sprintf(tempStr, "    %sNONE = -1,", config->prefix);
-    file::write_line(&headerFile, tempStr);
+    text::linef(header, "    %sNONE = -1,", config->prefix);
 
     for (u32 i = 0; i < primaryBundle->assetCount; i++) {
         const Asset* asset = &primaryBundle->assets[i];
@@ -930,141 +3268,143 @@ skip_asset_structure:
         sprintf(enumValStr, "    %s", config->prefix);
         forge_format_string_as_enum(enumValStr, GEM_MAX_STRING_LENGTH, asset->baseName, i == 0);
 
-        file::write_line(&headerFile, enumValStr);
+        text::line(header, enumValStr);
     }
 
     // Write enum count value | example: "    TEST_COUNT,"
-    sprintf(tempStr, "    %s,", enumCountStr);
-    file::write_line(&headerFile, tempStr);
-    file::write_line(&headerFile, "};");
+    text::linef(header, "    %s,", enumCountStr);
+    text::line(header, "};");
 
     // -- Forward declare the asset bank
     if (assetHasStructure) {
-        sprintf(tempStr, "extern %s g%sBank[%s];", config->typeCapital, config->typeCapital, enumCountStr);
-        file::write_line(&headerFile, "");
-        file::write_line(&headerFile, tempStr);
+        text::line(header);
+        text::linef(header, "extern %s g%sBank[%s];", config->typeCapital, config->typeCapital, enumCountStr);
+    }
+
+    // -- Name lookup, base name to enum value
+    if (!forge_write_name_table(header, config, primaryBundle, enumCountStr)) {
+        log_format(LOG_PREFIX_WARN "GEN > Failed to build the name lookup for type " ANSI_GREEN "'%s'" ANSI_RESET, config->type);
+        return false;
     }
 
-    log_format("- Generated file: " ANSI_GREEN "'%s'" ANSI_RESET, config->headerPath);
-    file::close(&headerFile);
+    if (!forge_save_part(config, "header", header)) return false;
 
     // -- [ ASSET SOURCE ] --
-    if (assetType == AssetType::TILEMAP || assetType == AssetType::PARTICLE) goto skip_asset_source;
+    text::Builder* source = &config->sourcePart;
+    if (!source->data && !text::init(source)) return false;
+    text::clear(source);
 
-    sprintf(config->sourcePath, CONFIG_TEMP_PATH "/%s_source.tmp", config->type);
-    file::File sourceFile = file::open(config->sourcePath, file::Mode::WRITE);
+    if (assetType == AssetType::TILEMAP || assetType == AssetType::PARTICLE) goto skip_asset_source;
 
-    sprintf(tempStr, "// %s", config->typeCapital);
-    file::write_line(&sourceFile, "// -------------------------------------------");
-    file::write_line(&sourceFile, tempStr);
-    file::write_line(&sourceFile, "// -------------------------------------------");
-    file::write_line(&sourceFile, "");
+    text::line(source, "// -------------------------------------------");
+    text::linef(source, "// %s", config->typeCapital);
+    text::line(source, "// -------------------------------------------");
+    text::line(source);
 
     // -- Asset Bank Array
-    sprintf(tempStr, "%s g%sBank[%s] = {", config->typeCapital, config->typeCapital, enumCountStr);
-    file::write_line(&sourceFile, tempStr);
+    text::linef(source, "%s g%sBank[%s] = {", config->typeCapital, config->typeCapital, enumCountStr);
+
+    const Asset emptyAsset = {};
+    for (u32 i = 0; i < primaryBundle->assetCount; i++) {
+        const Asset* asset = &primaryBundle->assets[i];
+
+        // Fonts pair up with their page by index, a missing page leaves the rect empty
+        const Bundle* auxiliaryBundle = &bundles[as_index(BundleType::AUXILIARY)];
+        const Asset* auxiliaryAsset = (i < auxiliaryBundle->assetCount) ? &auxiliaryBundle->assets[i] : &emptyAsset;
+
+        text::append(source, "    {");
+
+        if (assetType == AssetType::MUSIC || assetType == AssetType::ATLAS) {
+            text::appendf(source, " .filePath = \"%s/%s/%s\"", CONFIG_RESOURCE_PATH, config->type, asset->fileName);
+        }
+
+        if (assetType == AssetType::FONT) {
+            char outputPathStr[MAX_PATH] = "";
+            forge_font_get_output_path(asset, outputPathStr);
+
+            text::appendf(source, " .filePath = \"%s\"", outputPathStr);
+        }
+
+        if (assetType == AssetType::SOUND) {
+            char outputPathStr[MAX_PATH] = "";
+            forge_sound_get_output_path(asset, outputPathStr);
+
+            text::appendf(source, " .filePath = \"%s\"", outputPathStr);
+            text::appendf(source, ", .format = %s", gAudioFormatToStr[as_index(asset->data.audioFormat)]);
+            text::appendf(source, ", .sampleRate = %u, .channelCount = %u", AUDIO_MIX_RATE, asset->data.channelCount);
+            text::appendf(source, ", .duration = %llu", (unsigned long long)(asset->data.sampleCount * 1000 / AUDIO_MIX_RATE));
+            text::appendf(source, ", .sampleCount = %llu", (unsigned long long)asset->data.sampleCount);
+        }
+
+        if (assetType == AssetType::FONT || assetType == AssetType::ATLAS) {
+            text::append(source, ",");
+        }
 
-    for (u32 i = 0; i < primaryBundle->assetCount; i++) {
-        const Asset* asset = &primaryBundle->assets[i];
+        if (assetType == AssetType::SPRITE || assetType == AssetType::FONT) {
+            const Asset* atlasAsset = (assetType == AssetType::SPRITE) ? asset : auxiliaryAsset;
+            const geometry::Rectangle* rect = &atlasAsset->data.rect;
+            text::appendf(source, " .atlasRect = { %i, %i, %i, %i }", rect->x, rect->y, rect->width, rect->height);
 
-        const Bundle* auxiliaryBundle = &bundles[as_index(BundleType::AUXILIARY)];
-        const Asset* auxiliaryAsset = &auxiliaryBundle->assets[i];
+            if (atlasAsset->data.page > 0) text::appendf(source, ", .atlasPage = %u", atlasAsset->data.page);
+        }
 
-        char numBuf[GEM_MAX_STRING_LENGTH] = "";
-        memory::zero(tempStr, GEM_MAX_STRING_LENGTH);
-        strcpy(tempStr, "    {");
+        if (assetType == AssetType::SPRITE) {
+            text::appendf(source, ", .trimOffset = { %i, %i }", asset->data.trim.x, asset->data.trim.y);
+            text::appendf(source, ", .sourceSize = { %i, %i }", asset->data.sourceSize.w, asset->data.sourceSize.h);
 
-        if (assetType == AssetType::FONT || assetType == AssetType::SOUND || assetType == AssetType::MUSIC || assetType == AssetType::ATLAS) {
-            strcat(tempStr, " .filePath = \"");
-            strcat(tempStr, CONFIG_RESOURCE_PATH);
-            strcat(tempStr, "/");
-            strcat(tempStr, config->type);
-            strcat(tempStr, "/");
-            strcat(tempStr, asset->fileName);
-            strcat(tempStr, "\"");
+            if (asset->data.isRotated) text::append(source, ", .isRotated = true");
         }
 
-        if (assetType == AssetType::FONT || assetType == AssetType::ATLAS) {
-            strcat(tempStr, ",");
+        if (assetType == AssetType::FONT) {
+            const FontHeader* font = &asset->data.font;
+            text::appendf(source, ", .lineHeight = %u, .baseLine = %u", font->lineHeight, font->baseLine);
+            text::appendf(source, ", .paddingUp = %u, .paddingRight = %u, .paddingDown = %u, .paddingLeft = %u", font->paddingUp, font->paddingRight, font->paddingDown, font->paddingLeft);
+            text::appendf(source, ", .glyphCount = %u, .kerningCount = %u", font->glyphCount, font->kerningCount);
         }
 
-        if (assetType == AssetType::SPRITE || assetType == AssetType::FONT) {
-            const geometry::Rectangle* rect = (assetType == AssetType::SPRITE) ? &asset->data.rect : &auxiliaryAsset->data.rect;
-
-            strcat(tempStr, " .atlasRect = { ");
-            sprintf(numBuf, "%i, ", rect->x);
-            strcat(tempStr, numBuf);
-            sprintf(numBuf, "%i, ", rect->y);
-            strcat(tempStr, numBuf);
-            sprintf(numBuf, "%i, ", rect->width);
-            strcat(tempStr, numBuf);
-            sprintf(numBuf, "%i", rect->height);
-            strcat(tempStr, numBuf);
-            strcat(tempStr, " }");
-        }
-
-        if (assetType == AssetType::ATLAS) {
-            u32 assetID = gPersistent.atlasFileToAssetID[i];
+        if (assetType == AssetType::ATLAS && asset->data.atlasOf != AssetType::COUNT && forge_atlas_load_info(&gAssetConfigs[as_index(asset->data.atlasOf)])) {
+            u32 assetID = as_index(asset->data.atlasOf);
             AtlasConfig* atlasConfig = &gPersistent.atlas[assetID].config;
 
-            strcat(tempStr, " .type = ");
-            strcat(tempStr, gAtlasTypeToStr[as_index(atlasConfig->type)]);
-
-            strcat(tempStr, ",");
-            strcat(tempStr, " .size = { ");
-            sprintf(numBuf, "%i, %i", gPersistent.atlas[assetID].size.w, gPersistent.atlas[assetID].size.h);
-            strcat(tempStr, numBuf);
-            strcat(tempStr, " }");
+            text::appendf(source, " .type = %s", gAtlasTypeToStr[as_index(atlasConfig->type)]);
+            text::appendf(source, ", .size = { %i, %i }", gPersistent.atlas[assetID].size.w, gPersistent.atlas[assetID].size.h);
+            text::appendf(source, ", .pageCount = %u", gPersistent.atlas[assetID].pageCount);
+            text::appendf(source, ", .mipLevelCount = %u", gPersistent.atlas[assetID].mipLevelCount);
 
             if (atlasConfig->type == AtlasType::BEST_FIT) {
-                strcat(tempStr, ",");
-                strcat(tempStr, " .elementLimit = ");
-                sprintf(numBuf, "%i", gPersistent.atlas[assetID].elementLimit);
-                strcat(tempStr, numBuf);
+                text::appendf(source, ", .elementLimit = %i", gPersistent.atlas[assetID].elementLimit);
             }
 
             if (atlasConfig->type == AtlasType::GRID) {
-                strcat(tempStr, ",");
-                strcat(tempStr, " .gridSize = ");
-                sprintf(numBuf, "%i", atlasConfig->gridSize);
-                strcat(tempStr, numBuf);
+                text::appendf(source, ", .gridSize = %i", atlasConfig->gridSize);
 
                 // Write enum values if they aren't the default
                 if (as_index(atlasConfig->subGridType) != 0) {
-                    strcat(tempStr, ",");
-                    strcat(tempStr, " .subGridType = ");
-                    strcat(tempStr, gAtlasSubGridToStr[as_index(atlasConfig->subGridType)]);
+                    text::appendf(source, ", .subGridType = %s", gAtlasSubGridToStr[as_index(atlasConfig->subGridType)]);
                 }
 
                 if (as_index(atlasConfig->orientation) != 0) {
-                    strcat(tempStr, ",");
-                    strcat(tempStr, " .orientation = ");
-                    strcat(tempStr, gAtlasOrientationToStr[as_index(atlasConfig->orientation)]);
+                    text::appendf(source, ", .orientation = %s", gAtlasOrientationToStr[as_index(atlasConfig->orientation)]);
                 }
 
                 if (as_index(atlasConfig->priority) != 0) {
-                    strcat(tempStr, ",");
-                    strcat(tempStr, " .priority = ");
-                    strcat(tempStr, gAtlasPriorityToStr[as_index(atlasConfig->priority)]);
+                    text::appendf(source, ", .priority = %s", gAtlasPriorityToStr[as_index(atlasConfig->priority)]);
                 }
             }
         }
 
-        strcat(tempStr, " },");
-        file::write_line(&sourceFile, tempStr);
+        text::line(source, " },");
     }
 
-    file::write_line(&sourceFile, "};");
-
-    file::close(&sourceFile);
-    log_format("- Generated file: " ANSI_GREEN "'%s'" ANSI_RESET, config->sourcePath);
+    text::line(source, "};");
 
 skip_asset_source:
-    return true;
+    // Saved even when empty, so a stale part from an earlier config never gets combined
+    return forge_save_part(config, "source", source);
 }
 
-void forge_generate_asset_part(AssetType assetType) {
-    if (assetType == AssetType::COUNT) return;
+StatusCode forge_generate_asset_part(AssetType assetType) {
+    if (assetType == AssetType::COUNT) return StatusCode::FAILURE;
     AssetConfig* config = &gAssetConfigs[as_index(assetType)];
     config->assetType = assetType;
 
@@ -1072,8 +3412,7 @@ void forge_generate_asset_part(AssetType assetType) {
     bool validConfig = string_is_valid(config->type) || string_is_valid(config->prefix) || string_is_valid(config->fileExt[0]);
     if (!validConfig) {
         log_format(LOG_PREFIX_WARN "ASSET > Invalid config provided for type: %i", (i32)assetType);
-        forge_set_status(StatusCode::FAILURE);
-        return;
+        return StatusCode::FAILURE;
     }
 
     // Set alternate string formatting
@@ -1100,132 +3439,604 @@ void forge_generate_asset_part(AssetType assetType) {
     strcat(scanPath, config->type);
     log_format(ANSI_CYAN "[%s] " ANSI_RESET "Scanning files in: %s", config->typeUpper, scanPath);
 
+    StatusCode status = StatusCode::SKIPPED;
     Bundle* bundles = (Bundle*)memory::alloc(sizeof(Bundle) * (u32)BundleType::COUNT);
 
+    // NOTE: Every bundle of a type is filled first, a change in any one of them regenerates all of them.
+    //       Otherwise an unchanged auxiliary bundle would be written out without its atlas data.
     for (u32 bundleIdx = 0; bundleIdx < as_index(BundleType::COUNT); bundleIdx++) {
         if (!string_is_valid(config->fileExt[bundleIdx])) continue;
         Bundle* bundle = &bundles[bundleIdx];
 
-        if (!forge_try_fill_bundle(config, bundle, bundleIdx, scanPath)) {
+        StatusCode bundleStatus = StatusCode::SKIPPED;
+        if (!forge_try_fill_bundle(config, bundle, bundleIdx, scanPath, &bundleStatus)) {
             log_format(LOG_PREFIX_WARN "ASSET > Failed to fill bundle!");
-            forge_set_status(StatusCode::FAILURE);
+            status = StatusCode::FAILURE;
             break;
         }
 
-        if (forge_get_status() == StatusCode::SKIPPED) continue;
+        if (bundleStatus == StatusCode::CHANGED) status = StatusCode::CHANGED;
+    }
 
-        // Generate composite assets from existing asset files
-        // -- Atlas
-        if (config->atlas.type != AtlasType::NONE) {
-            if (assetType == AssetType::ATLAS) {
-                log_format(LOG_PREFIX_WARN "ASSET > Atlas types cannot generate texture atlases!");
-                forge_set_status(StatusCode::FAILURE);
-                break;
-            } else {
-                if (strcmp(config->fileExt[bundleIdx], ".png") == 0) {
-                    if (!forge_generate_atlas(config, bundle, bundleIdx)) {
-                        log_format(LOG_PREFIX_WARN "ASSET > Failed to generate atlas!");
-                        forge_set_status(StatusCode::FAILURE);
-                        break;
+    // Processed outputs that went missing or are out of date are rebuilt, even if their sources didn't change
+    if (status == StatusCode::SKIPPED) {
+        const Bundle* primaryBundle = &bundles[as_index(BundleType::PRIMARY)];
+
+        if (assetType == AssetType::SOUND && forge_sound_is_stale(primaryBundle)) status = StatusCode::CHANGED;
+        if (assetType == AssetType::FONT && forge_font_is_stale(primaryBundle)) status = StatusCode::CHANGED;
+        if (config->atlas.type != AtlasType::NONE && assetType != AssetType::ATLAS && forge_atlas_is_stale(config)) status = StatusCode::CHANGED;
+    }
+
+    if (status == StatusCode::CHANGED) {
+        for (u32 bundleIdx = 0; bundleIdx < as_index(BundleType::COUNT); bundleIdx++) {
+            if (!string_is_valid(config->fileExt[bundleIdx])) continue;
+            Bundle* bundle = &bundles[bundleIdx];
+
+            // Generate composite assets from existing asset files
+            // -- Atlas
+            if (config->atlas.type != AtlasType::NONE) {
+                if (assetType == AssetType::ATLAS) {
+                    log_format(LOG_PREFIX_WARN "ASSET > Atlas types cannot generate texture atlases!");
+                    status = StatusCode::FAILURE;
+                    break;
+                } else {
+                    if (strcmp(config->fileExt[bundleIdx], ".png") == 0) {
+                        if (!forge_generate_atlas(config, bundle, bundleIdx)) {
+                            log_format(LOG_PREFIX_WARN "ASSET > Failed to generate atlas!");
+                            status = StatusCode::FAILURE;
+                            break;
+                        }
                     }
                 }
             }
+
+            // -- Font
+            if (assetType == AssetType::FONT && bundleIdx == as_index(BundleType::PRIMARY)) {
+                if (!forge_generate_fonts(bundle)) {
+                    log_format(LOG_PREFIX_WARN "ASSET > Failed to compile fonts!");
+                    status = StatusCode::FAILURE;
+                    break;
+                }
+            }
+
+            // -- Sound
+            if (assetType == AssetType::SOUND) {
+                if (!forge_generate_sounds(bundle)) {
+                    log_format(LOG_PREFIX_WARN "ASSET > Failed to process sounds!");
+                    status = StatusCode::FAILURE;
+                    break;
+                }
+            }
         }
     }
 
     // Write out the data
-    if (forge_get_status() == StatusCode::CHANGED) {
+    if (status == StatusCode::CHANGED) {
+        trace::Scope scope = trace::begin("codegen.part", config->type);
+        scope.itemCount = bundles[as_index(BundleType::PRIMARY)].assetCount;
+
         if (!forge_write_asset_file(assetType, bundles)) {
             log_format(LOG_PREFIX_WARN "ASSET > Failed to generate asset files!");
-            forge_set_status(StatusCode::FAILURE);
+            status = StatusCode::FAILURE;
         }
+
+        scope.byteCount = config->headerPart.length + config->sourcePart.length;
+        trace::end(&scope);
     }
 
-    memory::free(bundles);
+    // Watch rebuilds replace the bundle of the previous run
+    forge_release_bundles(gPersistent.bundles[as_index(assetType)]);
+    gPersistent.bundles[as_index(assetType)] = bundles;
+    return status;
+}
+
+// -- Scheduling
+void forge_run_task(void* data) {
+    Task* task = (Task*)data;
+
+    task->status = forge_generate_asset_part(task->assetType);
+    if (task->status == StatusCode::FAILURE) {
+        log_format(LOG_PREFIX_ERRO "FORGE > Failed to generate asset!");
+    }
+
+    forge_merge_status(task->status);
+
+    // Release any tasks that were waiting on this one
+    for (u32 i = 0; i < task->dependentCount; i++) {
+        Task* dependent = &gTasks[as_index(task->dependents[i])];
+        if (thread::atomic_decrement(&dependent->dependencyCount) == 0) {
+            thread::pool_submit(&gPool, forge_run_task, dependent, dependent->counter);
+        }
+    }
+}
+
+void forge_add_task_dependency(AssetType assetType, AssetType dependsOn) {
+    Task* task = &gTasks[as_index(assetType)];
+    Task* dependency = &gTasks[as_index(dependsOn)];
+
+    thread::atomic_increment(&task->dependencyCount);
+    dependency->dependents[dependency->dependentCount++] = assetType;
+}
+
+// Runs the asset types set in 'typeMask' (1 << AssetType), the atlas type is added whenever an atlas producing type is set
+void forge_schedule_asset_parts(u32 typeMask) {
+    thread::Counter counter = {};
+
+    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
+        Task* task = &gTasks[i];
+        memory::zero(task, sizeof(Task));
+
+        task->assetType = (AssetType)i;
+        task->status = StatusCode::SKIPPED;
+        task->counter = &counter;
+    }
+
+    // Atlas entries index into the atlas data produced by every image type, so they're generated last
+    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
+        if (gAssetConfigs[i].atlas.type != AtlasType::NONE && (typeMask & (1u << i))) {
+            typeMask |= 1u << as_index(AssetType::ATLAS);
+            forge_add_task_dependency(AssetType::ATLAS, (AssetType)i);
+        }
+    }
+
+    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
+        Task* task = &gTasks[i];
+        if ((typeMask & (1u << i)) && task->dependencyCount == 0) {
+            thread::pool_submit(&gPool, forge_run_task, task, task->counter);
+        }
+    }
+
+    thread::pool_wait(&gPool, &counter);
+}
+
+void forge_write_generated_header(text::Builder* builder) {
+    text::line(builder, "// ------------------------------------------------------");
+    text::line(builder, "// WARNING: This file is generated by the Asset Forge!");
+    text::line(builder, "//          Any modifications will be overridden.");
+    text::line(builder, "// ------------------------------------------------------");
+    text::line(builder);
 }
 
-void forge_write_generated_header(const file::File* file) {
-    file::write_line(file, "// ------------------------------------------------------");
-    file::write_line(file, "// WARNING: This file is generated by the Asset Forge!");
-    file::write_line(file, "//          Any modifications will be overridden.");
-    file::write_line(file, "// ------------------------------------------------------");
-    file::write_line(file, "");
+// Writes a generated file only if its contents changed, so the game doesn't recompile for identical output
+void forge_write_generated_file(const text::Builder* builder, const char* path) {
+    bool hasWritten = false;
+    if (!text::write_if_changed(builder, path, &hasWritten)) {
+        log_format(LOG_PREFIX_WARN "GEN > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, path);
+        forge_set_status(StatusCode::FAILURE);
+        return;
+    }
+
+    if (hasWritten) {
+        log_format("- Generated file: " ANSI_GREEN "'%s'" ANSI_RESET, path);
+    } else {
+        log_format("- File " ANSI_GREEN "'%s'" ANSI_RESET " is identical | " ANSI_YELLOW "Skipped" ANSI_RESET, path);
+    }
 }
 
 void forge_combine_asset_files() {
     log_format(ANSI_CYAN "[FORGE] " ANSI_RESET "Combining asset files!");
 
+    trace::Scope scope = trace::begin("codegen.combine");
+    scope.itemCount = as_index(AssetType::COUNT);
+
+    text::Builder header = {};
+    text::Builder source = {};
+    if (!text::init(&header) || !text::init(&source)) {
+        log_format(LOG_PREFIX_WARN "GEN > Failed to reserve memory for the generated files!");
+        forge_set_status(StatusCode::FAILURE);
+        goto exit_combine;
+    }
+
     // -- File Headers
-    const char* headerPath = CONFIG_GEN_PATH "/assets_generated.hpp";
-    file::File headerFile = file::open(headerPath, file::Mode::WRITE);
-
-    forge_write_generated_header(&headerFile);
-    file::write_line(&headerFile, "#pragma once");
-    file::write_line(&headerFile, "");
-    file::write_line(&headerFile, "#include \"pch.hpp\"");
-    file::write_line(&headerFile, "");
-    file::write_line(&headerFile, "#include \"GEM/math/geometry.hpp\"");
-    file::write_line(&headerFile, "#include \"GEM/math/vector.hpp\"");
-    file::write_line(&headerFile, "");
-    file::write_line(&headerFile, "namespace asset {");
-
-    const char* sourcePath = CONFIG_GEN_PATH "/assets_generated.cpp";
-    file::File sourceFile = file::open(sourcePath, file::Mode::WRITE);
-
-    forge_write_generated_header(&sourceFile);
-    file::write_line(&sourceFile, "#include \"GEM/assets_generated.hpp\"");
-    file::write_line(&sourceFile, "");
-    file::write_line(&sourceFile, "namespace asset {");
+    forge_write_generated_header(&header);
+    text::line(&header, "#pragma once");
+    text::line(&header);
+    text::line(&header, "#include \"pch.hpp\"");
+    text::line(&header);
+    text::line(&header, "#include \"GEM/math/geometry.hpp\"");
+    text::line(&header, "#include \"GEM/math/vector.hpp\"");
+    text::line(&header);
+    text::line(&header, "namespace asset {");
+    text::line(&header);
+
+    if (!forge_append_component(&header, "lookup.hpp")) {
+        forge_set_status(StatusCode::FAILURE);
+        goto exit_combine;
+    }
+
+    forge_write_generated_header(&source);
+    text::line(&source, "#include \"GEM/assets_generated.hpp\"");
+    text::line(&source);
+    text::line(&source, "namespace asset {");
 
     // -- Copy over the partial asset files
+    // NOTE: Parts built in this run are already in memory, types that were skipped are read back from temp.
     for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
         AssetConfig* config = &gAssetConfigs[i];
+        char partPath[MAX_PATH] = "";
+
+        text::line(&header);
+        if (config->headerPart.length > 0) {
+            text::append(&header, config->headerPart.data, config->headerPart.length);
+        } else {
+            forge_get_part_path(config, "header", partPath);
+
+            if (!text::append_file(&header, partPath)) {
+                log_format(LOG_PREFIX_WARN "GEN > Missing part " ANSI_GREEN "'%s'" ANSI_RESET ", regenerate with --force", partPath);
+                forge_set_status(StatusCode::FAILURE);
+                goto exit_combine;
+            }
+        }
+
+        u64 sourceLength = source.length;
+        text::line(&source);
+        if (config->sourcePart.length > 0) {
+            text::append(&source, config->sourcePart.data, config->sourcePart.length);
+        } else {
+            forge_get_part_path(config, "source", partPath);
+
+            if (!text::append_file(&source, partPath)) {
+                log_format(LOG_PREFIX_WARN "GEN > Missing part " ANSI_GREEN "'%s'" ANSI_RESET ", regenerate with --force", partPath);
+                forge_set_status(StatusCode::FAILURE);
+                goto exit_combine;
+            }
+        }
+
+        // Types without a source part don't leave an empty line behind
+        if (source.length == sourceLength + 1) {
+            source.length = sourceLength;
+            source.data[source.length] = '\0';
+        }
+    }
+
+    // -- File Footers
+    text::line(&header);
+    text::line(&header, "}; // namespace: asset");
+
+    text::line(&source);
+    text::line(&source, "}; // namespace: asset");
+
+    forge_write_generated_file(&header, CONFIG_GEN_PATH "/assets_generated.hpp");
+    forge_write_generated_file(&source, CONFIG_GEN_PATH "/assets_generated.cpp");
+
+exit_combine:
+    scope.byteCount = header.length + source.length;
+    trace::end(&scope);
+
+    text::release(&header);
+    text::release(&source);
+}
+
+// -- Archive
+// Processed sounds already hold the final samples, only the header is skipped
+bool forge_archive_parse_sound(ArchiveSource* source) {
+    const AudioHeader* header = (const AudioHeader*)source->map.data;
+    if (source->map.size < sizeof(AudioHeader) || header->magic != AUDIO_MAGIC || header->version != AUDIO_VERSION) return false;
+    if (header->dataOffset + header->dataSize > source->map.size) return false;
+
+    switch (header->format) {
+        using enum AudioFormat;
+        case S16:       source->entry.format = ArchiveFormat::PCM;       source->entry.audio.bitsPerSample = 16; break;
+        case F32:       source->entry.format = ArchiveFormat::PCM_F32;   source->entry.audio.bitsPerSample = 32; break;
+        case IMA_ADPCM: source->entry.format = ArchiveFormat::IMA_ADPCM; source->entry.audio.bitsPerSample = 4;  break;
+        default: return false;
+    }
+
+    source->entry.audio.sampleRate = header->sampleRate;
+    source->entry.audio.channelCount = (u16)header->channelCount;
+    source->entry.size = header->dataSize;
+    source->dataOffset = header->dataOffset;
+    return true;
+}
+
+bool forge_archive_add_source(ArchiveSource* sources, u32* sourceCount, u32 maxSourceCount, AssetType assetType, u32 assetId, ArchiveFormat format, const char* path) {
+    if (*sourceCount >= maxSourceCount) return false;
+
+    ArchiveSource* source = &sources[*sourceCount];
+    memory::zero(source, sizeof(ArchiveSource));
+
+    if (!file::map(path, &source->map)) return false;
+
+    source->entry.assetType = as_index(assetType);
+    source->entry.assetId = assetId;
+    source->entry.format = format;
+    source->entry.size = source->map.size;
+
+    switch (format) {
+        using enum ArchiveFormat;
+        case PCM:
+            {
+                if (!forge_archive_parse_sound(source)) {
+                    log_format(LOG_PREFIX_WARN "ARCHIVE > Invalid sound " ANSI_GREEN "'%s'" ANSI_RESET, path);
+                    file::unmap(&source->map);
+                    return false;
+                }
+            }
+            break;
+        case RGBA8:
+            {
+                // Atlas pixels are taken straight from the atlas cache
+                const AtlasCacheHeader* header = (const AtlasCacheHeader*)source->map.data;
+                bool isValid = source->map.size >= sizeof(AtlasCacheHeader) && header->magic == CONFIG_ATLAS_CACHE_MAGIC && header->version == CONFIG_ATLAS_CACHE_VERSION;
+
+                if (isValid) {
+                    source->entry.image.width = (u32)header->size.w;
+                    source->entry.image.height = (u32)header->size.h;
+                    source->entry.image.layerCount = header->pageCount;
+                    source->entry.size = (u64)header->size.w * header->size.h * 4 * header->pageCount;
+                    source->dataOffset = sizeof(AtlasCacheHeader) + sizeof(AtlasCacheEntry) * (u64)header->assetCount;
+                    isValid = source->map.size == source->dataOffset + source->entry.size;
+                }
+
+                if (!isValid) {
+                    log_format(LOG_PREFIX_WARN "ARCHIVE > Invalid atlas cache " ANSI_GREEN "'%s'" ANSI_RESET, path);
+                    file::unmap(&source->map);
+                    return false;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    (*sourceCount)++;
+    return true;
+}
+
+bool forge_write_archive() {
+    log_format(ANSI_CYAN "[FORGE] " ANSI_RESET "Writing resource archive!");
+
+    u32 maxSourceCount = 0;
+    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
+        const Bundle* bundles = gPersistent.bundles[i];
+        if (bundles) maxSourceCount += bundles[as_index(BundleType::PRIMARY)].assetCount;
+    }
 
-        // Include the header
-        if (string_is_valid(config->headerPath)) {
-            file::File headerPartFile = file::open(config->headerPath, file::Mode::READ);
+    u32 sourceCount = 0;
+    ArchiveSource* sources = (ArchiveSource*)memory::alloc(sizeof(ArchiveSource) * (maxSourceCount > 0 ? maxSourceCount : 1));
+    bool success = true;
+
+    // Collect every asset that has a standalone resource, sprites/tiles/particles only exist within their atlas
+    for (u32 typeIdx = 0; typeIdx < as_index(AssetType::COUNT) && success; typeIdx++) {
+        const Bundle* bundles = gPersistent.bundles[typeIdx];
+        if (!bundles) continue;
+
+        AssetType assetType = (AssetType)typeIdx;
+        const Bundle* primaryBundle = &bundles[as_index(BundleType::PRIMARY)];
+
+        ArchiveFormat format = ArchiveFormat::COUNT;
+        switch (assetType) {
+            using enum AssetType;
+            case FONT:  format = ArchiveFormat::FONT;        break;
+            case SOUND: format = ArchiveFormat::PCM;         break;
+            case MUSIC: format = ArchiveFormat::OGG;         break;
+            case ATLAS: format = ArchiveFormat::RGBA8;       break;
+            default: break;
+        }
+
+        if (format == ArchiveFormat::COUNT) continue;
+
+        for (u32 i = 0; i < primaryBundle->assetCount; i++) {
+            const Asset* asset = &primaryBundle->assets[i];
+
+            char filePathStr[MAX_PATH] = "";
+            if (assetType == AssetType::ATLAS) {
+                // Atlases no asset type generated have no cache to store
+                if (asset->data.atlasOf == AssetType::COUNT) continue;
+
+                const AssetConfig* atlasConfig = &gAssetConfigs[as_index(asset->data.atlasOf)];
+                forge_atlas_complete_cache(atlasConfig);
+                forge_atlas_get_cache_path(atlasConfig, filePathStr);
+            } else if (assetType == AssetType::SOUND) {
+                forge_sound_get_output_path(asset, filePathStr);
+            } else if (assetType == AssetType::FONT) {
+                forge_font_get_output_path(asset, filePathStr);
+            } else {
+                strcpy(filePathStr, primaryBundle->path);
+                strcat(filePathStr, "/");
+                strcat(filePathStr, asset->fileName);
+            }
+
+            if (!forge_archive_add_source(sources, &sourceCount, maxSourceCount, assetType, i, format, filePathStr)) {
+                log_format(LOG_PREFIX_WARN "ARCHIVE > Failed to add " ANSI_GREEN "'%s'" ANSI_RESET, filePathStr);
+                success = false;
+                break;
+            }
+        }
+    }
+
+    if (success) {
+        // Lay out the data blocks, each one starts on an aligned offset
+        u64 tableSize = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * (u64)sourceCount;
+        u64 offset = (tableSize + ARCHIVE_ALIGNMENT - 1) & ~((u64)ARCHIVE_ALIGNMENT - 1);
+
+        u8* table = (u8*)memory::alloc(tableSize);
+        ArchiveHeader* header = (ArchiveHeader*)table;
+        ArchiveEntry* entries = (ArchiveEntry*)(table + sizeof(ArchiveHeader));
+
+        for (u32 i = 0; i < sourceCount; i++) {
+            ArchiveSource* source = &sources[i];
+            source->entry.offset = offset;
+            entries[i] = source->entry;
+
+            offset += (source->entry.size + ARCHIVE_ALIGNMENT - 1) & ~((u64)ARCHIVE_ALIGNMENT - 1);
+        }
+
+        header->magic = ARCHIVE_MAGIC;
+        header->version = ARCHIVE_VERSION;
+        header->alignment = ARCHIVE_ALIGNMENT;
+        header->entryCount = sourceCount;
+        header->totalSize = offset;
+
+        // Write the table followed by every data block, into a side file so a failed write keeps the last good archive
+        u8* padding = (u8*)memory::alloc(ARCHIVE_ALIGNMENT);
+        file::File archiveFile = file::open(CONFIG_ARCHIVE_PATH ".new", file::Mode::WRITE, true);
 
-            i32 size = file::get_size(&headerPartFile);
-            i32 bytesRead = 0;
-            char* data = (char*)memory::alloc(size);
+        u64 written = 0;
+        success = archiveFile.handle && file::write(&archiveFile, table, (i32)tableSize);
+        written += tableSize;
 
-            file::read(&headerPartFile, data, size, &bytesRead);
-            file::write(&headerFile, data, bytesRead);
-            if (i != as_index(AssetType::COUNT) - 1) file::write_line(&headerFile, "");
+        for (u32 i = 0; i < sourceCount && success; i++) {
+            const ArchiveSource* source = &sources[i];
 
-            file::close(&headerPartFile);
+            if (entries[i].offset > written) {
+                success = file::write(&archiveFile, padding, (i32)(entries[i].offset - written));
+                written = entries[i].offset;
+            }
+
+            if (success && source->entry.size > 0) {
+                success = forge_file_write_large(&archiveFile, source->map.data + source->dataOffset, source->entry.size);
+                written += source->entry.size;
+            }
         }
 
-        // Include the source (if available)
-        if (string_is_valid(config->sourcePath)) {
-            file::File sourcePartFile = file::open(config->sourcePath, file::Mode::READ);
+        if (success && header->totalSize > written) {
+            success = file::write(&archiveFile, padding, (i32)(header->totalSize - written));
+        }
 
-            i32 size = file::get_size(&sourcePartFile);
-            i32 bytesRead = 0;
-            char* data = (char*)memory::alloc(size);
+        file::close(&archiveFile);
+        memory::free(padding);
+        memory::free(table);
 
-            file::read(&sourcePartFile, data, size, &bytesRead);
-            file::write(&sourceFile, data, bytesRead);
-            if (i != as_index(AssetType::COUNT) - 1) file::write_line(&sourceFile, "");
+        if (success) success = file::replace(CONFIG_ARCHIVE_PATH ".new", CONFIG_ARCHIVE_PATH);
 
-            file::close(&sourcePartFile);
+        if (success) {
+            log_format("- Generated archive: " ANSI_GREEN "'%s'" ANSI_RESET " (%u entries, %llu bytes)", CONFIG_ARCHIVE_PATH, sourceCount, (unsigned long long)offset);
+        } else {
+            if (file::exists(CONFIG_ARCHIVE_PATH ".new")) file::remove(CONFIG_ARCHIVE_PATH ".new");
+            log_format(LOG_PREFIX_WARN "ARCHIVE > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, CONFIG_ARCHIVE_PATH);
         }
     }
 
-    // -- File Footers
-    file::write_line(&headerFile, "}; // namespace: asset");
-    file::close(&headerFile);
-    log_format("- Generated file: " ANSI_GREEN "'%s'" ANSI_RESET, headerPath);
+    for (u32 i = 0; i < sourceCount; i++) {
+        file::unmap(&sources[i].map);
+    }
 
-    file::write_line(&sourceFile, "}; // namespace: asset");
-    file::close(&sourceFile);
-    log_format("- Generated file: " ANSI_GREEN "'%s'" ANSI_RESET, sourcePath);
+    memory::free(sources);
+    return success;
 }
 
 // -------------------------------------------
 // Asset Forge Entry
 // -------------------------------------------
 
+// -- Outputs
+void forge_write_outputs() {
+    // Combine asset files
+    if (forge_get_status() == StatusCode::CHANGED) {
+        forge_combine_asset_files();
+
+        if (forge_get_status() == StatusCode::FAILURE) {
+            log_format(LOG_PREFIX_ERRO "FORGE > Failed to combine asset files!");
+        }
+    }
+
+    // Pack the resources into a single archive
+    if (forge_is_flag_set(Flags::WRITE_ARCHIVE) && forge_get_status() != StatusCode::FAILURE) {
+        if (forge_get_status() == StatusCode::CHANGED || !file::exists(CONFIG_ARCHIVE_PATH)) {
+            trace::Scope scope = trace::begin("archive.write");
+
+            if (!forge_write_archive()) {
+                log_format(LOG_PREFIX_ERRO "FORGE > Failed to write resource archive!");
+                forge_set_status(StatusCode::FAILURE);
+            }
+
+            trace::end(&scope);
+        }
+    }
+}
+
+// -- Trace
+// Every traced stage of the run summed up, stages of asset types that ran at the same time overlap,
+// so their shares can add up to more than the wall time
+void forge_report_trace() {
+    trace::Total totals[CONFIG_TRACE_MAX_TOTALS] = {};
+    u32 totalCount = trace::get_totals(totals, CONFIG_TRACE_MAX_TOTALS);
+    f64 elapsedMs = trace::get_elapsed_ms();
+
+    // The process peak never resets, so each run reports the highest working set its own stages ended with instead
+    u64 peakWorkingSet = 0;
+    for (u32 i = 0; i < totalCount; i++) {
+        if (totals[i].peakWorkingSet > peakWorkingSet) peakWorkingSet = totals[i].peakWorkingSet;
+    }
+
+    log_format(ANSI_CYAN "[TRACE] " ANSI_RESET "%.1f ms wall time, %u jobs, %.1f MB peak working set at stage ends", elapsedMs, forge_get_job_count(),
+               peakWorkingSet / (1024.0 * 1024.0));
+    log_format("  %-18s %6s %8s %11s %10s %7s %10s %9s %9s", "stage", "calls", "items", "total ms", "max ms", "share", "MB", "MB/s", "peak MB");
+
+    for (u32 i = 0; i < totalCount; i++) {
+        const trace::Total* total = &totals[i];
+        f64 totalMs = timer::ticks_to_ms(total->ticks);
+        f64 megabytes = total->byteCount / (1024.0 * 1024.0);
+
+        log_format("  %-18s %6u %8llu %11.2f %10.2f %6.1f%% %10.2f %9.1f %9.1f", total->name, total->count, (unsigned long long)total->itemCount,
+                   totalMs, timer::ticks_to_ms(total->maxTicks), elapsedMs > 0.0 ? totalMs / elapsedMs * 100.0 : 0.0,
+                   megabytes, totalMs > 0.0 ? megabytes / (totalMs / 1000.0) : 0.0, total->peakWorkingSet / (1024.0 * 1024.0));
+    }
+
+    const char* tracePath = forge_get_trace_path();
+    if (!tracePath) return;
+
+    if (trace::write(tracePath)) {
+        log_format("- Wrote %u trace events to " ANSI_GREEN "'%s'" ANSI_RESET, trace::get_event_count(), tracePath);
+    } else {
+        log_format(LOG_PREFIX_WARN "TRACE > Failed to write " ANSI_GREEN "'%s'" ANSI_RESET, tracePath);
+    }
+}
+
+// -- Watch
+// Blocks until the process is closed, every burst of changes rebuilds only the asset types whose directories changed
+void forge_watch() {
+    watch::Watcher* watcher = (watch::Watcher*)memory::alloc(sizeof(watch::Watcher));
+
+    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
+        if (i == as_index(AssetType::ATLAS)) continue;
+
+        char watchPath[MAX_PATH] = "";
+        sprintf(watchPath, CONFIG_ASSET_PATH "/%s", gAssetConfigs[i].type);
+
+        // Manifests are written into the watched directories by the rebuild itself
+        if (!watch::add(watcher, watchPath, i, ".manifest")) {
+            log_format(LOG_PREFIX_WARN "WATCH > Could not watch directory " ANSI_GREEN "'%s'" ANSI_RESET, watchPath);
+        }
+    }
+
+    log_format(ANSI_CYAN "[WATCH] " ANSI_RESET "Watching %u asset directories, press Ctrl+C to stop", watcher->directoryCount);
+
+    while (true) {
+        u32 typeMask = 0;
+        if (!watch::wait(watcher, watch::WAIT_FOREVER, &typeMask)) break;
+        if (typeMask == 0) continue;
+
+        // Keep collecting until the directories go quiet
+        u32 moreTypes = typeMask;
+        while (moreTypes != 0) {
+            moreTypes = 0;
+            if (!watch::wait(watcher, CONFIG_WATCH_DEBOUNCE_MS, &moreTypes)) break;
+            typeMask |= moreTypes;
+        }
+
+        u64 startTicks = timer::get_ticks();
+        trace::reset();
+
+        forge_set_status(StatusCode::SKIPPED);
+        forge_schedule_asset_parts(typeMask);
+        forge_write_outputs();
+
+        const char* result = (forge_get_status() == StatusCode::FAILURE) ? ANSI_RED "failed" ANSI_RESET : ANSI_GREEN "done" ANSI_RESET;
+        log_format(ANSI_CYAN "[WATCH] " ANSI_RESET "Rebuild %s in %.1f ms", result, timer::ticks_to_ms(timer::get_ticks() - startTicks));
+        forge_pixel_cache_evict();
+        forge_atlas_store_evict();
+        forge_report_trace();
+    }
+
+    log_format(LOG_PREFIX_ERRO "WATCH > Lost track of the asset directories, stopping");
+    forge_set_status(StatusCode::FAILURE);
+
+    watch::destroy(watcher);
+    memory::free(watcher);
+}
+
 i32 main(int argc, char* argv[]) {
     // Enable flags if provided
     if (argc > 1) {
@@ -1234,11 +4045,97 @@ i32 main(int argc, char* argv[]) {
             if (strcmp(argv[i], "--force") == 0) {
                 FLAG_ADD(flags, Flags::FORCE_GENERATION);
             }
+
+            if (strcmp(argv[i], "--archive") == 0) {
+                FLAG_ADD(flags, Flags::WRITE_ARCHIVE);
+            }
+
+            if (strcmp(argv[i], "--watch") == 0) {
+                FLAG_ADD(flags, Flags::WATCH);
+            }
+
+            // Trusts unchanged write times instead of hashing every asset, for quick local iteration
+            if (strcmp(argv[i], "--fast") == 0) {
+                FLAG_ADD(flags, Flags::TRUST_WRITE_TIME);
+            }
+
+            // Number of asset types generated at the same time | 1 to CONFIG_MAX_JOB_COUNT
+            if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+                char* end = NULL;
+                const char* value = argv[++i];
+                unsigned long jobCount = strtoul(value, &end, 10);
+
+                if (value[0] >= '0' && value[0] <= '9' && *end == '\0' && jobCount > 0 && jobCount <= CONFIG_MAX_JOB_COUNT) {
+                    forge_set_job_count((u32)jobCount);
+                } else {
+                    log_format(LOG_PREFIX_WARN "FORGE > Invalid job count " ANSI_GREEN "'%s'" ANSI_RESET ", expected 1 to %u", value, CONFIG_MAX_JOB_COUNT);
+                }
+            }
+
+            // Atlas compression | fast = dev iteration, small = release packaging
+            if (strcmp(argv[i], "--png-level") == 0 && i + 1 < argc) {
+                png::Level level = png::Level::DEFAULT;
+                if (png::parse_level(argv[++i], &level)) {
+                    forge_set_png_level(level);
+                } else {
+                    log_format(LOG_PREFIX_WARN "FORGE > Unknown png level " ANSI_GREEN "'%s'" ANSI_RESET ", expected fast, default or small", argv[i]);
+                }
+            }
+
+            // Sample format of processed sounds | s16, f32 or adpcm
+            if (strcmp(argv[i], "--audio-format") == 0 && i + 1 < argc) {
+                AudioFormat format = AudioFormat::S16;
+                if (audio::parse_format(argv[++i], &format)) {
+                    forge_set_audio_format(format);
+                } else {
+                    log_format(LOG_PREFIX_WARN "FORGE > Unknown audio format " ANSI_GREEN "'%s'" ANSI_RESET ", expected s16, f32 or adpcm", argv[i]);
+                }
+            }
+
+            // Chrome trace event json of every traced stage, open in chrome://tracing or ui.perfetto.dev
+            if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+                forge_set_trace_path(argv[++i]);
+            }
+
+            // Size budget of the decoded image cache in MB | 0 = no cache
+            if (strcmp(argv[i], "--pixel-cache") == 0 && i + 1 < argc) {
+                forge_set_pixel_cache_budget((u64)strtoull(argv[++i], NULL, 10) * 1024 * 1024);
+            }
+
+            // Size budget of the atlas output store in MB | 0 = no store
+            if (strcmp(argv[i], "--atlas-store") == 0 && i + 1 < argc) {
+                forge_set_atlas_store_budget((u64)strtoull(argv[++i], NULL, 10) * 1024 * 1024);
+            }
+
+            // Decoded image size in MB above which atlases are streamed | 0 = always stream
+            if (strcmp(argv[i], "--decode-budget") == 0 && i + 1 < argc) {
+                forge_set_decode_budget((u64)strtoull(argv[++i], NULL, 10) * 1024 * 1024);
+            }
+
+            // Also writes block compressed atlases (.dds) | none, bc1, bc3 or bc7
+            if (strcmp(argv[i], "--compress") == 0 && i + 1 < argc) {
+                bcn::Format format = bcn::Format::NONE;
+                if (bcn::parse_format(argv[++i], &format)) {
+                    forge_set_bc_format(format);
+                } else {
+                    log_format(LOG_PREFIX_WARN "FORGE > Unknown block format " ANSI_GREEN "'%s'" ANSI_RESET ", expected none, bc1, bc3 or bc7", argv[i]);
+                }
+            }
         }
 
         forge_set_flags(flags);
     }
 
+    thread::mutex_init(&gStatusMutex);
+    trace::init();
+
+    // The calling thread also runs jobs while waiting, so it counts towards the total
+    if (!thread::pool_create(&gPool, forge_get_job_count() - 1)) {
+        log_format(LOG_PREFIX_ERRO "FORGE > Failed to create a pool with %u jobs", forge_get_job_count());
+        forge_set_status(StatusCode::FAILURE);
+        goto exit_main;
+    }
+
     // Generate partial asset files and their resources
     errno = 0;
     DIR* handle = opendir(CONFIG_TEMP_PATH);
@@ -1248,23 +4145,32 @@ i32 main(int argc, char* argv[]) {
         goto exit_main;
     }
 
-    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
-        forge_generate_asset_part((AssetType)i);
+    // Without its directory the cache is skipped, images are then decoded from their source every run
+    if (forge_get_pixel_cache_budget() > 0 && !CreateDirectoryA(CONFIG_PIXEL_CACHE_PATH, NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+        log_format(LOG_PREFIX_WARN "FORGE > Could not create " ANSI_GREEN "'%s'" ANSI_RESET ", the pixel cache is disabled", CONFIG_PIXEL_CACHE_PATH);
+        forge_set_pixel_cache_budget(0);
+    }
 
-        if (forge_get_status() == StatusCode::FAILURE) {
-            log_format(LOG_PREFIX_ERRO "FORGE > Failed to generate asset!");
-        }
+    if (forge_get_atlas_store_budget() > 0 && !CreateDirectoryA(CONFIG_ATLAS_STORE_PATH, NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+        log_format(LOG_PREFIX_WARN "FORGE > Could not create " ANSI_GREEN "'%s'" ANSI_RESET ", the atlas store is disabled", CONFIG_ATLAS_STORE_PATH);
+        forge_set_atlas_store_budget(0);
     }
 
-    // Combine asset files
-    if (forge_get_status() == StatusCode::CHANGED) {
-        forge_combine_asset_files();
+    forge_schedule_asset_parts(FORGE_ALL_ASSET_TYPES);
+    forge_write_outputs();
+    forge_pixel_cache_evict();
+    forge_atlas_store_evict();
+    forge_report_trace();
 
-        if (forge_get_status() == StatusCode::FAILURE) {
-            log_format(LOG_PREFIX_ERRO "FORGE > Failed to combine asset files!");
-        }
-    }
+    if (forge_is_flag_set(Flags::WATCH)) forge_watch();
 
 exit_main:
+    for (u32 i = 0; i < as_index(AssetType::COUNT); i++) {
+        forge_release_bundles(gPersistent.bundles[i]);
+        if (gPersistent.residentImages[i].entries) memory::free(gPersistent.residentImages[i].entries);
+    }
+
+    thread::pool_destroy(&gPool);
+    trace::release();
     return (i32)forge_get_status();
 }
@@ -0,0 +1,246 @@
+#include "pch.hpp"
+
+#include "forge/mip.hpp"
+
+#include "GEM/core/memory.hpp"
+#include "GEM/math/mathf.hpp"
+
+#include <emmintrin.h>
+
+namespace mip {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // NOTE: Every texel is handled as one SSE vector (RGBA in four float lanes), SSE2 is part of the x64 baseline.
+    static const i32 KAISER_TAP_COUNT = 12; // Source texels per axis for one destination texel
+    static const f32 KAISER_WIDTH = 3.0f;   // In destination texels
+    static const f32 KAISER_BETA = 4.0f;
+
+    static const u32 KAISER_CHUNK_ROW_COUNT = 16;
+
+    struct DownsampleJob {
+        const u8* src;
+        i32 srcWidth;
+        i32 srcHeight;
+
+        u8* dest;
+        i32 destWidth;
+        i32 destHeight;
+
+        f32 weights[KAISER_TAP_COUNT];
+    };
+
+    static inline i32 clamp_index(i32 value, i32 count) {
+        return (value < 0) ? 0 : (value >= count) ? count - 1 : value;
+    }
+
+    static inline __m128 load_texel(const u8* ptr) {
+        i32 packed;
+        memcpy(&packed, ptr, sizeof(i32));
+
+        __m128i zero = _mm_setzero_si128();
+        __m128i value = _mm_cvtsi32_si128(packed);
+        value = _mm_unpacklo_epi8(value, zero);
+        value = _mm_unpacklo_epi16(value, zero);
+        return _mm_cvtepi32_ps(value);
+    }
+
+    static inline __m128 premultiply(__m128 texel) {
+        return _mm_mul_ps(texel, _mm_shuffle_ps(texel, texel, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+
+    // Turns the alpha weighted sum back into straight colour, fully transparent results keep the plain average
+    static inline void store_texel(u8* ptr, __m128 premultiplied, __m128 plain) {
+        f32 colour[4], alpha[4];
+        _mm_storeu_ps(colour, premultiplied);
+        _mm_storeu_ps(alpha, plain);
+
+        __m128 output = plain;
+        if (alpha[3] > 0.5f) {
+            f32 scale = 1.0f / alpha[3];
+            output = _mm_set_ps(alpha[3], colour[2] * scale, colour[1] * scale, colour[0] * scale);
+        }
+
+        output = _mm_min_ps(_mm_max_ps(output, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+
+        __m128i value = _mm_cvtps_epi32(output);
+        value = _mm_packs_epi32(value, value);
+        value = _mm_packus_epi16(value, value);
+
+        i32 packed = _mm_cvtsi128_si32(value);
+        memcpy(ptr, &packed, sizeof(i32));
+    }
+
+    static f64 bessel_i0(f64 x) {
+        f64 sum = 1.0;
+        f64 term = 1.0;
+        f64 halfX = x * 0.5;
+
+        for (u32 k = 1; k < 32; k++) {
+            term *= halfX / k;
+            sum += term * term;
+            if (term * term < sum * 1e-12) break;
+        }
+
+        return sum;
+    }
+
+    static void init_kaiser_weights(f32* weights) {
+        f64 total = 0.0;
+        f64 values[KAISER_TAP_COUNT];
+
+        // Source texel t sits at (t - 5.5) / 2 destination texels from the centre
+        for (i32 t = 0; t < KAISER_TAP_COUNT; t++) {
+            f64 x = (t - (KAISER_TAP_COUNT / 2 - 0.5)) * 0.5;
+            f64 sinc = (x == 0.0) ? 1.0 : sin(mathf::PI * x) / (mathf::PI * x);
+
+            f64 ratio = x / KAISER_WIDTH;
+            f64 window = (fabs(ratio) < 1.0) ? bessel_i0(KAISER_BETA * sqrt(1.0 - ratio * ratio)) / bessel_i0(KAISER_BETA) : 0.0;
+
+            values[t] = sinc * window;
+            total += values[t];
+        }
+
+        for (i32 t = 0; t < KAISER_TAP_COUNT; t++) {
+            weights[t] = (f32)(values[t] / total);
+        }
+    }
+
+    static void box_row(void* data, u32 y) {
+        DownsampleJob* job = (DownsampleJob*)data;
+        const __m128 quarter = _mm_set1_ps(0.25f);
+
+        const u8* row0 = job->src + (u64)clamp_index(y * 2 + 0, job->srcHeight) * job->srcWidth * 4;
+        const u8* row1 = job->src + (u64)clamp_index(y * 2 + 1, job->srcHeight) * job->srcWidth * 4;
+        u8* dest = job->dest + (u64)y * job->destWidth * 4;
+
+        for (i32 x = 0; x < job->destWidth; x++) {
+            i32 x0 = clamp_index(x * 2 + 0, job->srcWidth) * 4;
+            i32 x1 = clamp_index(x * 2 + 1, job->srcWidth) * 4;
+
+            __m128 a = load_texel(row0 + x0);
+            __m128 b = load_texel(row0 + x1);
+            __m128 c = load_texel(row1 + x0);
+            __m128 d = load_texel(row1 + x1);
+
+            __m128 plain = _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d));
+            __m128 premultiplied = _mm_add_ps(_mm_add_ps(premultiply(a), premultiply(b)), _mm_add_ps(premultiply(c), premultiply(d)));
+
+            store_texel(dest + x * 4, _mm_mul_ps(premultiplied, quarter), _mm_mul_ps(plain, quarter));
+        }
+    }
+
+    // Separable filter, each chunk of destination rows filters the source rows it needs horizontally first
+    static void kaiser_chunk(void* data, u32 chunkIdx) {
+        DownsampleJob* job = (DownsampleJob*)data;
+        const i32 tapOffset = KAISER_TAP_COUNT / 2 - 1;
+
+        i32 firstRow = (i32)(chunkIdx * KAISER_CHUNK_ROW_COUNT);
+        i32 lastRow = firstRow + (i32)KAISER_CHUNK_ROW_COUNT;
+        if (lastRow > job->destHeight) lastRow = job->destHeight;
+
+        i32 srcFirst = firstRow * 2 - tapOffset;
+        i32 srcRowCount = (lastRow - 1) * 2 - tapOffset + KAISER_TAP_COUNT - srcFirst;
+
+        u64 tempCount = (u64)srcRowCount * job->destWidth;
+        __m128* tempPremultiplied = (__m128*)memory::alloc(sizeof(__m128) * tempCount);
+        __m128* tempPlain = (__m128*)memory::alloc(sizeof(__m128) * tempCount);
+
+        // Horizontal
+        for (i32 r = 0; r < srcRowCount; r++) {
+            const u8* srcRow = job->src + (u64)clamp_index(srcFirst + r, job->srcHeight) * job->srcWidth * 4;
+
+            for (i32 x = 0; x < job->destWidth; x++) {
+                __m128 plain = _mm_setzero_ps();
+                __m128 premultiplied = _mm_setzero_ps();
+
+                for (i32 t = 0; t < KAISER_TAP_COUNT; t++) {
+                    __m128 texel = load_texel(srcRow + clamp_index(x * 2 - tapOffset + t, job->srcWidth) * 4);
+                    __m128 weight = _mm_set1_ps(job->weights[t]);
+
+                    plain = _mm_add_ps(plain, _mm_mul_ps(texel, weight));
+                    premultiplied = _mm_add_ps(premultiplied, _mm_mul_ps(premultiply(texel), weight));
+                }
+
+                _mm_storeu_ps((f32*)&tempPlain[(u64)r * job->destWidth + x], plain);
+                _mm_storeu_ps((f32*)&tempPremultiplied[(u64)r * job->destWidth + x], premultiplied);
+            }
+        }
+
+        // Vertical
+        for (i32 y = firstRow; y < lastRow; y++) {
+            i32 firstTapRow = y * 2 - tapOffset - srcFirst;
+            u8* dest = job->dest + (u64)y * job->destWidth * 4;
+
+            for (i32 x = 0; x < job->destWidth; x++) {
+                __m128 plain = _mm_setzero_ps();
+                __m128 premultiplied = _mm_setzero_ps();
+
+                for (i32 t = 0; t < KAISER_TAP_COUNT; t++) {
+                    u64 idx = (u64)(firstTapRow + t) * job->destWidth + x;
+                    __m128 weight = _mm_set1_ps(job->weights[t]);
+
+                    plain = _mm_add_ps(plain, _mm_mul_ps(_mm_loadu_ps((const f32*)&tempPlain[idx]), weight));
+                    premultiplied = _mm_add_ps(premultiplied, _mm_mul_ps(_mm_loadu_ps((const f32*)&tempPremultiplied[idx]), weight));
+                }
+
+                store_texel(dest + x * 4, premultiplied, plain);
+            }
+        }
+
+        memory::free(tempPlain);
+        memory::free(tempPremultiplied);
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    u32 get_level_count(i32 width, i32 height) {
+        i32 size = (width > height) ? width : height;
+
+        u32 count = 1;
+        while (size > 1) {
+            size /= 2;
+            count++;
+        }
+
+        return count;
+    }
+
+    u32 get_contained_level_count(AtlasMipFilter filter, u32 border) {
+        // Each level reads this many source texels past its own 2x2 block, and that block can straddle the rect's edge
+        u64 tapReach = (filter == AtlasMipFilter::KAISER) ? KAISER_TAP_COUNT / 2 - 1 : 0;
+
+        u32 count = 1;
+        while (count < 32 && (tapReach + 1) * ((1ull << count) - 1) <= border) count++;
+
+        return count;
+    }
+
+    void downsample(const u8* src, i32 srcWidth, i32 srcHeight, u8* dest, AtlasMipFilter filter, thread::Pool* pool) {
+        DownsampleJob job = {};
+        job.src = src;
+        job.srcWidth = srcWidth;
+        job.srcHeight = srcHeight;
+        job.dest = dest;
+        job.destWidth = (srcWidth > 1) ? srcWidth / 2 : 1;
+        job.destHeight = (srcHeight > 1) ? srcHeight / 2 : 1;
+
+        switch (filter) {
+            case AtlasMipFilter::KAISER:
+                {
+                    init_kaiser_weights(job.weights);
+                    u32 chunkCount = ((u32)job.destHeight + KAISER_CHUNK_ROW_COUNT - 1) / KAISER_CHUNK_ROW_COUNT;
+                    thread::pool_dispatch(pool, chunkCount, kaiser_chunk, &job);
+                }
+                break;
+            default:
+                {
+                    thread::pool_dispatch(pool, (u32)job.destHeight, box_row, &job);
+                }
+                break;
+        }
+    }
+}
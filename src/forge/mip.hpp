@@ -0,0 +1,23 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "forge/component/atlas.hpp"
+
+#include "GEM/core/thread.hpp"
+
+// -------------------------------------------
+// Mip Generation
+// -------------------------------------------
+// Halves tightly packed RGBA8 images, colour is weighted by alpha so transparent texels never darken their neighbours.
+
+namespace mip {
+    // Number of levels including the base, down to 1x1
+    u32 get_level_count(i32 width, i32 height);
+
+    // Levels including the base whose filter footprint stays within a border of this many texels around an unaligned rect
+    u32 get_contained_level_count(AtlasMipFilter filter, u32 border);
+
+    // Destination must be max(1, size / 2) on both axes
+    void downsample(const u8* src, i32 srcWidth, i32 srcHeight, u8* dest, AtlasMipFilter filter, thread::Pool* pool);
+}
@@ -0,0 +1,465 @@
+#include "pch.hpp"
+
+#include "forge/pack.hpp"
+
+#include "GEM/core/memory.hpp"
+
+namespace pack {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Reference: Jukka Jylänki, "A Thousand Ways to Pack the Bin"
+    struct FreeRect {
+        i32 x;
+        i32 y;
+        i32 w;
+        i32 h;
+    };
+
+    struct FreeList {
+        FreeRect* rects;
+        u32 count;
+        u32 capacity;
+    };
+
+    struct SortKey {
+        i32 maxSide;
+        i32 area;
+        u32 index;
+    };
+
+    struct SearchJob {
+        const stbrp_rect* input;
+        u32 rectCount;
+        Heuristic heuristic;
+        bool allowRotation;
+        i32 width;
+        i32 minHeight;
+        i32 maxHeight;
+
+        stbrp_rect* rects; // Scratch copy, holds the final layout once the search is done
+        i32 height;        // 0 when nothing fits at this width
+    };
+
+    // Ratios of the square root of the total area tried as atlas widths
+    static const f32 WIDTH_FACTORS[] = { 0.75f, 0.875f, 1.0f, 1.125f, 1.25f, 1.5f, 1.75f, 2.0f };
+
+    // Skyline is tried first, so cutting the list short leaves only it
+    static inline u32 get_heuristic_count(u32 rectCount) {
+        return (rectCount > SEARCH_RECT_LIMIT) ? 1 : as_index(Heuristic::COUNT);
+    }
+
+    static inline i32 align_up(i32 value) {
+        return (value + SIZE_STEP - 1) / SIZE_STEP * SIZE_STEP;
+    }
+
+    static void free_list_push(FreeList* list, FreeRect rect) {
+        if (list->count == list->capacity) {
+            u32 newCapacity = list->capacity > 0 ? list->capacity * 2 : 64;
+            FreeRect* newRects = (FreeRect*)memory::alloc(sizeof(FreeRect) * newCapacity);
+            if (list->rects) {
+                memory::copy(newRects, list->rects, sizeof(FreeRect) * list->count);
+                memory::free(list->rects);
+            }
+
+            list->rects = newRects;
+            list->capacity = newCapacity;
+        }
+
+        list->rects[list->count++] = rect;
+    }
+
+    static inline bool is_contained(const FreeRect* a, const FreeRect* b) {
+        return a->x >= b->x && a->y >= b->y && a->x + a->w <= b->x + b->w && a->y + a->h <= b->y + b->h;
+    }
+
+    static i32 sort_key_compare(const void* a, const void* b) {
+        const SortKey* keyA = (const SortKey*)a;
+        const SortKey* keyB = (const SortKey*)b;
+
+        if (keyA->maxSide != keyB->maxSide) return keyB->maxSide - keyA->maxSide;
+        if (keyA->area != keyB->area) return (keyB->area > keyA->area) ? 1 : -1;
+        return (keyA->index > keyB->index) ? 1 : -1;
+    }
+
+    // Splits every free rect overlapped by 'used' into its maximal leftovers, then drops the ones that became redundant
+    static void maxrects_place(FreeList* list, FreeList* scratch, const FreeRect* used) {
+        scratch->count = 0;
+        u32 firstNew = 0;
+
+        // Untouched rects first, so everything after 'firstNew' is a fresh split
+        for (u32 i = 0; i < list->count; i++) {
+            const FreeRect* f = &list->rects[i];
+            bool isOverlapping = used->x < f->x + f->w && used->x + used->w > f->x && used->y < f->y + f->h && used->y + used->h > f->y;
+            if (!isOverlapping) free_list_push(scratch, *f);
+        }
+        firstNew = scratch->count;
+
+        for (u32 i = 0; i < list->count; i++) {
+            const FreeRect* f = &list->rects[i];
+            bool isOverlapping = used->x < f->x + f->w && used->x + used->w > f->x && used->y < f->y + f->h && used->y + used->h > f->y;
+            if (!isOverlapping) continue;
+
+            if (used->y > f->y) free_list_push(scratch, { f->x, f->y, f->w, used->y - f->y });
+            if (used->y + used->h < f->y + f->h) free_list_push(scratch, { f->x, used->y + used->h, f->w, f->y + f->h - (used->y + used->h) });
+            if (used->x > f->x) free_list_push(scratch, { f->x, f->y, used->x - f->x, f->h });
+            if (used->x + used->w < f->x + f->w) free_list_push(scratch, { used->x + used->w, f->y, f->x + f->w - (used->x + used->w), f->h });
+        }
+
+        // NOTE: Old rects were already pruned against each other, only pairs involving a new split need checking
+        list->count = 0;
+        for (u32 i = 0; i < scratch->count; i++) {
+            const FreeRect* candidate = &scratch->rects[i];
+            bool isRedundant = false;
+
+            u32 start = (i < firstNew) ? firstNew : 0;
+            for (u32 j = start; j < scratch->count && !isRedundant; j++) {
+                if (i == j) continue;
+                if (!is_contained(candidate, &scratch->rects[j])) continue;
+
+                // Identical rects, keep the first one
+                if (is_contained(&scratch->rects[j], candidate) && j > i) continue;
+                isRedundant = true;
+            }
+
+            if (!isRedundant) free_list_push(list, *candidate);
+        }
+    }
+
+    static inline void swap_sides(stbrp_rect* rect) {
+        i32 temp = rect->w;
+        rect->w = rect->h;
+        rect->h = temp;
+    }
+
+    static bool maxrects_pack(Heuristic heuristic, Vec2i size, bool allowRotation, stbrp_rect* rects, u32 rectCount) {
+        SortKey* keys = (SortKey*)memory::alloc(sizeof(SortKey) * (rectCount > 0 ? rectCount : 1));
+        for (u32 i = 0; i < rectCount; i++) {
+            keys[i].maxSide = (rects[i].w > rects[i].h) ? rects[i].w : rects[i].h;
+            keys[i].area = rects[i].w * rects[i].h;
+            keys[i].index = i;
+        }
+        qsort(keys, rectCount, sizeof(SortKey), sort_key_compare);
+
+        FreeList list = {};
+        FreeList scratch = {};
+        free_list_push(&list, { 0, 0, size.w, size.h });
+
+        bool success = true;
+        for (u32 k = 0; k < rectCount; k++) {
+            stbrp_rect* rect = &rects[keys[k].index];
+            rect->was_packed = 0;
+
+            // Empty images take no space
+            if (rect->w == 0 || rect->h == 0) {
+                rect->x = 0;
+                rect->y = 0;
+                rect->was_packed = 1;
+                continue;
+            }
+
+            i64 bestPrimary = INT64_MAX;
+            i64 bestSecondary = INT64_MAX;
+            i32 bestIdx = -1;
+            bool isBestRotated = false;
+
+            // Square rects look the same either way round
+            u32 orientationCount = (allowRotation && rect->w != rect->h) ? 2 : 1;
+
+            for (u32 i = 0; i < list.count; i++) {
+                const FreeRect* f = &list.rects[i];
+
+                for (u32 o = 0; o < orientationCount; o++) {
+                    i32 w = (o == 0) ? rect->w : rect->h;
+                    i32 h = (o == 0) ? rect->h : rect->w;
+                    if (f->w < w || f->h < h) continue;
+
+                    i64 leftoverW = f->w - w;
+                    i64 leftoverH = f->h - h;
+                    i64 shortSide = (leftoverW < leftoverH) ? leftoverW : leftoverH;
+                    i64 longSide = (leftoverW < leftoverH) ? leftoverH : leftoverW;
+
+                    i64 primary = shortSide;
+                    i64 secondary = longSide;
+                    if (heuristic == Heuristic::BEST_AREA) {
+                        primary = (i64)f->w * f->h - (i64)w * h;
+                        secondary = shortSide;
+                    }
+
+                    if (primary < bestPrimary || (primary == bestPrimary && secondary < bestSecondary)) {
+                        bestPrimary = primary;
+                        bestSecondary = secondary;
+                        bestIdx = (i32)i;
+                        isBestRotated = (o == 1);
+                    }
+                }
+            }
+
+            if (bestIdx < 0) {
+                success = false;
+                break;
+            }
+
+            if (isBestRotated) swap_sides(rect);
+
+            FreeRect used = { list.rects[bestIdx].x, list.rects[bestIdx].y, rect->w, rect->h };
+            rect->x = used.x;
+            rect->y = used.y;
+            rect->was_packed = 1;
+
+            maxrects_place(&list, &scratch, &used);
+        }
+
+        if (list.rects) memory::free(list.rects);
+        if (scratch.rects) memory::free(scratch.rects);
+        memory::free(keys);
+        return success;
+    }
+
+    // NOTE: stb_rect_pack has no notion of rotation, lying every rect down flat keeps the skyline low instead.
+    static bool skyline_pack(Vec2i size, bool allowRotation, stbrp_rect* rects, u32 rectCount) {
+        if (allowRotation) {
+            for (u32 i = 0; i < rectCount; i++) {
+                if (rects[i].h > rects[i].w && rects[i].h <= size.w) swap_sides(&rects[i]);
+            }
+        }
+
+        stbrp_context context = {};
+        i32 nodeCount = size.w;
+        stbrp_node* nodes = (stbrp_node*)memory::alloc(sizeof(stbrp_node) * nodeCount);
+
+        stbrp_init_target(&context, size.w, size.h, nodes, nodeCount);
+        bool success = stbrp_pack_rects(&context, rects, (i32)rectCount) == 1;
+
+        memory::free(nodes);
+        return success;
+    }
+
+    // Places rects one at a time in their given order & stops at the first one that doesn't fit, returns how many did
+    static u32 skyline_fill(Vec2i size, bool allowRotation, stbrp_rect* rects, u32 rectCount) {
+        stbrp_context context = {};
+        i32 nodeCount = size.w;
+        stbrp_node* nodes = (stbrp_node*)memory::alloc(sizeof(stbrp_node) * nodeCount);
+        if (!nodes) return 0;
+
+        stbrp_init_target(&context, size.w, size.h, nodes, nodeCount);
+
+        u32 fitCount = 0;
+        while (fitCount < rectCount) {
+            stbrp_rect* rect = &rects[fitCount];
+            if (allowRotation && rect->h > rect->w && rect->h <= size.w) swap_sides(rect);
+
+            stbrp_pack_rects(&context, rect, 1);
+            if (!rect->was_packed) break;
+            fitCount++;
+        }
+
+        memory::free(nodes);
+        return fitCount;
+    }
+
+    // Finds the lowest height that fits at a fixed width
+    // NOTE: Packing isn't strictly monotonic in height, so the result is only ever a height that was actually packed.
+    static void search_height(void* data, u32 index) {
+        SearchJob* job = &((SearchJob*)data)[index];
+        Vec2i size = { job->width, job->maxHeight };
+
+        memory::copy(job->rects, job->input, sizeof(stbrp_rect) * job->rectCount);
+        if (!rects(job->heuristic, size, job->allowRotation, job->rects, job->rectCount)) {
+            job->height = 0;
+            return;
+        }
+
+        i32 low = job->minHeight;
+        i32 high = job->maxHeight;
+        while (low < high) {
+            i32 mid = (low + high) / 2 / SIZE_STEP * SIZE_STEP;
+            if (mid < low) mid = low;
+
+            size.h = mid;
+            memory::copy(job->rects, job->input, sizeof(stbrp_rect) * job->rectCount);
+            if (rects(job->heuristic, size, job->allowRotation, job->rects, job->rectCount)) {
+                high = mid;
+            } else {
+                low = mid + SIZE_STEP;
+            }
+        }
+
+        // Re-pack at the winning height, this is what ends up in the atlas
+        size.h = high;
+        memory::copy(job->rects, job->input, sizeof(stbrp_rect) * job->rectCount);
+        if (!rects(job->heuristic, size, job->allowRotation, job->rects, job->rectCount)) {
+            size.h = job->maxHeight;
+            memory::copy(job->rects, job->input, sizeof(stbrp_rect) * job->rectCount);
+            rects(job->heuristic, size, job->allowRotation, job->rects, job->rectCount);
+        }
+
+        job->height = size.h;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool rects(Heuristic heuristic, Vec2i size, bool allowRotation, stbrp_rect* rects, u32 rectCount) {
+        for (u32 i = 0; i < rectCount; i++) {
+            rects[i].was_packed = 0;
+        }
+
+        switch (heuristic) {
+            using enum Heuristic;
+            case SKYLINE:         return skyline_pack(size, allowRotation, rects, rectCount);
+            case BEST_SHORT_SIDE: return maxrects_pack(heuristic, size, allowRotation, rects, rectCount);
+            case BEST_AREA:       return maxrects_pack(heuristic, size, allowRotation, rects, rectCount);
+            default:              return false;
+        }
+    }
+
+    bool find_best(stbrp_rect* rects, u32 rectCount, Vec2i minSize, Vec2i maxSize, bool allowRotation, thread::Pool* pool, Result* outResult) {
+        u64 usedArea = 0;
+        i32 widestRect = 0;
+        i32 tallestRect = 0;
+
+        for (u32 i = 0; i < rectCount; i++) {
+            i32 w = rects[i].w;
+            i32 h = rects[i].h;
+
+            // Rotatable rects only ever demand their shorter side in either direction
+            if (allowRotation) {
+                w = (w < h) ? w : h;
+                h = w;
+            }
+
+            usedArea += (u64)rects[i].w * rects[i].h;
+            if (w > widestRect) widestRect = w;
+            if (h > tallestRect) tallestRect = h;
+        }
+
+        if (widestRect > maxSize.w || tallestRect > maxSize.h || usedArea > (u64)maxSize.w * maxSize.h) return false;
+
+        // One job per heuristic & width, widths spread around a square of the total area
+        const u32 factorCount = sizeof(WIDTH_FACTORS) / sizeof(WIDTH_FACTORS[0]);
+        const u32 heuristicCount = get_heuristic_count(rectCount);
+
+        SearchJob* jobs = (SearchJob*)memory::alloc(sizeof(SearchJob) * factorCount * heuristicCount);
+        u32 jobCount = 0;
+
+        i32 minWidth = align_up((widestRect > minSize.w) ? widestRect : minSize.w);
+        f64 squareSide = sqrt((f64)usedArea);
+
+        for (u32 f = 0; f < factorCount; f++) {
+            i32 width = align_up((i32)ceil(squareSide * WIDTH_FACTORS[f]));
+            if (width < minWidth) width = minWidth;
+            if (width > maxSize.w) width = maxSize.w / SIZE_STEP * SIZE_STEP;
+
+            // Skip widths another factor already covers
+            bool isDuplicate = false;
+            for (u32 j = 0; j < jobCount; j += heuristicCount) {
+                if (jobs[j].width == width) isDuplicate = true;
+            }
+            if (isDuplicate) continue;
+
+            i32 minHeight = align_up((i32)((usedArea + width - 1) / width));
+            if (minHeight < tallestRect) minHeight = align_up(tallestRect);
+            if (minHeight < minSize.h) minHeight = align_up(minSize.h);
+            if (minHeight > maxSize.h) continue;
+
+            for (u32 h = 0; h < heuristicCount; h++) {
+                SearchJob* job = &jobs[jobCount++];
+                job->input = rects;
+                job->rectCount = rectCount;
+                job->heuristic = (Heuristic)h;
+                job->allowRotation = allowRotation;
+                job->width = width;
+                job->minHeight = minHeight;
+                job->maxHeight = maxSize.h / SIZE_STEP * SIZE_STEP;
+                job->rects = (stbrp_rect*)memory::alloc(sizeof(stbrp_rect) * (rectCount > 0 ? rectCount : 1));
+                job->height = 0;
+            }
+        }
+
+        thread::pool_dispatch(pool, jobCount, search_height, jobs);
+
+        // Smallest area wins, then the squarer one, then the earlier heuristic so the pick never depends on timing
+        i32 bestIdx = -1;
+        for (u32 i = 0; i < jobCount; i++) {
+            const SearchJob* job = &jobs[i];
+            if (job->height == 0) continue;
+
+            if (bestIdx < 0) {
+                bestIdx = (i32)i;
+                continue;
+            }
+
+            const SearchJob* best = &jobs[bestIdx];
+            i64 area = (i64)job->width * job->height;
+            i64 bestArea = (i64)best->width * best->height;
+            i32 longSide = (job->width > job->height) ? job->width : job->height;
+            i32 bestLongSide = (best->width > best->height) ? best->width : best->height;
+
+            if (area < bestArea || (area == bestArea && longSide < bestLongSide)) bestIdx = (i32)i;
+        }
+
+        bool success = bestIdx >= 0;
+        if (success) {
+            const SearchJob* best = &jobs[bestIdx];
+            memory::copy(rects, best->rects, sizeof(stbrp_rect) * rectCount);
+
+            outResult->size = { best->width, best->height };
+            outResult->heuristic = best->heuristic;
+            outResult->usedArea = usedArea;
+        }
+
+        for (u32 i = 0; i < jobCount; i++) memory::free(jobs[i].rects);
+        memory::free(jobs);
+
+        return success;
+    }
+
+    u32 fill_page(stbrp_rect* rects, u32 rectCount, Vec2i size, bool allowRotation) {
+        // No more rects can fit than their area allows
+        u64 pageArea = (u64)size.w * size.h;
+        u64 usedArea = 0;
+        u32 high = 0;
+
+        while (high < rectCount) {
+            usedArea += (u64)rects[high].w * rects[high].h;
+            if (usedArea > pageArea) break;
+            high++;
+        }
+
+        if (high == 0) return 0;
+
+        // Placing the rects in order fits an exact prefix in a single pass
+        u32 low = skyline_fill(size, allowRotation, rects, high);
+
+        // Sorted by height the skyline usually fits a longer one, each step of the search is one more skyline pass.
+        // NOTE: Packers aren't strictly monotonic, so this finds a long prefix that fits rather than the longest possible one.
+        stbrp_rect* scratch = (stbrp_rect*)memory::alloc(sizeof(stbrp_rect) * high);
+        while (scratch && low < high) {
+            u32 mid = low + (high - low + 1) / 2;
+
+            memory::copy(scratch, rects, sizeof(stbrp_rect) * mid);
+            if (skyline_pack(size, allowRotation, scratch, mid)) {
+                memory::copy(rects, scratch, sizeof(stbrp_rect) * mid);
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+
+        if (scratch) memory::free(scratch);
+        return low;
+    }
+
+    const char* get_heuristic_name(Heuristic heuristic) {
+        switch (heuristic) {
+            using enum Heuristic;
+            case SKYLINE:         return "skyline";
+            case BEST_SHORT_SIDE: return "maxrects-bssf";
+            case BEST_AREA:       return "maxrects-baf";
+            default:              return "unknown";
+        }
+    }
+}
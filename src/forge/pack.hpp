@@ -0,0 +1,44 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "GEM/core/thread.hpp"
+#include "GEM/math/vector.hpp"
+
+// -------------------------------------------
+// Rectangle Packing
+// -------------------------------------------
+// Results are written back into the 'stbrp_rect' array (x, y & was_packed) regardless of the heuristic used.
+// With rotation allowed, rects placed at 90 degrees come back with their width & height swapped.
+
+namespace pack {
+    const i32 SIZE_STEP = 4; // Atlas dimensions stay a multiple of this, block compression works on 4x4 texels
+
+    // MaxRects prunes its whole free list on every placement, past this many rects the searches only try SKYLINE
+    const u32 SEARCH_RECT_LIMIT = 8192;
+
+    enum class Heuristic : u32 {
+        SKYLINE = 0,     // stb_rect_pack, bottom-left skyline
+        BEST_SHORT_SIDE, // MaxRects, smallest leftover on the shorter side
+        BEST_AREA,       // MaxRects, smallest leftover area
+        COUNT,
+    };
+
+    struct Result {
+        Vec2i size;
+        Heuristic heuristic;
+        u64 usedArea;
+    };
+
+    bool rects(Heuristic heuristic, Vec2i size, bool allowRotation, stbrp_rect* rects, u32 rectCount);
+
+    // Searches for the smallest atlas that fits every rect, trying each heuristic across a few aspect ratios on the pool
+    bool find_best(stbrp_rect* rects, u32 rectCount, Vec2i minSize, Vec2i maxSize, bool allowRotation, thread::Pool* pool, Result* outResult);
+
+    // Packs as many of the leading rects as fit into a page of 'size' & returns how many that are, e.g. to spread rects over several pages.
+    // Only SKYLINE is used, which keeps filling pages cheap at any rect count.
+    // The layout of any shorter prefix stays valid on its own, so a page may also end earlier.
+    u32 fill_page(stbrp_rect* rects, u32 rectCount, Vec2i size, bool allowRotation);
+
+    const char* get_heuristic_name(Heuristic heuristic);
+}
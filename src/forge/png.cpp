@@ -0,0 +1,875 @@
+#include "pch.hpp"
+
+#include "forge/png.hpp"
+
+#include "GEM/core/filesystem.hpp"
+#include "GEM/core/memory.hpp"
+
+namespace png {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Reference: RFC 1950 (zlib), RFC 1951 (deflate), PNG specification (ISO/IEC 15948)
+    static const u32 BYTES_PER_PIXEL = 4;
+
+    static const u32 WINDOW_SIZE = 32768;
+    static const u32 WINDOW_MASK = WINDOW_SIZE - 1;
+    static const u32 HASH_BITS = 15;
+    static const u32 HASH_SIZE = 1 << HASH_BITS;
+
+    static const u32 MIN_MATCH = 3;
+    static const u32 MAX_MATCH = 258;
+
+    static const u32 BLOCK_TOKEN_COUNT = 1 << 15;
+    static const u32 TOKEN_MATCH_FLAG = 1u << 31;
+
+    // NOTE: Smaller strips compress worse, every strip pays for its own block headers & sync flush
+    static const u64 STRIP_MIN_SIZE = 256 * 1024;
+
+    static const u32 LITERAL_SYMBOL_COUNT = 286;
+    static const u32 DISTANCE_SYMBOL_COUNT = 30;
+    static const u32 CODE_LENGTH_SYMBOL_COUNT = 19;
+    static const u32 END_OF_BLOCK = 256;
+
+    struct LevelParams {
+        u32 maxChainLength;
+        u32 niceLength;
+        u32 filterCount; // Filter types tried per row, in the order NONE, SUB, UP, AVERAGE, PAETH
+        bool isLazy;
+        u8 zlibFlags;    // FLEVEL hint in the zlib header, checksum included
+    };
+
+    static const LevelParams LEVEL_PARAMS[as_index(Level::COUNT)] = {
+        { 4,   32,  3, false, 0x01 },
+        { 32,  128, 5, true,  0x9C },
+        { 512, 258, 5, true,  0xDA },
+    };
+
+    static const u16 LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const u8 LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const u16 DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const u8 DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    static const u8 CODE_LENGTH_ORDER[CODE_LENGTH_SYMBOL_COUNT] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    static INIT_ONCE gTablesOnce = INIT_ONCE_STATIC_INIT;
+    static u8 gLengthSymbol[MAX_MATCH + 1];
+    static u8 gDistanceSymbol[512]; // [0, 255] for distances up to 256, the rest by (distance - 1) >> 7
+    static u32 gCrcTable[256];
+
+    struct Buffer {
+        u8* data;
+        u64 size;
+        u64 capacity;
+    };
+
+    struct BitWriter {
+        Buffer* out;
+        u64 bits;
+        u32 count;
+    };
+
+    struct Huffman {
+        u16 codes[LITERAL_SYMBOL_COUNT];
+        u8 lengths[LITERAL_SYMBOL_COUNT];
+    };
+
+    struct FilterJob {
+        const u8* pixels;
+        u8* filtered;
+        u32 rowSize;
+        u32 filterCount;
+    };
+
+    struct StripJob {
+        const u8* filtered;
+        u64 begin;
+        u64 end;
+        const LevelParams* params;
+        bool isFirst;
+
+        Buffer output; // One complete IDAT chunk
+        u32 adler;
+    };
+
+    struct StripContext {
+        const u8* data;
+        u64 end;
+        u64 windowStart;
+        i64* head;
+        i64* prev;
+    };
+
+    // NOTE: Atlases of different types are encoded at the same time, InitOnceExecuteOnce builds the tables exactly once & makes
+    // every other caller wait until they're done.
+    static BOOL CALLBACK init_tables(PINIT_ONCE initOnce, PVOID parameter, PVOID* context) {
+        for (u32 code = 0; code < 29; code++) {
+            u32 count = (code == 28) ? 1 : (1u << LENGTH_EXTRA[code]);
+            for (u32 i = 0; i < count; i++) {
+                u32 length = LENGTH_BASE[code] + i;
+                if (length <= MAX_MATCH) gLengthSymbol[length] = (u8)code;
+            }
+        }
+        gLengthSymbol[MAX_MATCH] = 28;
+
+        for (u32 code = 0; code < 30; code++) {
+            u32 count = 1u << DISTANCE_EXTRA[code];
+            for (u32 i = 0; i < count; i++) {
+                u32 distance = DISTANCE_BASE[code] + i;
+                if (distance <= 256) {
+                    gDistanceSymbol[distance - 1] = (u8)code;
+                } else {
+                    gDistanceSymbol[256 + ((distance - 1) >> 7)] = (u8)code;
+                }
+            }
+        }
+
+        for (u32 i = 0; i < 256; i++) {
+            u32 crc = i;
+            for (u32 bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+            }
+            gCrcTable[i] = crc;
+        }
+
+        return TRUE;
+    }
+
+    static inline u32 get_distance_symbol(u32 distance) {
+        return (distance <= 256) ? gDistanceSymbol[distance - 1] : gDistanceSymbol[256 + ((distance - 1) >> 7)];
+    }
+
+    // -- Checksums
+    static u32 crc32(u32 crc, const u8* data, u64 size) {
+        crc = ~crc;
+        for (u64 i = 0; i < size; i++) {
+            crc = gCrcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    static const u32 ADLER_BASE = 65521;
+
+    static u32 adler32(const u8* data, u64 size) {
+        u32 a = 1;
+        u32 b = 0;
+
+        // NOTE: 5552 is the largest run that can't overflow 'b' before the modulo
+        while (size > 0) {
+            u32 runSize = (size < 5552) ? (u32)size : 5552;
+            size -= runSize;
+
+            for (u32 i = 0; i < runSize; i++) {
+                a += *data++;
+                b += a;
+            }
+
+            a %= ADLER_BASE;
+            b %= ADLER_BASE;
+        }
+
+        return (b << 16) | a;
+    }
+
+    // Same as zlib's 'adler32_combine', joins the checksums of two consecutive blocks
+    static u32 adler32_combine(u32 adlerA, u32 adlerB, u64 sizeB) {
+        u32 remainder = (u32)(sizeB % ADLER_BASE);
+        u32 sumA = adlerA & 0xFFFF;
+        u32 sumB = (u32)(((u64)remainder * sumA) % ADLER_BASE);
+
+        sumA += (adlerB & 0xFFFF) + ADLER_BASE - 1;
+        sumB += ((adlerA >> 16) & 0xFFFF) + ((adlerB >> 16) & 0xFFFF) + ADLER_BASE - remainder;
+
+        if (sumA >= ADLER_BASE) sumA -= ADLER_BASE;
+        if (sumA >= ADLER_BASE) sumA -= ADLER_BASE;
+        if (sumB >= (ADLER_BASE << 1)) sumB -= (ADLER_BASE << 1);
+        if (sumB >= ADLER_BASE) sumB -= ADLER_BASE;
+
+        return (sumB << 16) | sumA;
+    }
+
+    // -- Buffer
+    static void buffer_reserve(Buffer* b, u64 extraSize) {
+        if (b->size + extraSize <= b->capacity) return;
+
+        u64 newCapacity = b->capacity * 2;
+        if (newCapacity < b->size + extraSize) newCapacity = b->size + extraSize;
+
+        u8* newData = (u8*)memory::alloc(newCapacity);
+        if (b->data) {
+            memory::copy(newData, b->data, b->size);
+            memory::free(b->data);
+        }
+
+        b->data = newData;
+        b->capacity = newCapacity;
+    }
+
+    static void buffer_push(Buffer* b, const void* data, u64 size) {
+        buffer_reserve(b, size);
+        memory::copy(b->data + b->size, data, size);
+        b->size += size;
+    }
+
+    static inline void store_u32_be(u8* dest, u32 value) {
+        dest[0] = (u8)(value >> 24);
+        dest[1] = (u8)(value >> 16);
+        dest[2] = (u8)(value >> 8);
+        dest[3] = (u8)(value);
+    }
+
+    static void buffer_push_u32_be(Buffer* b, u32 value) {
+        buffer_reserve(b, 4);
+        store_u32_be(b->data + b->size, value);
+        b->size += 4;
+    }
+
+    static void buffer_push_chunk(Buffer* b, const char* type, const u8* data, u32 size) {
+        buffer_push_u32_be(b, size);
+
+        u64 typeOffset = b->size;
+        buffer_push(b, type, 4);
+        if (size > 0) buffer_push(b, data, size);
+
+        buffer_push_u32_be(b, crc32(0, b->data + typeOffset, size + 4));
+    }
+
+    // -- Bit Writer
+    // NOTE: The caller reserves enough space up front, see 'deflate_write_block'
+    static inline void bits_put(BitWriter* w, u32 value, u32 count) {
+        w->bits |= (u64)value << w->count;
+        w->count += count;
+
+        if (w->count >= 32) {
+            Buffer* out = w->out;
+            u8* dest = out->data + out->size;
+            dest[0] = (u8)(w->bits);
+            dest[1] = (u8)(w->bits >> 8);
+            dest[2] = (u8)(w->bits >> 16);
+            dest[3] = (u8)(w->bits >> 24);
+            out->size += 4;
+
+            w->bits >>= 32;
+            w->count -= 32;
+        }
+    }
+
+    static void bits_align(BitWriter* w) {
+        buffer_reserve(w->out, 8);
+
+        while (w->count > 0) {
+            w->out->data[w->out->size++] = (u8)w->bits;
+            w->bits >>= 8;
+            w->count = (w->count > 8) ? w->count - 8 : 0;
+        }
+
+        w->bits = 0;
+    }
+
+    // -- Huffman
+    static inline u16 reverse_bits(u32 code, u32 length) {
+        u32 output = 0;
+        for (u32 i = 0; i < length; i++) {
+            output = (output << 1) | (code & 1);
+            code >>= 1;
+        }
+        return (u16)output;
+    }
+
+    // Builds length-limited canonical codes, leaves are folded into the limit the same way miniz does it
+    static void huffman_build(Huffman* h, const u32* freqs, u32 symbolCount, u32 maxLength) {
+        u32 symbols[LITERAL_SYMBOL_COUNT];
+        u32 usedCount = 0;
+
+        for (u32 s = 0; s < symbolCount; s++) {
+            h->lengths[s] = 0;
+            h->codes[s] = 0;
+            if (freqs[s] > 0) symbols[usedCount++] = s;
+        }
+
+        if (usedCount < 2) {
+            // Keep the code complete, a lone symbol still needs a sibling
+            u32 first = (usedCount == 1) ? symbols[0] : 0;
+            h->lengths[first] = 1;
+            h->lengths[first == 0 ? 1 : 0] = 1;
+        } else {
+            // Sort leaves by ascending frequency
+            for (u32 i = 1; i < usedCount; i++) {
+                u32 symbol = symbols[i];
+                u32 j = i;
+                while (j > 0 && freqs[symbols[j - 1]] > freqs[symbol]) {
+                    symbols[j] = symbols[j - 1];
+                    j--;
+                }
+                symbols[j] = symbol;
+            }
+
+            // Two-queue construction, leaves in [0, usedCount) and inner nodes after them
+            u32 nodeFreqs[LITERAL_SYMBOL_COUNT * 2];
+            u16 parents[LITERAL_SYMBOL_COUNT * 2];
+            u8 depths[LITERAL_SYMBOL_COUNT * 2];
+
+            for (u32 i = 0; i < usedCount; i++) nodeFreqs[i] = freqs[symbols[i]];
+
+            u32 leafIdx = 0;
+            u32 innerIdx = usedCount;
+            u32 nodeCount = usedCount;
+            while (nodeCount < usedCount * 2 - 1) {
+                u32 picked[2];
+                for (u32 p = 0; p < 2; p++) {
+                    if (leafIdx < usedCount && (innerIdx >= nodeCount || nodeFreqs[leafIdx] <= nodeFreqs[innerIdx])) {
+                        picked[p] = leafIdx++;
+                    } else {
+                        picked[p] = innerIdx++;
+                    }
+                }
+
+                nodeFreqs[nodeCount] = nodeFreqs[picked[0]] + nodeFreqs[picked[1]];
+                parents[picked[0]] = (u16)nodeCount;
+                parents[picked[1]] = (u16)nodeCount;
+                nodeCount++;
+            }
+
+            // Parents always come after their children, so a reverse walk resolves every depth
+            u32 lengthCounts[33] = {};
+            depths[nodeCount - 1] = 0;
+            for (i32 i = (i32)nodeCount - 2; i >= 0; i--) {
+                u32 depth = depths[parents[i]] + 1;
+                depths[i] = (u8)(depth < 32 ? depth : 32);
+            }
+
+            for (u32 i = 0; i < usedCount; i++) {
+                lengthCounts[depths[i] < maxLength ? depths[i] : maxLength]++;
+            }
+
+            // Fix up the Kraft sum after folding the overlong codes
+            u32 total = 0;
+            for (u32 i = 1; i <= maxLength; i++) total += lengthCounts[i] << (maxLength - i);
+
+            while (total > (1u << maxLength)) {
+                lengthCounts[maxLength]--;
+                for (u32 i = maxLength - 1; i > 0; i--) {
+                    if (lengthCounts[i] > 0) {
+                        lengthCounts[i]--;
+                        lengthCounts[i + 1] += 2;
+                        break;
+                    }
+                }
+                total--;
+            }
+
+            // Least frequent symbols get the longest codes
+            u32 symbolIdx = 0;
+            for (u32 length = maxLength; length > 0; length--) {
+                for (u32 i = 0; i < lengthCounts[length]; i++) {
+                    h->lengths[symbols[symbolIdx++]] = (u8)length;
+                }
+            }
+        }
+
+        // Assign canonical codes, stored bit-reversed since deflate writes them LSB first
+        u32 blCount[16] = {};
+        for (u32 s = 0; s < symbolCount; s++) blCount[h->lengths[s]]++;
+        blCount[0] = 0;
+
+        u32 nextCode[16] = {};
+        u32 code = 0;
+        for (u32 bits = 1; bits < 16; bits++) {
+            code = (code + blCount[bits - 1]) << 1;
+            nextCode[bits] = code;
+        }
+
+        for (u32 s = 0; s < symbolCount; s++) {
+            u32 length = h->lengths[s];
+            if (length > 0) h->codes[s] = reverse_bits(nextCode[length]++, length);
+        }
+    }
+
+    // -- Deflate
+    static void deflate_write_block(BitWriter* w, const u32* tokens, u32 tokenCount) {
+        u32 literalFreqs[LITERAL_SYMBOL_COUNT] = {};
+        u32 distanceFreqs[DISTANCE_SYMBOL_COUNT] = {};
+
+        for (u32 i = 0; i < tokenCount; i++) {
+            u32 token = tokens[i];
+            if (token & TOKEN_MATCH_FLAG) {
+                u32 length = ((token >> 15) & 0xFF) + MIN_MATCH;
+                u32 distance = (token & WINDOW_MASK) + 1;
+                literalFreqs[257 + gLengthSymbol[length]]++;
+                distanceFreqs[get_distance_symbol(distance)]++;
+            } else {
+                literalFreqs[token]++;
+            }
+        }
+        literalFreqs[END_OF_BLOCK] = 1;
+
+        Huffman literals = {};
+        Huffman distances = {};
+        huffman_build(&literals, literalFreqs, LITERAL_SYMBOL_COUNT, 15);
+        huffman_build(&distances, distanceFreqs, DISTANCE_SYMBOL_COUNT, 15);
+
+        u32 literalCount = LITERAL_SYMBOL_COUNT;
+        while (literalCount > 257 && literals.lengths[literalCount - 1] == 0) literalCount--;
+
+        u32 distanceCount = DISTANCE_SYMBOL_COUNT;
+        while (distanceCount > 1 && distances.lengths[distanceCount - 1] == 0) distanceCount--;
+
+        // Run-length encode both length tables as one sequence
+        u8 allLengths[LITERAL_SYMBOL_COUNT + DISTANCE_SYMBOL_COUNT];
+        u32 allCount = literalCount + distanceCount;
+        memory::copy(allLengths, literals.lengths, literalCount);
+        memory::copy(allLengths + literalCount, distances.lengths, distanceCount);
+
+        u8 rleSymbols[LITERAL_SYMBOL_COUNT + DISTANCE_SYMBOL_COUNT];
+        u8 rleExtras[LITERAL_SYMBOL_COUNT + DISTANCE_SYMBOL_COUNT];
+        u32 rleCount = 0;
+        u32 codeLengthFreqs[CODE_LENGTH_SYMBOL_COUNT] = {};
+
+        for (u32 i = 0; i < allCount;) {
+            u8 length = allLengths[i];
+            u32 runLength = 1;
+            while (i + runLength < allCount && allLengths[i + runLength] == length) runLength++;
+            i += runLength;
+
+            if (length == 0) {
+                while (runLength >= 11) {
+                    u32 count = (runLength < 138) ? runLength : 138;
+                    rleSymbols[rleCount] = 18;
+                    rleExtras[rleCount++] = (u8)(count - 11);
+                    runLength -= count;
+                }
+
+                if (runLength >= 3) {
+                    rleSymbols[rleCount] = 17;
+                    rleExtras[rleCount++] = (u8)(runLength - 3);
+                    runLength = 0;
+                }
+            } else {
+                rleSymbols[rleCount] = length;
+                rleExtras[rleCount++] = 0;
+                runLength--;
+
+                while (runLength >= 3) {
+                    u32 count = (runLength < 6) ? runLength : 6;
+                    rleSymbols[rleCount] = 16;
+                    rleExtras[rleCount++] = (u8)(count - 3);
+                    runLength -= count;
+                }
+            }
+
+            while (runLength > 0) {
+                rleSymbols[rleCount] = length;
+                rleExtras[rleCount++] = 0;
+                runLength--;
+            }
+        }
+
+        for (u32 i = 0; i < rleCount; i++) codeLengthFreqs[rleSymbols[i]]++;
+
+        Huffman codeLengths = {};
+        huffman_build(&codeLengths, codeLengthFreqs, CODE_LENGTH_SYMBOL_COUNT, 7);
+
+        u32 codeLengthCount = CODE_LENGTH_SYMBOL_COUNT;
+        while (codeLengthCount > 4 && codeLengths.lengths[CODE_LENGTH_ORDER[codeLengthCount - 1]] == 0) codeLengthCount--;
+
+        // NOTE: A token never takes more than 48 bits, the header stays well under 512 bytes
+        buffer_reserve(w->out, (u64)tokenCount * 6 + 512);
+
+        // Block header, BFINAL = 0 & BTYPE = 2 (dynamic)
+        bits_put(w, 2 << 1, 3);
+        bits_put(w, literalCount - 257, 5);
+        bits_put(w, distanceCount - 1, 5);
+        bits_put(w, codeLengthCount - 4, 4);
+
+        for (u32 i = 0; i < codeLengthCount; i++) {
+            bits_put(w, codeLengths.lengths[CODE_LENGTH_ORDER[i]], 3);
+        }
+
+        for (u32 i = 0; i < rleCount; i++) {
+            u32 symbol = rleSymbols[i];
+            bits_put(w, codeLengths.codes[symbol], codeLengths.lengths[symbol]);
+
+            switch (symbol) {
+                case 16: bits_put(w, rleExtras[i], 2); break;
+                case 17: bits_put(w, rleExtras[i], 3); break;
+                case 18: bits_put(w, rleExtras[i], 7); break;
+                default: break;
+            }
+        }
+
+        // Block data
+        for (u32 i = 0; i < tokenCount; i++) {
+            u32 token = tokens[i];
+            if (token & TOKEN_MATCH_FLAG) {
+                u32 length = ((token >> 15) & 0xFF) + MIN_MATCH;
+                u32 distance = (token & WINDOW_MASK) + 1;
+
+                u32 lengthSymbol = gLengthSymbol[length];
+                bits_put(w, literals.codes[257 + lengthSymbol], literals.lengths[257 + lengthSymbol]);
+                bits_put(w, length - LENGTH_BASE[lengthSymbol], LENGTH_EXTRA[lengthSymbol]);
+
+                u32 distanceSymbol = get_distance_symbol(distance);
+                bits_put(w, distances.codes[distanceSymbol], distances.lengths[distanceSymbol]);
+                bits_put(w, distance - DISTANCE_BASE[distanceSymbol], DISTANCE_EXTRA[distanceSymbol]);
+            } else {
+                bits_put(w, literals.codes[token], literals.lengths[token]);
+            }
+        }
+
+        bits_put(w, literals.codes[END_OF_BLOCK], literals.lengths[END_OF_BLOCK]);
+    }
+
+    static inline u32 hash3(const u8* ptr) {
+        u32 value = (u32)ptr[0] | ((u32)ptr[1] << 8) | ((u32)ptr[2] << 16);
+        return (value * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    static inline void strip_insert(StripContext* ctx, u64 pos) {
+        u32 h = hash3(ctx->data + pos);
+        ctx->prev[pos & WINDOW_MASK] = ctx->head[h];
+        ctx->head[h] = (i64)pos;
+    }
+
+    static inline u32 match_length(const u8* a, const u8* b, u32 maxLength) {
+        u32 length = 0;
+        while (length + 8 <= maxLength) {
+            u64 wordA, wordB;
+            memcpy(&wordA, a + length, sizeof(u64));
+            memcpy(&wordB, b + length, sizeof(u64));
+            if (wordA != wordB) break;
+            length += 8;
+        }
+
+        while (length < maxLength && a[length] == b[length]) length++;
+        return length;
+    }
+
+    // Returns a match longer than 'minLength', or 0 if the chain had nothing better
+    static u32 strip_find_match(StripContext* ctx, u64 pos, u32 minLength, u32 maxChainLength, u32 niceLength, u32* outDistance) {
+        u64 available = ctx->end - pos;
+        u32 maxLength = (available < MAX_MATCH) ? (u32)available : MAX_MATCH;
+        if (maxLength < MIN_MATCH) return 0;
+        if (niceLength > maxLength) niceLength = maxLength;
+
+        u32 bestLength = (minLength < MIN_MATCH - 1) ? MIN_MATCH - 1 : minLength;
+        if (bestLength >= maxLength) return 0;
+
+        const u8* current = ctx->data + pos;
+        i64 candidate = ctx->head[hash3(current)];
+        u32 chainLength = maxChainLength;
+
+        while (candidate >= (i64)ctx->windowStart && pos - (u64)candidate <= WINDOW_SIZE && chainLength-- > 0) {
+            const u8* previous = ctx->data + candidate;
+
+            // Cheap rejection first, the byte at 'bestLength' has to match for the candidate to win
+            if (previous[bestLength] == current[bestLength] && previous[0] == current[0] && previous[1] == current[1]) {
+                u32 length = match_length(previous, current, maxLength);
+                if (length > bestLength) {
+                    bestLength = length;
+                    *outDistance = (u32)(pos - (u64)candidate);
+                    if (length >= niceLength) break;
+                }
+            }
+
+            candidate = ctx->prev[candidate & WINDOW_MASK];
+        }
+
+        return (bestLength > minLength && bestLength >= MIN_MATCH) ? bestLength : 0;
+    }
+
+    static void deflate_strip(void* data, u32 index) {
+        StripJob* job = &((StripJob*)data)[index];
+        const LevelParams* params = job->params;
+        const u8* input = job->filtered;
+
+        StripContext ctx = {};
+        ctx.data = input;
+        ctx.end = job->end;
+        ctx.windowStart = (job->begin > WINDOW_SIZE) ? job->begin - WINDOW_SIZE : 0;
+        ctx.head = (i64*)memory::alloc(sizeof(i64) * HASH_SIZE);
+        ctx.prev = (i64*)memory::alloc(sizeof(i64) * WINDOW_SIZE);
+        memory::set(ctx.head, sizeof(i64) * HASH_SIZE, 0xFF);
+
+        u32* tokens = (u32*)memory::alloc(sizeof(u32) * BLOCK_TOKEN_COUNT);
+        u32 tokenCount = 0;
+
+        Buffer* out = &job->output;
+        buffer_reserve(out, (job->end - job->begin) / 4 + 1024);
+
+        // Chunk length is patched in once the strip is done
+        buffer_push_u32_be(out, 0);
+        buffer_push(out, "IDAT", 4);
+        if (job->isFirst) {
+            u8 zlibHeader[2] = { 0x78, params->zlibFlags };
+            buffer_push(out, zlibHeader, sizeof(zlibHeader));
+        }
+
+        BitWriter w = {};
+        w.out = out;
+
+        // Prime the window with the tail of the previous strip, the decoder sees all strips as one stream
+        for (u64 pos = ctx.windowStart; pos < job->begin && pos + MIN_MATCH <= job->end; pos++) {
+            strip_insert(&ctx, pos);
+        }
+
+        u64 pos = job->begin;
+        u32 prevLength = 0;
+        u32 prevDistance = 0;
+        bool hasPrevLiteral = false;
+
+        while (pos < job->end) {
+            if (tokenCount >= BLOCK_TOKEN_COUNT - 2) {
+                deflate_write_block(&w, tokens, tokenCount);
+                tokenCount = 0;
+            }
+
+            u32 length = 0;
+            u32 distance = 0;
+            bool canMatch = pos + MIN_MATCH <= job->end;
+
+            if (!params->isLazy) {
+                // Greedy parsing
+                if (canMatch) {
+                    length = strip_find_match(&ctx, pos, 0, params->maxChainLength, params->niceLength, &distance);
+                    strip_insert(&ctx, pos);
+                }
+
+                if (length >= MIN_MATCH) {
+                    tokens[tokenCount++] = TOKEN_MATCH_FLAG | ((length - MIN_MATCH) << 15) | (distance - 1);
+
+                    u64 matchEnd = pos + length;
+                    for (u64 p = pos + 1; p < matchEnd && p + MIN_MATCH <= job->end; p++) strip_insert(&ctx, p);
+                    pos = matchEnd;
+                } else {
+                    tokens[tokenCount++] = input[pos];
+                    pos++;
+                }
+
+                continue;
+            }
+
+            // Lazy parsing, a match is only taken once the next position can't beat it
+            if (canMatch) {
+                if (prevLength < params->niceLength) {
+                    length = strip_find_match(&ctx, pos, prevLength, params->maxChainLength, params->niceLength, &distance);
+                }
+                strip_insert(&ctx, pos);
+            }
+
+            if (prevLength >= MIN_MATCH && length == 0) {
+                tokens[tokenCount++] = TOKEN_MATCH_FLAG | ((prevLength - MIN_MATCH) << 15) | (prevDistance - 1);
+
+                u64 matchEnd = pos - 1 + prevLength;
+                for (u64 p = pos + 1; p < matchEnd && p + MIN_MATCH <= job->end; p++) strip_insert(&ctx, p);
+
+                pos = matchEnd;
+                prevLength = 0;
+                hasPrevLiteral = false;
+                continue;
+            }
+
+            if (hasPrevLiteral) tokens[tokenCount++] = input[pos - 1];
+
+            hasPrevLiteral = true;
+            prevLength = length;
+            prevDistance = distance;
+            pos++;
+        }
+
+        if (hasPrevLiteral) tokens[tokenCount++] = input[pos - 1];
+        if (tokenCount > 0) deflate_write_block(&w, tokens, tokenCount);
+
+        // Sync flush, an empty stored block puts the strip end on a byte boundary
+        buffer_reserve(out, 16);
+        bits_put(&w, 0, 3);
+        bits_align(&w);
+        u8 syncMarker[4] = { 0x00, 0x00, 0xFF, 0xFF };
+        buffer_push(out, syncMarker, sizeof(syncMarker));
+
+        u32 chunkSize = (u32)(out->size - 8);
+        store_u32_be(out->data, chunkSize);
+        buffer_push_u32_be(out, crc32(0, out->data + 4, chunkSize + 4));
+
+        job->adler = adler32(input + job->begin, job->end - job->begin);
+
+        memory::free(tokens);
+        memory::free(ctx.prev);
+        memory::free(ctx.head);
+    }
+
+    // -- Filtering
+    static inline u8 paeth(u8 a, u8 b, u8 c) {
+        i32 p = (i32)a + b - c;
+        i32 pa = abs(p - a);
+        i32 pb = abs(p - b);
+        i32 pc = abs(p - c);
+        if (pa <= pb && pa <= pc) return a;
+        if (pb <= pc) return b;
+        return c;
+    }
+
+    static void filter_apply(u32 type, const u8* row, const u8* up, u32 rowSize, u8* dest) {
+        switch (type) {
+            case 0:
+                memory::copy(dest, row, rowSize);
+                break;
+            case 1:
+                for (u32 i = 0; i < BYTES_PER_PIXEL; i++) dest[i] = row[i];
+                for (u32 i = BYTES_PER_PIXEL; i < rowSize; i++) dest[i] = row[i] - row[i - BYTES_PER_PIXEL];
+                break;
+            case 2:
+                for (u32 i = 0; i < rowSize; i++) dest[i] = row[i] - up[i];
+                break;
+            case 3:
+                for (u32 i = 0; i < BYTES_PER_PIXEL; i++) dest[i] = row[i] - (up[i] >> 1);
+                for (u32 i = BYTES_PER_PIXEL; i < rowSize; i++) dest[i] = row[i] - (u8)(((u32)row[i - BYTES_PER_PIXEL] + up[i]) >> 1);
+                break;
+            case 4:
+                for (u32 i = 0; i < BYTES_PER_PIXEL; i++) dest[i] = row[i] - up[i];
+                for (u32 i = BYTES_PER_PIXEL; i < rowSize; i++) dest[i] = row[i] - paeth(row[i - BYTES_PER_PIXEL], up[i], up[i - BYTES_PER_PIXEL]);
+                break;
+        }
+    }
+
+    // Picks the filter with the smallest sum of absolute values, same heuristic as libpng & stb
+    static void filter_row(void* data, u32 y) {
+        FilterJob* job = (FilterJob*)data;
+        const u8* row = job->pixels + (u64)y * job->rowSize;
+        u8* dest = job->filtered + (u64)y * (job->rowSize + 1);
+
+        // NOTE: The first row has nothing above it, only NONE & SUB are tried there
+        const u8* up = (y > 0) ? row - job->rowSize : NULL;
+
+        u32 bestType = 0;
+        u64 bestCost = ~0ULL;
+        u32 lastType = 0;
+
+        for (u32 type = 0; type < job->filterCount; type++) {
+            if (!up && type >= 2) break;
+
+            filter_apply(type, row, up, job->rowSize, dest + 1);
+            lastType = type;
+
+            u64 cost = 0;
+            for (u32 i = 0; i < job->rowSize; i++) cost += (u32)abs((i8)dest[1 + i]);
+
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestType = type;
+            }
+        }
+
+        if (bestType != lastType) filter_apply(bestType, row, up, job->rowSize, dest + 1);
+        dest[0] = (u8)bestType;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    u8* encode(const u8* pixels, i32 width, i32 height, Level level, thread::Pool* pool, u64* outSize) {
+        *outSize = 0;
+        if (width <= 0 || height <= 0 || as_index(level) >= as_index(Level::COUNT)) return NULL;
+
+        InitOnceExecuteOnce(&gTablesOnce, init_tables, NULL, NULL);
+        const LevelParams* params = &LEVEL_PARAMS[as_index(level)];
+
+        u32 rowSize = (u32)width * BYTES_PER_PIXEL;
+        u64 filteredSize = (u64)(rowSize + 1) * height;
+        u8* filtered = (u8*)memory::alloc(filteredSize);
+
+        // Filter every row, rows only ever read the unfiltered row above them
+        FilterJob filterJob = { pixels, filtered, rowSize, params->filterCount };
+        thread::pool_dispatch(pool, (u32)height, filter_row, &filterJob);
+
+        // Split into strips on row boundaries
+        u32 maxStripCount = (pool->workerCount + 1) * 4;
+        u64 stripCountBySize = filteredSize / STRIP_MIN_SIZE;
+        u32 stripCount = (stripCountBySize < maxStripCount) ? (u32)stripCountBySize : maxStripCount;
+        if (stripCount < 1) stripCount = 1;
+
+        u32 rowsPerStrip = ((u32)height + stripCount - 1) / stripCount;
+        stripCount = ((u32)height + rowsPerStrip - 1) / rowsPerStrip;
+
+        StripJob* strips = (StripJob*)memory::alloc(sizeof(StripJob) * stripCount);
+        memory::zero(strips, sizeof(StripJob) * stripCount);
+
+        for (u32 i = 0; i < stripCount; i++) {
+            u32 firstRow = i * rowsPerStrip;
+            u32 lastRow = (firstRow + rowsPerStrip < (u32)height) ? firstRow + rowsPerStrip : (u32)height;
+
+            strips[i].filtered = filtered;
+            strips[i].begin = (u64)firstRow * (rowSize + 1);
+            strips[i].end = (u64)lastRow * (rowSize + 1);
+            strips[i].params = params;
+            strips[i].isFirst = (i == 0);
+        }
+
+        thread::pool_dispatch(pool, stripCount, deflate_strip, strips);
+
+        // Join everything into the final file
+        u64 totalSize = 64;
+        for (u32 i = 0; i < stripCount; i++) totalSize += strips[i].output.size;
+
+        Buffer output = {};
+        buffer_reserve(&output, totalSize);
+
+        const u8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        buffer_push(&output, signature, sizeof(signature));
+
+        u8 header[13] = {};
+        store_u32_be(header + 0, (u32)width);
+        store_u32_be(header + 4, (u32)height);
+        header[8] = 8; // Bit depth
+        header[9] = 6; // Color type, RGBA
+        buffer_push_chunk(&output, "IHDR", header, sizeof(header));
+
+        u32 adler = 1;
+        for (u32 i = 0; i < stripCount; i++) {
+            StripJob* strip = &strips[i];
+            buffer_push(&output, strip->output.data, strip->output.size);
+            adler = adler32_combine(adler, strip->adler, strip->end - strip->begin);
+
+            memory::free(strip->output.data);
+        }
+
+        // Closing block (empty, fixed codes) followed by the stream checksum
+        u8 trailer[6] = { 0x03, 0x00 };
+        store_u32_be(trailer + 2, adler);
+        buffer_push_chunk(&output, "IDAT", trailer, sizeof(trailer));
+        buffer_push_chunk(&output, "IEND", NULL, 0);
+
+        memory::free(strips);
+        memory::free(filtered);
+
+        *outSize = output.size;
+        return output.data;
+    }
+
+    bool write(const char* path, const u8* pixels, i32 width, i32 height, Level level, thread::Pool* pool) {
+        u64 size = 0;
+        u8* data = encode(pixels, width, height, level, pool, &size);
+        if (!data) return false;
+
+        file::File f = file::open(path, file::Mode::WRITE, true);
+        bool success = file::write(&f, data, (i32)size);
+        file::close(&f);
+
+        memory::free(data);
+        return success;
+    }
+
+    bool parse_level(const char* name, Level* outLevel) {
+        if (strcmp(name, "fast") == 0) {
+            *outLevel = Level::FAST;
+        } else if (strcmp(name, "default") == 0) {
+            *outLevel = Level::DEFAULT;
+        } else if (strcmp(name, "small") == 0) {
+            *outLevel = Level::SMALL;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+}
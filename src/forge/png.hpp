@@ -0,0 +1,27 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "GEM/core/thread.hpp"
+
+// -------------------------------------------
+// PNG Encoding
+// -------------------------------------------
+// Writes 8-bit RGBA images only, which is all forge ever outputs.
+// The filtered image is deflated in horizontal strips across the pool, each strip ends on a sync flush
+// and primes its window with the tail of the previous one, so the strips join into a single zlib stream.
+
+namespace png {
+    enum class Level : u32 {
+        FAST = 0, // Short match chains, greedy parsing, fewer filters tried. Meant for dev iteration
+        DEFAULT,
+        SMALL,    // Long match chains, lazy parsing. Meant for release packaging
+        COUNT,
+    };
+
+    // Returns the encoded file in a single block, which must be released with 'memory::free'
+    u8*  encode(const u8* pixels, i32 width, i32 height, Level level, thread::Pool* pool, u64* outSize);
+    bool write(const char* path, const u8* pixels, i32 width, i32 height, Level level, thread::Pool* pool);
+
+    bool parse_level(const char* name, Level* outLevel);
+}
@@ -0,0 +1,208 @@
+#include "pch.hpp"
+
+#include "forge/qoi.hpp"
+
+#include "GEM/core/memory.hpp"
+
+namespace qoi {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    static const u8 OP_INDEX = 0x00; // 00xxxxxx
+    static const u8 OP_DIFF  = 0x40; // 01xxxxxx
+    static const u8 OP_LUMA  = 0x80; // 10xxxxxx
+    static const u8 OP_RUN   = 0xC0; // 11xxxxxx
+    static const u8 OP_RGB   = 0xFE;
+    static const u8 OP_RGBA  = 0xFF;
+    static const u8 MASK_2   = 0xC0;
+
+    static const u32 MAGIC = ('q' << 24) | ('o' << 16) | ('i' << 8) | 'f';
+    static const u32 MAX_RUN = 62;
+    static const u8 END_MARKER[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+    // Guards against headers that would overflow the size math
+    static const u32 MAX_PIXEL_COUNT = 400000000;
+
+    union Pixel {
+        struct { u8 r, g, b, a; };
+        u32 value;
+    };
+
+    static inline u32 get_index(Pixel px) {
+        return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+    }
+
+    static inline void write_u32(u8* dest, u32 value) {
+        dest[0] = (u8)(value >> 24);
+        dest[1] = (u8)(value >> 16);
+        dest[2] = (u8)(value >> 8);
+        dest[3] = (u8)value;
+    }
+
+    static inline u32 read_u32(const u8* src) {
+        return ((u32)src[0] << 24) | ((u32)src[1] << 16) | ((u32)src[2] << 8) | (u32)src[3];
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    u8* encode(const u8* pixels, i32 width, i32 height, i32 channels, u64* outSize) {
+        if (width <= 0 || height <= 0 || (u64)width * height > MAX_PIXEL_COUNT) return NULL;
+
+        // Every pixel costs at most an RGBA op (5 bytes)
+        u64 pixelCount = (u64)width * height;
+        u64 capacity = HEADER_SIZE + pixelCount * 5 + sizeof(END_MARKER);
+        u8* data = (u8*)memory::alloc(capacity);
+        if (!data) return NULL;
+
+        write_u32(data, MAGIC);
+        write_u32(data + 4, (u32)width);
+        write_u32(data + 8, (u32)height);
+        data[12] = (channels == 3) ? 3 : 4;
+        data[13] = 0; // sRGB with linear alpha
+
+        u8* cursor = data + HEADER_SIZE;
+        Pixel index[64] = {};
+        Pixel prev = {};
+        prev.a = 255;
+        u32 run = 0;
+
+        for (u64 i = 0; i < pixelCount; i++) {
+            Pixel px;
+            memcpy(&px, pixels + i * 4, sizeof(Pixel));
+
+            if (px.value == prev.value) {
+                run++;
+                if (run == MAX_RUN || i + 1 == pixelCount) {
+                    *cursor++ = OP_RUN | (u8)(run - 1);
+                    run = 0;
+                }
+
+                continue;
+            }
+
+            if (run > 0) {
+                *cursor++ = OP_RUN | (u8)(run - 1);
+                run = 0;
+            }
+
+            u32 slot = get_index(px);
+            if (index[slot].value == px.value) {
+                *cursor++ = OP_INDEX | (u8)slot;
+            } else {
+                index[slot] = px;
+
+                if (px.a == prev.a) {
+                    i8 dr = (i8)(px.r - prev.r);
+                    i8 dg = (i8)(px.g - prev.g);
+                    i8 db = (i8)(px.b - prev.b);
+                    i8 drg = (i8)(dr - dg);
+                    i8 dbg = (i8)(db - dg);
+
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        *cursor++ = OP_DIFF | (u8)((dr + 2) << 4) | (u8)((dg + 2) << 2) | (u8)(db + 2);
+                    } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                        *cursor++ = OP_LUMA | (u8)(dg + 32);
+                        *cursor++ = (u8)((drg + 8) << 4) | (u8)(dbg + 8);
+                    } else {
+                        *cursor++ = OP_RGB;
+                        *cursor++ = px.r;
+                        *cursor++ = px.g;
+                        *cursor++ = px.b;
+                    }
+                } else {
+                    *cursor++ = OP_RGBA;
+                    *cursor++ = px.r;
+                    *cursor++ = px.g;
+                    *cursor++ = px.b;
+                    *cursor++ = px.a;
+                }
+            }
+
+            prev = px;
+        }
+
+        memcpy(cursor, END_MARKER, sizeof(END_MARKER));
+        cursor += sizeof(END_MARKER);
+
+        *outSize = (u64)(cursor - data);
+        return data;
+    }
+
+    bool get_info(const u8* data, u64 size, i32* outWidth, i32* outHeight, i32* outChannels) {
+        if (size < HEADER_SIZE + sizeof(END_MARKER) || read_u32(data) != MAGIC) return false;
+
+        u32 width = read_u32(data + 4);
+        u32 height = read_u32(data + 8);
+        if (width == 0 || height == 0 || (u64)width * height > MAX_PIXEL_COUNT) return false;
+
+        *outWidth = (i32)width;
+        *outHeight = (i32)height;
+        *outChannels = data[12];
+        return true;
+    }
+
+    bool decode(const u8* data, u64 size, u8* outPixels) {
+        i32 width = 0, height = 0, channels = 0;
+        if (!get_info(data, size, &width, &height, &channels)) return false;
+
+        const u8* cursor = data + HEADER_SIZE;
+        const u8* end = data + size - sizeof(END_MARKER);
+
+        u64 pixelCount = (u64)width * height;
+        Pixel index[64] = {};
+        Pixel px = {};
+        px.a = 255;
+
+        for (u64 i = 0; i < pixelCount;) {
+            if (cursor >= end) return false;
+            u8 op = *cursor++;
+
+            if (op == OP_RGB) {
+                if (end - cursor < 3) return false;
+                px.r = cursor[0];
+                px.g = cursor[1];
+                px.b = cursor[2];
+                cursor += 3;
+            } else if (op == OP_RGBA) {
+                if (end - cursor < 4) return false;
+                px.r = cursor[0];
+                px.g = cursor[1];
+                px.b = cursor[2];
+                px.a = cursor[3];
+                cursor += 4;
+            } else if ((op & MASK_2) == OP_INDEX) {
+                px = index[op];
+            } else if ((op & MASK_2) == OP_DIFF) {
+                px.r += ((op >> 4) & 0x03) - 2;
+                px.g += ((op >> 2) & 0x03) - 2;
+                px.b += (op & 0x03) - 2;
+            } else if ((op & MASK_2) == OP_LUMA) {
+                if (cursor >= end) return false;
+                u8 next = *cursor++;
+                i32 dg = (op & 0x3F) - 32;
+                px.r += dg - 8 + ((next >> 4) & 0x0F);
+                px.g += dg;
+                px.b += dg - 8 + (next & 0x0F);
+            } else {
+                // Runs repeat the previous pixel without touching the index
+                u32 run = (op & 0x3F) + 1;
+                if (run > pixelCount - i) return false;
+
+                for (u32 r = 0; r < run; r++, i++) {
+                    memcpy(outPixels + i * 4, &px, sizeof(Pixel));
+                }
+
+                continue;
+            }
+
+            index[get_index(px)] = px;
+            memcpy(outPixels + i * 4, &px, sizeof(Pixel));
+            i++;
+        }
+
+        return true;
+    }
+}
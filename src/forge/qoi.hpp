@@ -0,0 +1,22 @@
+#pragma once
+
+#include "pch.hpp"
+
+// -------------------------------------------
+// QOI Encoding
+// -------------------------------------------
+// The "Quite OK Image" format for 8-bit RGBA, see https://qoiformat.org/qoi-specification.pdf.
+// Decodes several times faster than PNG at a similar size for sprites, which makes it a cheap on-disk cache format.
+
+namespace qoi {
+    const u32 HEADER_SIZE = 14;
+
+    // Returns the encoded file in a single block, which must be released with 'memory::free'
+    // NOTE: 'channels' is only stored in the header, the pixels are always 4 bytes each.
+    u8*  encode(const u8* pixels, i32 width, i32 height, i32 channels, u64* outSize);
+
+    bool get_info(const u8* data, u64 size, i32* outWidth, i32* outHeight, i32* outChannels);
+
+    // Destination must hold width * height * 4 bytes
+    bool decode(const u8* data, u64 size, u8* outPixels);
+}
@@ -0,0 +1,258 @@
+#include "pch.hpp"
+
+#include "forge/scan.hpp"
+
+#include "GEM/core/filesystem.hpp"
+#include "GEM/core/memory.hpp"
+
+namespace scan {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    static const u32 INITIAL_FILE_CAPACITY = 64;
+    static const u64 INITIAL_NAME_CAPACITY = 4096;
+
+    struct File {
+        u64 nameOffset; // Into the names of its folder, which may still move while the folder is listed
+        u64 size;
+        u64 writeTime;
+    };
+
+    struct Folder {
+        char path[MAX_PATH]; // Relative to the root, empty for the root itself
+
+        u32 fileCount;
+        u32 fileCapacity;
+        File* files;
+
+        u64 nameSize;
+        u64 nameCapacity;
+        char* names;
+
+        u32 childCount;
+        Folder* children;
+    };
+
+    struct Walk {
+        const char* root;
+        const char* extension;
+        thread::Pool* pool;
+
+        volatile i64 failedCount;
+    };
+
+    struct WalkJob {
+        Walk* walk;
+        Folder* folders;
+    };
+
+    // Blocks start out at the given capacity & double from there
+    static bool grow(void** block, u64 usedSize, u64 requiredSize, u64* capacity) {
+        if (*block && requiredSize <= *capacity) return true;
+
+        u64 newCapacity = *capacity;
+        while (newCapacity < requiredSize) newCapacity *= 2;
+
+        void* newBlock = memory::alloc(newCapacity);
+        if (!newBlock) return false;
+
+        if (*block) {
+            memory::copy(newBlock, *block, usedSize);
+            memory::free(*block);
+        }
+
+        *block = newBlock;
+        *capacity = newCapacity;
+        return true;
+    }
+
+    static bool push_name(Folder* folder, const char* name, u64* outOffset) {
+        u64 length = strlen(name) + 1;
+        if (folder->nameCapacity == 0) folder->nameCapacity = INITIAL_NAME_CAPACITY;
+        if (!grow((void**)&folder->names, folder->nameSize, folder->nameSize + length, &folder->nameCapacity)) return false;
+
+        memory::copy(folder->names + folder->nameSize, name, length);
+        *outOffset = folder->nameSize;
+        folder->nameSize += length;
+        return true;
+    }
+
+    static bool push_file(Folder* folder, const WIN32_FIND_DATAA* findData) {
+        u64 nameOffset = 0;
+        if (!push_name(folder, findData->cFileName, &nameOffset)) return false;
+
+        u64 capacity = (u64)folder->fileCapacity * sizeof(File);
+        if (capacity == 0) capacity = INITIAL_FILE_CAPACITY * sizeof(File);
+        if (!grow((void**)&folder->files, folder->fileCount * sizeof(File), (folder->fileCount + 1) * sizeof(File), &capacity)) return false;
+        folder->fileCapacity = (u32)(capacity / sizeof(File));
+
+        File* record = &folder->files[folder->fileCount++];
+        record->nameOffset = nameOffset;
+        record->size = ((u64)findData->nFileSizeHigh << 32) | findData->nFileSizeLow;
+        record->writeTime = ((u64)findData->ftLastWriteTime.dwHighDateTime << 32) | findData->ftLastWriteTime.dwLowDateTime;
+        return true;
+    }
+
+    static void walk_folder(Walk* walk, Folder* folder);
+
+    static void walk_child(void* data, u32 index) {
+        WalkJob* job = (WalkJob*)data;
+        walk_folder(job->walk, &job->folders[index]);
+    }
+
+    // Lists the files of a single folder, then every subfolder as its own job
+    static void walk_folder(Walk* walk, Folder* folder) {
+        char pattern[MAX_PATH] = "";
+        i32 patternLength = (folder->path[0] != '\0') ? snprintf(pattern, MAX_PATH, "%s/%s/*", walk->root, folder->path)
+                                                      : snprintf(pattern, MAX_PATH, "%s/*", walk->root);
+        if (patternLength < 0 || patternLength >= MAX_PATH) {
+            thread::atomic_increment(&walk->failedCount);
+            return;
+        }
+
+        // Subfolder names share the name block with the files until the listing is done
+        u32 childCount = 0;
+        u64 childCapacity = 0;
+        u64* childOffsets = NULL;
+
+        WIN32_FIND_DATAA findData = {};
+        HANDLE handle = FindFirstFileExA(pattern, FindExInfoBasic, &findData, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+        if (handle == INVALID_HANDLE_VALUE) {
+            thread::atomic_increment(&walk->failedCount);
+            return;
+        }
+
+        bool success = true;
+        do {
+            if (findData.cFileName[0] == '.') continue;
+            if (findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+
+            if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                u64 nameOffset = 0;
+                if (childCapacity == 0) childCapacity = 8 * sizeof(u64);
+
+                success = push_name(folder, findData.cFileName, &nameOffset) &&
+                          grow((void**)&childOffsets, childCount * sizeof(u64), (childCount + 1) * sizeof(u64), &childCapacity);
+                if (success) childOffsets[childCount++] = nameOffset;
+            } else if (file::has_extension(findData.cFileName, walk->extension)) {
+                success = push_file(folder, &findData);
+            }
+        } while (success && FindNextFileA(handle, &findData));
+
+        FindClose(handle);
+
+        if (success && childCount > 0) {
+            folder->children = (Folder*)memory::alloc(sizeof(Folder) * childCount);
+            success = folder->children != NULL;
+        }
+
+        if (success) {
+            folder->childCount = childCount;
+
+            for (u32 i = 0; i < childCount && success; i++) {
+                const char* name = folder->names + childOffsets[i];
+                i32 pathLength = (folder->path[0] != '\0') ? snprintf(folder->children[i].path, MAX_PATH, "%s/%s", folder->path, name)
+                                                           : snprintf(folder->children[i].path, MAX_PATH, "%s", name);
+                success = pathLength >= 0 && pathLength < MAX_PATH;
+            }
+        }
+
+        if (childOffsets) memory::free(childOffsets);
+
+        if (!success) {
+            thread::atomic_increment(&walk->failedCount);
+            return;
+        }
+
+        WalkJob job = { walk, folder->children };
+        if (folder->childCount > 0) thread::pool_dispatch(walk->pool, folder->childCount, walk_child, &job);
+    }
+
+    static u32 count_files(const Folder* folder) {
+        u32 count = folder->fileCount;
+        for (u32 i = 0; i < folder->childCount; i++) count += count_files(&folder->children[i]);
+
+        return count;
+    }
+
+    static bool collect_files(const Folder* folder, Listing* listing) {
+        for (u32 i = 0; i < folder->fileCount; i++) {
+            const File* record = &folder->files[i];
+            const char* name = folder->names + record->nameOffset;
+
+            char path[MAX_PATH] = "";
+            i32 pathLength = (folder->path[0] != '\0') ? snprintf(path, MAX_PATH, "%s/%s", folder->path, name)
+                                                       : snprintf(path, MAX_PATH, "%s", name);
+            if (pathLength < 0 || pathLength >= MAX_PATH) return false;
+
+            Entry* entry = &listing->entries[listing->count];
+            entry->path = arena::push_string(&listing->pathArena, path, (u64)pathLength);
+            if (!entry->path) return false;
+
+            entry->size = record->size;
+            entry->writeTime = record->writeTime;
+            listing->count++;
+        }
+
+        for (u32 i = 0; i < folder->childCount; i++) {
+            if (!collect_files(&folder->children[i], listing)) return false;
+        }
+
+        return true;
+    }
+
+    static void release_folder(Folder* folder) {
+        for (u32 i = 0; i < folder->childCount; i++) release_folder(&folder->children[i]);
+
+        if (folder->children) memory::free(folder->children);
+        if (folder->files) memory::free(folder->files);
+        if (folder->names) memory::free(folder->names);
+    }
+
+    static i32 entry_compare(const void* a, const void* b) {
+        return strcmp(((const Entry*)a)->path, ((const Entry*)b)->path);
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool directory(const char* root, const char* extension, thread::Pool* pool, Listing* outListing) {
+        *outListing = {};
+
+        Folder* rootFolder = (Folder*)memory::alloc(sizeof(Folder));
+        if (!rootFolder) return false;
+
+        Walk walk = { root, extension, pool, 0 };
+        walk_folder(&walk, rootFolder);
+
+        bool success = walk.failedCount == 0;
+        u32 fileCount = success ? count_files(rootFolder) : 0;
+
+        if (success && fileCount > 0) {
+            outListing->entries = (Entry*)memory::alloc(sizeof(Entry) * fileCount);
+            success = outListing->entries != NULL &&
+                      arena::init(&outListing->pathArena) &&
+                      collect_files(rootFolder, outListing);
+        }
+
+        release_folder(rootFolder);
+        memory::free(rootFolder);
+
+        if (!success) {
+            release(outListing);
+            return false;
+        }
+
+        qsort(outListing->entries, outListing->count, sizeof(Entry), entry_compare);
+        return true;
+    }
+
+    void release(Listing* listing) {
+        if (listing->entries) memory::free(listing->entries);
+        arena::release(&listing->pathArena);
+
+        *listing = {};
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "pch.hpp"
+
+#include "forge/arena.hpp"
+
+#include "GEM/core/thread.hpp"
+
+// -------------------------------------------
+// Directory Scanning
+// -------------------------------------------
+// Recursive FindFirstFileEx walk that collects the path, size & write time of every matching file in a single pass.
+// Subfolders are listed in parallel on the pool, the listing is sorted by path so its order never depends on scheduling.
+
+namespace scan {
+    struct Entry {
+        const char* path; // Relative to the root & '/' separated, e.g. "rebels/fighter.png"
+        u64 size;
+        u64 writeTime;    // FILETIME ticks
+    };
+
+    struct Listing {
+        u32 count;
+        Entry* entries;
+
+        arena::Arena pathArena;
+    };
+
+    // Hidden entries (starting with '.') & links are skipped, 'extension' includes the dot, e.g. ".png"
+    bool directory(const char* root, const char* extension, thread::Pool* pool, Listing* outListing);
+    void release(Listing* listing);
+}
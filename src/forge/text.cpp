@@ -0,0 +1,152 @@
+#include "pch.hpp"
+
+#include "forge/text.hpp"
+
+#include "GEM/core/filesystem.hpp"
+#include "GEM/core/memory.hpp"
+
+namespace text {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    // Makes room for 'length' more characters plus the terminator, text past the reserved range is dropped & marks the builder
+    static bool reserve_space(Builder* builder, u64 length) {
+        if (builder->hasOverflowed) return false;
+
+        u64 required = builder->length + length + 1;
+        if (required <= builder->committed) return true;
+
+        u64 committed = (required + COMMIT_SIZE - 1) / COMMIT_SIZE * COMMIT_SIZE;
+        if (committed > builder->reserved || !memory::commit(builder->data + builder->committed, committed - builder->committed)) {
+            builder->hasOverflowed = true;
+            return false;
+        }
+
+        builder->committed = committed;
+        return true;
+    }
+
+    static void appendv(Builder* builder, const char* format, va_list args) {
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        i32 length = vsnprintf(NULL, 0, format, argsCopy);
+        va_end(argsCopy);
+
+        if (length <= 0) return;
+
+        if (!reserve_space(builder, (u64)length)) return;
+        vsnprintf(builder->data + builder->length, (u64)length + 1, format, args);
+        builder->length += (u64)length;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool init(Builder* builder, u64 reserveSize) {
+        *builder = {};
+
+        builder->data = (char*)memory::reserve(reserveSize);
+        if (!builder->data) return false;
+
+        builder->reserved = reserveSize;
+        if (!reserve_space(builder, 0)) {
+            release(builder);
+            return false;
+        }
+
+        builder->data[0] = '\0';
+        return true;
+    }
+
+    void release(Builder* builder) {
+        if (builder->data) memory::free(builder->data);
+        *builder = {};
+    }
+
+    void clear(Builder* builder) {
+        builder->length = 0;
+        builder->hasOverflowed = false;
+        if (builder->data) builder->data[0] = '\0';
+    }
+
+    void append(Builder* builder, const char* str) {
+        append(builder, str, strlen(str));
+    }
+
+    void append(Builder* builder, const char* str, u64 length) {
+        if (!reserve_space(builder, length)) return;
+
+        memory::copy(builder->data + builder->length, str, length);
+        builder->length += length;
+        builder->data[builder->length] = '\0';
+    }
+
+    void appendf(Builder* builder, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        appendv(builder, format, args);
+        va_end(args);
+    }
+
+    bool append_file(Builder* builder, const char* path) {
+        if (!file::exists(path)) return false;
+
+        file::Mapping map = {};
+        if (!file::map(path, &map)) return false;
+
+        append(builder, (const char*)map.data, map.size);
+        file::unmap(&map);
+        return true;
+    }
+
+    void line(Builder* builder, const char* str) {
+        append(builder, str);
+        append(builder, "\n", 1);
+    }
+
+    void linef(Builder* builder, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        appendv(builder, format, args);
+        va_end(args);
+
+        append(builder, "\n", 1);
+    }
+
+    bool write_if_changed(const Builder* builder, const char* path, bool* outWritten) {
+        if (outWritten) *outWritten = false;
+        if (builder->hasOverflowed) return false;
+
+        // Leaving identical files alone keeps their timestamps, so nothing that depends on them rebuilds
+        if (file::exists(path)) {
+            file::Mapping map = {};
+            if (file::map(path, &map)) {
+                bool isSame = map.size == builder->length && memcmp(map.data, builder->data, builder->length) == 0;
+                file::unmap(&map);
+
+                if (isSame) return true;
+            }
+        }
+
+        char tempPath[MAX_PATH] = "";
+        if (strlen(path) + strlen(".new") >= MAX_PATH) return false;
+        strcpy(tempPath, path);
+        strcat(tempPath, ".new");
+
+        file::File f = file::open(tempPath, file::Mode::WRITE, true);
+        if (!f.handle) return false;
+
+        bool success = (builder->length == 0) || file::write(&f, builder->data, (i32)builder->length);
+        file::close(&f);
+
+        if (!success || !file::replace(tempPath, path)) {
+            file::remove(tempPath);
+            return false;
+        }
+
+        if (outWritten) *outWritten = true;
+        return true;
+    }
+}
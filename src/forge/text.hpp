@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pch.hpp"
+
+// -------------------------------------------
+// Text Building
+// -------------------------------------------
+// Contiguous, null terminated text inside a reserved address range. Pages are committed as the text grows,
+// so appending never moves what was written before and the whole text can be written out at once.
+
+namespace text {
+    const u64 DEFAULT_RESERVE_SIZE = 64 * 1024 * 1024;
+    const u64 COMMIT_SIZE = 64 * 1024;
+
+    struct Builder {
+        char* data;
+        u64 length;
+        u64 committed;
+        u64 reserved;
+        bool hasOverflowed; // Text that didn't fit was dropped, the builder can't be written out anymore
+    };
+
+    bool init(Builder* builder, u64 reserveSize = DEFAULT_RESERVE_SIZE);
+    void release(Builder* builder);
+    void clear(Builder* builder);
+
+    void append(Builder* builder, const char* str);
+    void append(Builder* builder, const char* str, u64 length);
+    void appendf(Builder* builder, const char* format, ...);
+    bool append_file(Builder* builder, const char* path);
+
+    // Appends a line break after the text
+    void line(Builder* builder, const char* str = "");
+    void linef(Builder* builder, const char* format, ...);
+
+    // Writes the text with a single write to a sibling file, then swaps it in. Files with identical contents are left untouched.
+    // Fails without touching the file if any text was dropped.
+    bool write_if_changed(const Builder* builder, const char* path, bool* outWritten = NULL);
+}
@@ -0,0 +1,210 @@
+#include "pch.hpp"
+
+#include "forge/text.hpp"
+#include "forge/trace.hpp"
+
+#include "GEM/core/memory.hpp"
+#include "GEM/core/thread.hpp"
+#include "GEM/core/timer.hpp"
+
+#include <psapi.h>
+
+namespace trace {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    static thread::Mutex gMutex = {};
+    static Event* gEvents = NULL;
+    static u32 gEventCount = 0;
+    static u32 gEventCapacity = 0;
+    static u64 gStartTicks = 0;
+
+    static u64 get_working_set() {
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+        return (u64)counters.WorkingSetSize;
+    }
+
+    // Must be called with the mutex held
+    static bool grow_events() {
+        u32 capacity = gEventCapacity > 0 ? gEventCapacity * 2 : INITIAL_EVENT_CAPACITY;
+
+        Event* events = (Event*)memory::alloc(sizeof(Event) * capacity);
+        if (!events) return false;
+
+        if (gEvents) {
+            memory::copy(events, gEvents, sizeof(Event) * gEventCount);
+            memory::free(gEvents);
+        }
+
+        gEvents = events;
+        gEventCapacity = capacity;
+        return true;
+    }
+
+    static i32 total_compare(const void* a, const void* b) {
+        const Total* totalA = (const Total*)a;
+        const Total* totalB = (const Total*)b;
+
+        if (totalA->ticks != totalB->ticks) return (totalA->ticks > totalB->ticks) ? -1 : 1;
+        return strcmp(totalA->name, totalB->name);
+    }
+
+    // Microseconds since the trace started, which is what the trace event format expects
+    static f64 to_trace_time(u64 ticks) {
+        return ticks > gStartTicks ? timer::ticks_to_ms(ticks - gStartTicks) * 1000.0 : 0.0;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    void init() {
+        thread::mutex_init(&gMutex);
+        gStartTicks = timer::get_ticks();
+    }
+
+    void release() {
+        if (gEvents) memory::free(gEvents);
+
+        gEvents = NULL;
+        gEventCount = 0;
+        gEventCapacity = 0;
+    }
+
+    void reset() {
+        thread::mutex_lock(&gMutex);
+        gEventCount = 0;
+        gStartTicks = timer::get_ticks();
+        thread::mutex_unlock(&gMutex);
+    }
+
+    Scope begin(const char* name, const char* detail) {
+        Scope scope = {};
+        scope.name = name;
+        scope.detail = detail;
+        scope.startTicks = timer::get_ticks();
+        return scope;
+    }
+
+    void end(Scope* scope) {
+        if (!scope->name) return;
+
+        u64 endTicks = timer::get_ticks();
+        u64 workingSet = get_working_set();
+
+        thread::mutex_lock(&gMutex);
+
+        if (gEventCount < gEventCapacity || grow_events()) {
+            Event* event = &gEvents[gEventCount++];
+            event->name = scope->name;
+            event->detail[0] = '\0';
+            if (scope->detail) {
+                strncpy(event->detail, scope->detail, MAX_DETAIL_LENGTH - 1);
+                event->detail[MAX_DETAIL_LENGTH - 1] = '\0';
+            }
+
+            event->startTicks = scope->startTicks;
+            event->endTicks = endTicks;
+            event->byteCount = scope->byteCount;
+            event->itemCount = scope->itemCount;
+            event->workingSet = workingSet;
+            event->threadId = (u32)GetCurrentThreadId();
+        }
+
+        thread::mutex_unlock(&gMutex);
+
+        scope->name = NULL;
+    }
+
+    f64 get_elapsed_ms() {
+        return timer::ticks_to_ms(timer::get_ticks() - gStartTicks);
+    }
+
+    u32 get_event_count() {
+        return gEventCount;
+    }
+
+    u64 get_peak_working_set() {
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+        return (u64)counters.PeakWorkingSetSize;
+    }
+
+    u32 get_totals(Total* outTotals, u32 maxTotalCount) {
+        u32 totalCount = 0;
+
+        thread::mutex_lock(&gMutex);
+
+        for (u32 i = 0; i < gEventCount; i++) {
+            const Event* event = &gEvents[i];
+
+            // Names are literals, but the same literal isn't guaranteed to share an address across translation units
+            Total* total = NULL;
+            for (u32 j = 0; j < totalCount; j++) {
+                if (strcmp(outTotals[j].name, event->name) == 0) {
+                    total = &outTotals[j];
+                    break;
+                }
+            }
+
+            if (!total) {
+                if (totalCount == maxTotalCount) continue;
+
+                total = &outTotals[totalCount++];
+                memory::zero(total, sizeof(Total));
+                total->name = event->name;
+            }
+
+            u64 ticks = event->endTicks - event->startTicks;
+            total->count++;
+            total->ticks += ticks;
+            total->byteCount += event->byteCount;
+            total->itemCount += event->itemCount;
+            if (ticks > total->maxTicks) total->maxTicks = ticks;
+            if (event->workingSet > total->peakWorkingSet) total->peakWorkingSet = event->workingSet;
+        }
+
+        thread::mutex_unlock(&gMutex);
+
+        qsort(outTotals, totalCount, sizeof(Total), total_compare);
+        return totalCount;
+    }
+
+    // Every scope becomes a complete event ("X") & the working set at its end a counter event ("C")
+    bool write(const char* path) {
+        text::Builder builder = {};
+        if (!text::init(&builder)) return false;
+
+        thread::mutex_lock(&gMutex);
+
+        text::line(&builder, "{");
+        text::line(&builder, "    \"displayTimeUnit\": \"ms\",");
+        text::line(&builder, "    \"traceEvents\": [");
+
+        for (u32 i = 0; i < gEventCount; i++) {
+            const Event* event = &gEvents[i];
+            f64 start = to_trace_time(event->startTicks);
+            f64 duration = to_trace_time(event->endTicks) - start;
+
+            text::linef(&builder, "        { \"name\": \"%s\", \"cat\": \"forge\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %u, "
+                        "\"args\": { \"detail\": \"%s\", \"bytes\": %llu, \"items\": %llu } },",
+                        event->name, start, duration, event->threadId, event->detail, (unsigned long long)event->byteCount, (unsigned long long)event->itemCount);
+
+            text::linef(&builder, "        { \"name\": \"working set\", \"cat\": \"forge\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"args\": { \"MB\": %.3f } }%s",
+                        to_trace_time(event->endTicks), event->workingSet / (1024.0 * 1024.0), (i + 1 == gEventCount) ? "" : ",");
+        }
+
+        text::line(&builder, "    ]");
+        text::line(&builder, "}");
+
+        thread::mutex_unlock(&gMutex);
+
+        bool success = text::write_if_changed(&builder, path);
+        text::release(&builder);
+        return success;
+    }
+}
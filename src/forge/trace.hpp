@@ -0,0 +1,61 @@
+#pragma once
+
+#include "pch.hpp"
+
+// -------------------------------------------
+// Stage Tracing
+// -------------------------------------------
+// Scopes are timed on the calling thread and recorded once they end, together with their byte & item counters
+// and the working set at that point. The recorded events can be summed up per name or written out in the
+// Chrome trace event format, which both chrome://tracing & Perfetto open.
+
+namespace trace {
+    const u32 MAX_DETAIL_LENGTH = 48;
+    const u32 INITIAL_EVENT_CAPACITY = 1024;
+
+    struct Scope {
+        const char* name;   // Must outlive the trace, e.g. a string literal such as "atlas.decode"
+        const char* detail; // Copied when the scope ends, e.g. the asset type
+        u64 startTicks;
+
+        u64 byteCount;
+        u64 itemCount;
+    };
+
+    struct Event {
+        const char* name;
+        char detail[MAX_DETAIL_LENGTH];
+        u64 startTicks;
+        u64 endTicks;
+        u64 byteCount;
+        u64 itemCount;
+        u64 workingSet;
+        u32 threadId;
+    };
+
+    // Every event of a single name summed up
+    struct Total {
+        const char* name;
+        u32 count;
+        u64 ticks;
+        u64 maxTicks;
+        u64 byteCount;
+        u64 itemCount;
+        u64 peakWorkingSet;
+    };
+
+    void init();
+    void release();
+    void reset(); // Drops every event & restarts the clock, e.g. between watch rebuilds
+
+    Scope begin(const char* name, const char* detail = NULL);
+    void  end(Scope* scope); // Ending a scope twice only records it once
+
+    f64 get_elapsed_ms();
+    u32 get_event_count();
+    u64 get_peak_working_set(); // Highest working set of the process so far, not only since the last reset
+
+    // Fills 'outTotals' sorted by their summed up time, longest first
+    u32  get_totals(Total* outTotals, u32 maxTotalCount);
+    bool write(const char* path);
+}
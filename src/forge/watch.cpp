@@ -0,0 +1,110 @@
+#include "pch.hpp"
+
+#include "forge/watch.hpp"
+
+#include "GEM/core/filesystem.hpp"
+
+namespace watch {
+    // -------------------------------------------
+    // Internal
+    // -------------------------------------------
+
+    static const DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+    static bool request_changes(Directory* directory) {
+        ResetEvent(directory->event);
+        memset(&directory->overlapped, 0, sizeof(OVERLAPPED));
+        directory->overlapped.hEvent = directory->event;
+
+        BOOL result = ReadDirectoryChangesW(directory->handle, directory->buffer, BUFFER_SIZE, TRUE, NOTIFY_FILTER, NULL, &directory->overlapped, NULL);
+        return result != FALSE;
+    }
+
+    // True if any of the reported files is one the directory cares about
+    static bool has_relevant_change(const Directory* directory, DWORD byteCount) {
+        // The buffer overflowed, the changes are unknown so assume the worst
+        if (byteCount == 0) return true;
+        if (!directory->ignoredExtension) return true;
+
+        const u8* cursor = directory->buffer;
+        while (true) {
+            const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)cursor;
+
+            char name[MAX_PATH] = "";
+            i32 nameLength = WideCharToMultiByte(CP_UTF8, 0, info->FileName, (i32)(info->FileNameLength / sizeof(WCHAR)), name, MAX_PATH - 1, NULL, NULL);
+            name[nameLength] = '\0';
+
+            if (!file::has_extension(name, directory->ignoredExtension)) return true;
+
+            if (info->NextEntryOffset == 0) break;
+            cursor += info->NextEntryOffset;
+        }
+
+        return false;
+    }
+
+    // -------------------------------------------
+    // Functions
+    // -------------------------------------------
+
+    bool add(Watcher* watcher, const char* path, u32 id, const char* ignoredExtension) {
+        if (watcher->directoryCount >= MAX_DIRECTORIES || id >= 32) return false;
+        Directory* directory = &watcher->directories[watcher->directoryCount];
+
+        directory->handle = CreateFileA(path, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                                        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+        if (directory->handle == INVALID_HANDLE_VALUE) return false;
+
+        directory->event = CreateEventA(NULL, TRUE, FALSE, NULL);
+        directory->id = id;
+        directory->ignoredExtension = ignoredExtension;
+
+        if (!directory->event || !request_changes(directory)) {
+            if (directory->event) CloseHandle(directory->event);
+            CloseHandle(directory->handle);
+            return false;
+        }
+
+        watcher->directoryCount++;
+        return true;
+    }
+
+    void destroy(Watcher* watcher) {
+        for (u32 i = 0; i < watcher->directoryCount; i++) {
+            Directory* directory = &watcher->directories[i];
+
+            CancelIoEx(directory->handle, &directory->overlapped);
+            CloseHandle(directory->handle);
+            CloseHandle(directory->event);
+        }
+
+        watcher->directoryCount = 0;
+    }
+
+    bool wait(Watcher* watcher, u32 timeoutMs, u32* outChangedMask) {
+        if (watcher->directoryCount == 0) return false;
+
+        HANDLE events[MAX_DIRECTORIES];
+        for (u32 i = 0; i < watcher->directoryCount; i++) {
+            events[i] = watcher->directories[i].event;
+        }
+
+        DWORD result = WaitForMultipleObjects(watcher->directoryCount, events, FALSE, (timeoutMs == WAIT_FOREVER) ? INFINITE : timeoutMs);
+        if (result == WAIT_TIMEOUT) return true;
+        if (result >= WAIT_OBJECT_0 + watcher->directoryCount) return false;
+
+        // More than one directory may have fired, collect all of them in one go
+        for (u32 i = 0; i < watcher->directoryCount; i++) {
+            Directory* directory = &watcher->directories[i];
+            if (WaitForSingleObject(directory->event, 0) != WAIT_OBJECT_0) continue;
+
+            DWORD byteCount = 0;
+            if (!GetOverlappedResult(directory->handle, &directory->overlapped, &byteCount, FALSE)) return false;
+
+            if (has_relevant_change(directory, byteCount)) *outChangedMask |= 1u << directory->id;
+            if (!request_changes(directory)) return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "pch.hpp"
+
+// -------------------------------------------
+// Directory Watching
+// -------------------------------------------
+// Overlapped ReadDirectoryChangesW on a fixed set of directory trees, every directory reports under its own id (0-31).
+
+namespace watch {
+    const u32 MAX_DIRECTORIES = 16;
+    const u32 BUFFER_SIZE = 16 * 1024;
+    const u32 WAIT_FOREVER = 0xFFFFFFFF;
+
+    struct Directory {
+        void* handle;
+        void* event;
+        OVERLAPPED overlapped;
+
+        u32 id;
+        const char* ignoredExtension; // Changes to these files are dropped, e.g. files written by the watcher's owner
+
+        alignas(DWORD) u8 buffer[BUFFER_SIZE];
+    };
+
+    struct Watcher {
+        Directory directories[MAX_DIRECTORIES];
+        u32 directoryCount;
+    };
+
+    bool add(Watcher* watcher, const char* path, u32 id, const char* ignoredExtension = NULL);
+    void destroy(Watcher* watcher);
+
+    // Waits up to 'timeoutMs' for changes, every directory with a change sets (1 << id) in 'outChangedMask'
+    // NOTE: Returns true on a timeout as well, with the mask left untouched.
+    bool wait(Watcher* watcher, u32 timeoutMs, u32* outChangedMask);
+}